@@ -0,0 +1,103 @@
+/**
+ * @file arena.cpp
+ * @brief Implementation of the bump-pointer arena.
+ * @details Blocks are chained through a small header at their start. Allocation only moves
+ *          'position' forward; the slow path that chains in a new block runs only while the arena
+ *          is still growing towards its steady-state size.
+ *
+ * @see arena.h for the class declaration.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "arena.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+Arena::Arena(size_t initial_size) : current(NULL), position(NULL), limit(NULL), used_before_current(0)
+{
+    current = new_block(initial_size);
+}
+
+Arena::~Arena()
+{
+    while (current)
+    {
+        Block *previous = current->previous;
+        free(current);
+        current = previous;
+    }
+}
+
+/**
+ * @brief Allocates a block, chains it in front of the current one and makes it current.
+ * @param size Usable size of the block in bytes.
+ * @return The new block.
+ */
+Arena::Block *Arena::new_block(size_t size)
+{
+    Block *block = (Block *)malloc(sizeof(Block) + size);
+    if (!block)
+    {
+        abort();
+    }
+    block->previous = current;
+    block->size = size;
+    if (current)
+    {
+        used_before_current += (size_t)(position - (char *)(current + 1));
+    }
+    current = block;
+    position = (char *)(block + 1);
+    limit = position + size;
+    return block;
+}
+
+void *Arena::allocate(size_t size, size_t alignment)
+{
+    uintptr_t aligned = ((uintptr_t)position + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    if (aligned + size > (uintptr_t)limit)
+    {
+        size_t grown = current->size * 2;
+        new_block(grown > size + alignment ? grown : size + alignment);
+        aligned = ((uintptr_t)position + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    }
+    position = (char *)(aligned + size);
+    return (void *)aligned;
+}
+
+void Arena::reset()
+{
+    if (current->previous)
+    {
+        // Several blocks were needed: replace them with one block that holds all of them.
+        size_t total = capacity();
+        while (current)
+        {
+            Block *previous = current->previous;
+            free(current);
+            current = previous;
+        }
+        used_before_current = 0;
+        new_block(total);
+    }
+    used_before_current = 0;
+    position = (char *)(current + 1);
+}
+
+size_t Arena::used() const
+{
+    return used_before_current + (size_t)(position - (char *)(current + 1));
+}
+
+size_t Arena::capacity() const
+{
+    size_t total = 0;
+    for (const Block *block = current; block; block = block->previous)
+    {
+        total += block->size;
+    }
+    return total;
+}
+
+/** End of arena.cpp */
\ No newline at end of file
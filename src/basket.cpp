@@ -0,0 +1,132 @@
+/**
+ * @file basket.cpp
+ * @brief Implementation of the basket receipt engine.
+ * @details The gross unit prices of all lines are computed in one call of the mixed-rate VAT kernel.
+ *          The receipt text is then formatted into a single arena allocation sized for the worst
+ *          case, so neither pricing nor formatting touches the general-purpose allocator.
+ *
+ * @see basket.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "basket.h"
+#include "buffered_io.h"
+#include "format.h"
+
+namespace
+{
+/** Upper bound of the header, the subtotal of one rate or the grand total. */
+const size_t MAX_SUMMARY_LENGTH = 96;
+
+/** Largest basket accepted by the batch reader. */
+const int MAX_BASKET_LINES = 1 << 20;
+} // namespace
+
+Basket basket_allocate(Arena &arena, size_t lines)
+{
+    Basket basket;
+    basket.lines = lines;
+    basket.counts = arena.allocate_array<int>(lines);
+    basket.prices = arena.allocate_array<int>(lines);
+    basket.rates = arena.allocate_array<unsigned char>(lines);
+    return basket;
+}
+
+void basket_price(const Basket &basket, Arena &arena, BasketReceipt &receipt)
+{
+    int *gross = arena.allocate_array<int>(basket.lines);
+    vat_gross_prices_mixed(basket.prices, basket.rates, gross, basket.lines);
+
+    size_t capacity = MAX_SUMMARY_LENGTH * (VAT_RATE_COUNT + 2) + FORMAT_ITEM_MAX_LENGTH * basket.lines;
+    char *text = arena.allocate_array<char>(capacity);
+    char *p = text;
+
+    for (int r = 0; r < VAT_RATE_COUNT; r++)
+    {
+        receipt.net[r] = 0;
+        receipt.gross[r] = 0;
+    }
+    bool present[VAT_RATE_COUNT] = {false};
+
+    p = format_literal(p, "Účtenka\n");
+    for (size_t i = 0; i < basket.lines; i++)
+    {
+        int rate = basket.rates[i];
+        long long net = (long long)basket.prices[i] * basket.counts[i];
+        long long line_gross = (long long)gross[i] * basket.counts[i];
+        receipt.net[rate] += net;
+        receipt.gross[rate] += line_gross;
+        present[rate] = true;
+
+        p = format_receipt_item(p, basket.counts[i], basket.prices[i], gross[i], net, line_gross,
+                                vat_rate_percent((VatRate)rate));
+    }
+
+    receipt.total_net = 0;
+    receipt.total_gross = 0;
+    for (int r = 0; r < VAT_RATE_COUNT; r++)
+    {
+        if (!present[r])
+        {
+            continue;
+        }
+        receipt.total_net += receipt.net[r];
+        receipt.total_gross += receipt.gross[r];
+        p = format_literal(p, "DPH ");
+        p = format_long(p, vat_rate_percent((VatRate)r));
+        p = format_literal(p, " %: Cena bez DPH ");
+        p = format_long(p, receipt.net[r]);
+        p = format_literal(p, " Kč\tCena s DPH ");
+        p = format_long(p, receipt.gross[r]);
+        p = format_literal(p, " Kč\n");
+    }
+    p = format_literal(p, "Celkem bez DPH ");
+    p = format_long(p, receipt.total_net);
+    p = format_literal(p, " Kč\tCelkem s DPH ");
+    p = format_long(p, receipt.total_gross);
+    p = format_literal(p, " Kč\n");
+
+    receipt.text = text;
+    receipt.length = (size_t)(p - text);
+}
+
+long u1_1_baskets(FILE *input, FILE *output)
+{
+    InputReader reader(input);
+    OutputBuffer out(output);
+    Arena arena;
+
+    long baskets = 0;
+    int lines = 0;
+    while (reader.next_int(lines))
+    {
+        if (lines < 0 || lines > MAX_BASKET_LINES)
+        {
+            return -1;
+        }
+
+        arena.reset();
+        Basket basket = basket_allocate(arena, (size_t)lines);
+        for (int i = 0; i < lines; i++)
+        {
+            int percent = 20;
+            VatRate rate = VAT_RATE_20;
+            if (!reader.next_int(basket.counts[i]) || !reader.next_int(basket.prices[i]) ||
+                (reader.next_int_on_line(percent) && !vat_rate_from_percent(percent, rate)))
+            {
+                return -1;
+            }
+            basket.rates[i] = (unsigned char)rate;
+        }
+
+        BasketReceipt receipt;
+        basket_price(basket, arena, receipt);
+        out.write(receipt.text, receipt.length);
+        baskets++;
+    }
+
+    return reader.at_end() ? baskets : -1;
+}
+
+/** End of basket.cpp */
\ No newline at end of file
@@ -0,0 +1,171 @@
+/**
+ * @file batch.cpp
+ * @brief Implementation of the batch drivers.
+ * @details Records are parsed with InputReader and the results are formatted straight into an
+ *          OutputBuffer, so a run over millions of records makes only a handful of `fread` and
+ *          `fwrite` calls instead of several stdio calls per record. The receipts and reports are
+ *          computed and formatted by the span functions of compute.h, block by block, so the VAT
+ *          and grade-class kernels work on whole vectors; the mixed-rate VAT kernel handles records
+ *          that carry their own rate class.
+ *
+ * @see batch.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "batch.h"
+#include "compute.h"
+#include "format.h"
+#include "functions.h"
+#include "vat.h"
+#include <vector>
+
+namespace
+{
+/** Number of records parsed and processed together, e.g. priced in one call of the VAT array kernel. */
+const size_t BLOCK_RECORDS = 4096;
+} // namespace
+
+long u1_1_batch(FILE *input, FILE *output)
+{
+    InputReader reader(input);
+    OutputBuffer out(output);
+    return u1_1_receipts(reader, out);
+}
+
+long u1_1_receipts(InputReader &reader, OutputBuffer &out)
+{
+    std::vector<ReceiptRecord> records(BLOCK_RECORDS);
+    std::vector<Receipt> receipts(BLOCK_RECORDS);
+
+    long processed = 0;
+    bool malformed = false;
+    for (;;)
+    {
+        size_t block = 0;
+        while (block < BLOCK_RECORDS && reader.next_int(records[block].count))
+        {
+            ReceiptRecord &record = records[block];
+            record.percent = 20;
+            VatRate rate;
+            if (!reader.next_int(record.price) ||
+                (reader.next_int_on_line(record.percent) && !vat_rate_from_percent(record.percent, rate)))
+            {
+                malformed = true;
+                break;
+            }
+            block++;
+        }
+        if (block == 0)
+        {
+            break;
+        }
+
+        compute_receipt(&records[0], block, &receipts[0]);
+        write_receipts(&records[0], &receipts[0], block, out);
+        processed += (long)block;
+
+        if (malformed || block < BLOCK_RECORDS)
+        {
+            break;
+        }
+    }
+
+    return !malformed && reader.at_end() ? processed : -1;
+}
+
+long u1_2_batch(FILE *input, FILE *output)
+{
+    InputReader reader(input);
+    OutputBuffer out(output);
+    return u1_2_reports(reader, out);
+}
+
+long u1_2_reports(InputReader &reader, OutputBuffer &out)
+{
+    std::vector<GradeRecord> records(BLOCK_RECORDS);
+    std::vector<GradeReport> reports(BLOCK_RECORDS);
+
+    long processed = 0;
+    bool malformed = false;
+    for (;;)
+    {
+        size_t block = 0;
+        while (block < BLOCK_RECORDS && reader.next_int(records[block].grades[0]))
+        {
+            int *grades = records[block].grades;
+            for (int i = 1; i < COMPUTE_GRADES && !malformed; i++)
+            {
+                malformed = !reader.next_int(grades[i]);
+            }
+            if (malformed)
+            {
+                break;
+            }
+            block++;
+        }
+
+        compute_grade_report(&records[0], block, &reports[0]);
+        write_grade_reports(&records[0], &reports[0], block, out);
+        processed += (long)block;
+
+        if (malformed || block < BLOCK_RECORDS)
+        {
+            break;
+        }
+    }
+
+    return !malformed && reader.at_end() ? processed : -1;
+}
+
+long u1_3_batch(FILE *input, FILE *output)
+{
+    InputReader reader(input);
+    OutputBuffer out(output);
+    return u1_3_conversions(reader, out);
+}
+
+long u1_3_conversions(InputReader &reader, OutputBuffer &out)
+{
+    CurrencyInterner interner;
+    std::vector<ConversionRecord> block(BLOCK_RECORDS);
+
+    long records = 0;
+    bool wellformed = true;
+    for (;;)
+    {
+        size_t filled = 0;
+        const char *currency = NULL;
+        size_t length = 0;
+        while (filled < BLOCK_RECORDS && reader.next_word(currency, length))
+        {
+            // The word must be packed before the next token is read; a refill may move it.
+            ConversionRecord &record = block[filled];
+            if (!interner.intern(currency, length, record.currency) || !reader.next_double(record.rate) ||
+                !reader.next_int(record.count))
+            {
+                wellformed = false;
+                break;
+            }
+            filled++;
+        }
+
+        for (size_t i = 0; i < filled; i++)
+        {
+            const ConversionRecord &record = block[i];
+            const char *name = interner.text(record.currency, length);
+            char *p = out.reserve(format_conversion_max_length(length));
+            out.commit(format_u1_3_conversion(p, name, length, record.rate, record.count,
+                                              round_half_up(record.rate * record.count)));
+        }
+        records += (long)filled;
+        if (!wellformed || filled < BLOCK_RECORDS)
+        {
+            break;
+        }
+    }
+
+    return wellformed ? records : -1;
+}
+
+/** End of batch.cpp */
\ No newline at end of file
@@ -0,0 +1,588 @@
+/**
+ * @file benchmarks.cpp
+ * @brief Google Benchmark suite for the computation, parsing and formatting kernels of all three tasks.
+ * @details The benchmarks come in four groups. Every group runs over batches of 1K to 256K records,
+ *          and every benchmark reports items per second:
+ *
+ *          - compute: VAT pricing, grade averaging and classification, and currency conversion on
+ *            record arrays, each dispatched and with its scalar reference where one exists;
+ *          - parse: reading records out of batch input text with InputReader;
+ *          - format: appending the interactive output text of priced records to an OutputBuffer;
+ *          - end to end: the batch kernels from input text to output text, which also report bytes
+ *            per second.
+ *
+ *          `make bench` builds the suite with optimisation and writes the results as JSON to
+ *          build/bench.json, so runs of two releases on the same machine can be compared with
+ *          Google Benchmark's compare.py. Extra arguments such as `--benchmark_filter=Vat` go
+ *          into BENCH_ARGS.
+ *
+ *          Like tests.cpp, this file is not part of the submitted solution.
+ *
+ * @see Makefile for the bench target.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "batch.h"
+#include "buffered_io.h"
+#include "compute.h"
+#include "fixed_decimal.h"
+#include "format.h"
+#include "grade_class.h"
+#include "vat.h"
+#include <benchmark/benchmark.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+/** Smallest batch size. */
+const int BATCH_MIN = 1 << 10;
+
+/** Largest batch size. */
+const int BATCH_MAX = 1 << 18;
+
+/** VAT rates in percent, in the order of VatRate. */
+const int PERCENTS[] = {20, 21, 12, 0};
+
+/**
+ * @brief Deterministic pseudo-random numbers, the same on every run and machine.
+ */
+class Lcg
+{
+  public:
+    explicit Lcg(unsigned seed) : state(seed)
+    {
+    }
+
+    unsigned next(unsigned bound)
+    {
+        state = state * 1103515245u + 12345u;
+        return (state >> 8) % bound;
+    }
+
+  private:
+    unsigned state;
+};
+
+std::vector<ReceiptRecord> receipt_records(size_t count)
+{
+    Lcg random(11);
+    std::vector<ReceiptRecord> records(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        records[i].count = (int)random.next(100) + 1;
+        records[i].price = (int)random.next(100000);
+        records[i].percent = PERCENTS[random.next(4)];
+    }
+    return records;
+}
+
+std::vector<GradeRecord> grade_records(size_t count)
+{
+    Lcg random(13);
+    std::vector<GradeRecord> records(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        for (int g = 0; g < COMPUTE_GRADES; g++)
+        {
+            records[i].grades[g] = (int)random.next(5) + 1;
+        }
+    }
+    return records;
+}
+
+std::vector<ExchangeRecord> exchange_records(size_t count)
+{
+    static const char *const NAMES[] = {"EUR", "USD", "GBP", "JPY"};
+    Lcg random(17);
+    std::vector<ExchangeRecord> records(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        records[i].currency = NAMES[random.next(4)];
+        records[i].length = 3;
+        records[i].rate = (double)(random.next(30000) + 1) / 1000;
+        records[i].count = (int)random.next(10000);
+    }
+    return records;
+}
+
+/**
+ * @brief Batch input text of the receipt mode; every fourth record carries its VAT rate.
+ */
+std::string receipt_text_input(size_t count)
+{
+    std::vector<ReceiptRecord> records = receipt_records(count);
+    std::string text;
+    for (size_t i = 0; i < count; i++)
+    {
+        text += std::to_string(records[i].count) + " " + std::to_string(records[i].price);
+        text += i % 4 ? "\n" : " " + std::to_string(records[i].percent) + "\n";
+    }
+    return text;
+}
+
+/**
+ * @brief Batch input text of the grade mode, one student per line.
+ */
+std::string grade_text_input(size_t count)
+{
+    std::vector<GradeRecord> records = grade_records(count);
+    std::string text;
+    for (size_t i = 0; i < count; i++)
+    {
+        for (int g = 0; g < COMPUTE_GRADES; g++)
+        {
+            text += std::to_string(records[i].grades[g]) + (g + 1 < COMPUTE_GRADES ? " " : "\n");
+        }
+    }
+    return text;
+}
+
+/**
+ * @brief Batch input text of the exchange mode with rates of up to three decimal places.
+ */
+std::string exchange_text_input(size_t count)
+{
+    std::vector<ExchangeRecord> records = exchange_records(count);
+    std::string text;
+    char rate[32];
+    for (size_t i = 0; i < count; i++)
+    {
+        snprintf(rate, sizeof(rate), "%.3f", records[i].rate);
+        text += std::string(records[i].currency, records[i].length) + " " + rate + " " +
+                std::to_string(records[i].count) + "\n";
+    }
+    return text;
+}
+
+void set_batch_size(benchmark::State &state, size_t bytes = 0)
+{
+    state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+    if (bytes > 0)
+    {
+        state.SetBytesProcessed((int64_t)state.iterations() * (int64_t)bytes);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Compute
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BM_VatGrossPrices(benchmark::State &state)
+{
+    std::vector<ReceiptRecord> records = receipt_records((size_t)state.range(0));
+    std::vector<int> prices(records.size());
+    std::vector<int> gross(records.size());
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        prices[i] = records[i].price;
+    }
+    for (auto _ : state)
+    {
+        vat_gross_prices(prices.data(), gross.data(), prices.size());
+        benchmark::DoNotOptimize(gross.data());
+        benchmark::ClobberMemory();
+    }
+    set_batch_size(state);
+}
+
+void BM_VatGrossPricesScalar(benchmark::State &state)
+{
+    std::vector<ReceiptRecord> records = receipt_records((size_t)state.range(0));
+    std::vector<int> prices(records.size());
+    std::vector<int> gross(records.size());
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        prices[i] = records[i].price;
+    }
+    for (auto _ : state)
+    {
+        vat_gross_prices_scalar(prices.data(), gross.data(), prices.size());
+        benchmark::DoNotOptimize(gross.data());
+        benchmark::ClobberMemory();
+    }
+    set_batch_size(state);
+}
+
+void BM_VatGrossPricesMixed(benchmark::State &state)
+{
+    std::vector<ReceiptRecord> records = receipt_records((size_t)state.range(0));
+    std::vector<int> prices(records.size());
+    std::vector<unsigned char> rates(records.size());
+    std::vector<int> gross(records.size());
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        VatRate rate = VAT_RATE_20;
+        vat_rate_from_percent(records[i].percent, rate);
+        prices[i] = records[i].price;
+        rates[i] = (unsigned char)rate;
+    }
+    for (auto _ : state)
+    {
+        vat_gross_prices_mixed(prices.data(), rates.data(), gross.data(), prices.size());
+        benchmark::DoNotOptimize(gross.data());
+        benchmark::ClobberMemory();
+    }
+    set_batch_size(state);
+}
+
+void BM_ComputeReceipts(benchmark::State &state)
+{
+    std::vector<ReceiptRecord> records = receipt_records((size_t)state.range(0));
+    std::vector<Receipt> receipts(records.size());
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(compute_receipt(records.data(), records.size(), receipts.data()));
+        benchmark::ClobberMemory();
+    }
+    set_batch_size(state);
+}
+
+void BM_ClassifyGradeSums(benchmark::State &state)
+{
+    std::vector<GradeRecord> records = grade_records((size_t)state.range(0));
+    std::vector<int> sums(records.size());
+    std::vector<int> counts(records.size(), COMPUTE_GRADES);
+    std::vector<unsigned char> classes(records.size());
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        for (int g = 0; g < COMPUTE_GRADES; g++)
+        {
+            sums[i] += records[i].grades[g];
+        }
+    }
+    for (auto _ : state)
+    {
+        classify_grade_sums(sums.data(), counts.data(), classes.data(), sums.size());
+        benchmark::DoNotOptimize(classes.data());
+        benchmark::ClobberMemory();
+    }
+    set_batch_size(state);
+}
+
+void BM_ClassifyGradeSumsScalar(benchmark::State &state)
+{
+    std::vector<GradeRecord> records = grade_records((size_t)state.range(0));
+    std::vector<int> sums(records.size());
+    std::vector<int> counts(records.size(), COMPUTE_GRADES);
+    std::vector<unsigned char> classes(records.size());
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        for (int g = 0; g < COMPUTE_GRADES; g++)
+        {
+            sums[i] += records[i].grades[g];
+        }
+    }
+    for (auto _ : state)
+    {
+        classify_grade_sums_scalar(sums.data(), counts.data(), classes.data(), sums.size());
+        benchmark::DoNotOptimize(classes.data());
+        benchmark::ClobberMemory();
+    }
+    set_batch_size(state);
+}
+
+void BM_ComputeGradeReports(benchmark::State &state)
+{
+    std::vector<GradeRecord> records = grade_records((size_t)state.range(0));
+    std::vector<GradeReport> reports(records.size());
+    for (auto _ : state)
+    {
+        compute_grade_report(records.data(), records.size(), reports.data());
+        benchmark::DoNotOptimize(reports.data());
+        benchmark::ClobberMemory();
+    }
+    set_batch_size(state);
+}
+
+void BM_ComputeExchanges(benchmark::State &state)
+{
+    std::vector<ExchangeRecord> records = exchange_records((size_t)state.range(0));
+    std::vector<int> rounded(records.size());
+    for (auto _ : state)
+    {
+        compute_exchange(records.data(), records.size(), rounded.data());
+        benchmark::DoNotOptimize(rounded.data());
+        benchmark::ClobberMemory();
+    }
+    set_batch_size(state);
+}
+
+/**
+ * @brief Splits the rates of the exchange records into the arrays of fixed_convert().
+ */
+void fixed_inputs(size_t count, std::vector<int32_t> &units, std::vector<int32_t> &micros,
+                  std::vector<int32_t> &counts)
+{
+    std::vector<ExchangeRecord> records = exchange_records(count);
+    units.resize(count);
+    micros.resize(count);
+    counts.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        int64_t rate = (int64_t)(records[i].rate * FIXED_SCALE + 0.5);
+        units[i] = (int32_t)(rate / FIXED_SCALE);
+        micros[i] = (int32_t)(rate % FIXED_SCALE);
+        counts[i] = records[i].count;
+    }
+}
+
+void BM_FixedConvert(benchmark::State &state)
+{
+    std::vector<int32_t> units, micros, counts;
+    fixed_inputs((size_t)state.range(0), units, micros, counts);
+    std::vector<int64_t> rounded(units.size()), tenths(units.size());
+    for (auto _ : state)
+    {
+        fixed_convert(units.data(), micros.data(), counts.data(), rounded.data(), tenths.data(), units.size());
+        benchmark::DoNotOptimize(rounded.data());
+        benchmark::DoNotOptimize(tenths.data());
+        benchmark::ClobberMemory();
+    }
+    set_batch_size(state);
+}
+
+void BM_FixedConvertScalar(benchmark::State &state)
+{
+    std::vector<int32_t> units, micros, counts;
+    fixed_inputs((size_t)state.range(0), units, micros, counts);
+    std::vector<int64_t> rounded(units.size()), tenths(units.size());
+    for (auto _ : state)
+    {
+        fixed_convert_scalar(units.data(), micros.data(), counts.data(), rounded.data(), tenths.data(),
+                             units.size());
+        benchmark::DoNotOptimize(rounded.data());
+        benchmark::DoNotOptimize(tenths.data());
+        benchmark::ClobberMemory();
+    }
+    set_batch_size(state);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Parse
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BM_ParseReceipts(benchmark::State &state)
+{
+    std::string text = receipt_text_input((size_t)state.range(0));
+    for (auto _ : state)
+    {
+        InputReader reader(text.data(), text.size());
+        ReceiptRecord record;
+        long long sum = 0;
+        while (reader.next_int(record.count) && reader.next_int(record.price))
+        {
+            record.percent = 20;
+            reader.next_int_on_line(record.percent);
+            sum += record.count + record.price + record.percent;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    set_batch_size(state, text.size());
+}
+
+void BM_ParseGrades(benchmark::State &state)
+{
+    std::string text = grade_text_input((size_t)state.range(0));
+    for (auto _ : state)
+    {
+        InputReader reader(text.data(), text.size());
+        int grade = 0;
+        long long sum = 0;
+        while (reader.next_int(grade))
+        {
+            sum += grade;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    set_batch_size(state, text.size());
+}
+
+void BM_ParseExchanges(benchmark::State &state)
+{
+    std::string text = exchange_text_input((size_t)state.range(0));
+    for (auto _ : state)
+    {
+        InputReader reader(text.data(), text.size());
+        ExchangeRecord record;
+        double sum = 0;
+        while (reader.next_word(record.currency, record.length) && reader.next_double(record.rate) &&
+               reader.next_int(record.count))
+        {
+            sum += record.rate * record.count;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    set_batch_size(state, text.size());
+}
+
+void BM_ParseFixedRates(benchmark::State &state)
+{
+    std::string text = exchange_text_input((size_t)state.range(0));
+    std::vector<std::string> rates;
+    InputReader reader(text.data(), text.size());
+    const char *word = NULL;
+    size_t length = 0;
+    int count = 0;
+    while (reader.next_word(word, length) && reader.next_word(word, length))
+    {
+        rates.push_back(std::string(word, length));
+        reader.next_int(count);
+    }
+    for (auto _ : state)
+    {
+        FixedRate rate;
+        int64_t sum = 0;
+        for (const std::string &token : rates)
+        {
+            fixed_rate_parse(token.data(), token.size(), rate);
+            sum += rate.units + rate.micros;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    set_batch_size(state);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Format
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BM_FormatReceipts(benchmark::State &state)
+{
+    std::vector<ReceiptRecord> records = receipt_records((size_t)state.range(0));
+    std::vector<Receipt> receipts(records.size());
+    compute_receipt(records.data(), records.size(), receipts.data());
+    OutputBuffer out;
+    for (auto _ : state)
+    {
+        out.clear();
+        write_receipts(records.data(), receipts.data(), records.size(), out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_batch_size(state, out.size());
+}
+
+void BM_FormatGradeReports(benchmark::State &state)
+{
+    std::vector<GradeRecord> records = grade_records((size_t)state.range(0));
+    std::vector<GradeReport> reports(records.size());
+    compute_grade_report(records.data(), records.size(), reports.data());
+    OutputBuffer out;
+    for (auto _ : state)
+    {
+        out.clear();
+        write_grade_reports(records.data(), reports.data(), records.size(), out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_batch_size(state, out.size());
+}
+
+void BM_FormatExchanges(benchmark::State &state)
+{
+    std::vector<ExchangeRecord> records = exchange_records((size_t)state.range(0));
+    std::vector<int> rounded(records.size());
+    compute_exchange(records.data(), records.size(), rounded.data());
+    OutputBuffer out;
+    for (auto _ : state)
+    {
+        out.clear();
+        write_exchanges(records.data(), rounded.data(), records.size(), out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_batch_size(state, out.size());
+}
+
+void BM_FormatLong(benchmark::State &state)
+{
+    std::vector<ReceiptRecord> records = receipt_records((size_t)state.range(0));
+    std::vector<char> text(records.size() * 24);
+    for (auto _ : state)
+    {
+        char *p = text.data();
+        for (const ReceiptRecord &record : records)
+        {
+            p = format_long(p, (long long)record.price * record.count);
+        }
+        benchmark::DoNotOptimize(p);
+    }
+    set_batch_size(state);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// End to end
+// ---------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Runs a batch kernel from input text to output text.
+ */
+void run_kernel(benchmark::State &state, BatchKernel kernel, const std::string &text)
+{
+    OutputBuffer out;
+    for (auto _ : state)
+    {
+        out.clear();
+        InputReader reader(text.data(), text.size());
+        if (kernel(reader, out) != state.range(0))
+        {
+            state.SkipWithError("the kernel rejected the generated input");
+            break;
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_batch_size(state, text.size());
+}
+
+void BM_ReceiptsKernel(benchmark::State &state)
+{
+    run_kernel(state, u1_1_receipts, receipt_text_input((size_t)state.range(0)));
+}
+
+void BM_GradeReportsKernel(benchmark::State &state)
+{
+    run_kernel(state, u1_2_reports, grade_text_input((size_t)state.range(0)));
+}
+
+void BM_ConversionsKernel(benchmark::State &state)
+{
+    run_kernel(state, u1_3_conversions, exchange_text_input((size_t)state.range(0)));
+}
+
+void BM_FixedConversionsKernel(benchmark::State &state)
+{
+    run_kernel(state, u1_3_fixed_conversions, exchange_text_input((size_t)state.range(0)));
+}
+} // namespace
+
+#define ZSP_BATCH_BENCHMARK(function) BENCHMARK(function)->RangeMultiplier(8)->Range(BATCH_MIN, BATCH_MAX)
+
+ZSP_BATCH_BENCHMARK(BM_VatGrossPrices);
+ZSP_BATCH_BENCHMARK(BM_VatGrossPricesScalar);
+ZSP_BATCH_BENCHMARK(BM_VatGrossPricesMixed);
+ZSP_BATCH_BENCHMARK(BM_ComputeReceipts);
+ZSP_BATCH_BENCHMARK(BM_ClassifyGradeSums);
+ZSP_BATCH_BENCHMARK(BM_ClassifyGradeSumsScalar);
+ZSP_BATCH_BENCHMARK(BM_ComputeGradeReports);
+ZSP_BATCH_BENCHMARK(BM_ComputeExchanges);
+ZSP_BATCH_BENCHMARK(BM_FixedConvert);
+ZSP_BATCH_BENCHMARK(BM_FixedConvertScalar);
+
+ZSP_BATCH_BENCHMARK(BM_ParseReceipts);
+ZSP_BATCH_BENCHMARK(BM_ParseGrades);
+ZSP_BATCH_BENCHMARK(BM_ParseExchanges);
+ZSP_BATCH_BENCHMARK(BM_ParseFixedRates);
+
+ZSP_BATCH_BENCHMARK(BM_FormatReceipts);
+ZSP_BATCH_BENCHMARK(BM_FormatGradeReports);
+ZSP_BATCH_BENCHMARK(BM_FormatExchanges);
+ZSP_BATCH_BENCHMARK(BM_FormatLong);
+
+ZSP_BATCH_BENCHMARK(BM_ReceiptsKernel);
+ZSP_BATCH_BENCHMARK(BM_GradeReportsKernel);
+ZSP_BATCH_BENCHMARK(BM_ConversionsKernel);
+ZSP_BATCH_BENCHMARK(BM_FixedConversionsKernel);
+
+BENCHMARK_MAIN();
+
+/** End of benchmarks.cpp */
\ No newline at end of file
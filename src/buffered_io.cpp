@@ -0,0 +1,494 @@
+/**
+ * @file buffered_io.cpp
+ * @brief Implementation of the block-oriented input and output buffers.
+ * @details See buffered_io.h for an overview. Both classes set up their memory (a mapping or a
+ *          single heap buffer) in the constructor, so the per-record path performs no allocations.
+ *
+ * @see buffered_io.h for the class declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "buffered_io.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace
+{
+/** Exact powers of ten; every one of them is representable in a double. */
+const double POWERS_OF_TEN[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+inline bool is_digit(char c)
+{
+    return (unsigned)(c - '0') < 10;
+}
+
+inline bool is_space(char c)
+{
+    return c == ' ' || (unsigned)(c - '\t') <= '\r' - '\t';
+}
+} // namespace
+
+InputReader::InputReader(FILE *input, size_t capacity)
+    : input(input), data(NULL), buffer(NULL), capacity(capacity), mapped_size(0), begin(0), end(0), eof(false)
+{
+    struct stat info;
+    off_t offset = ftello(input);
+    if (offset >= 0 && fstat(fileno(input), &info) == 0 && S_ISREG(info.st_mode))
+    {
+        eof = true;
+        if (info.st_size > offset)
+        {
+            void *map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fileno(input), 0);
+            if (map != MAP_FAILED)
+            {
+                madvise(map, (size_t)info.st_size, MADV_SEQUENTIAL);
+                mapped_size = (size_t)info.st_size;
+                data = (const char *)map;
+                begin = (size_t)offset;
+                end = mapped_size;
+                return;
+            }
+            eof = false;
+        }
+        else
+        {
+            return;
+        }
+    }
+
+    buffer = (char *)malloc(capacity);
+    data = buffer;
+}
+
+InputReader::InputReader(const char *data, size_t size)
+    : input(NULL), data(data), buffer(NULL), capacity(size), mapped_size(0), begin(0), end(size), eof(true)
+{
+}
+
+InputReader::~InputReader()
+{
+    if (mapped_size > 0)
+    {
+        munmap((void *)data, mapped_size);
+    }
+    free(buffer);
+}
+
+bool InputReader::is_mapped() const
+{
+    return buffer == NULL;
+}
+
+/**
+ * @brief Moves the unread tail to the front of the buffer and appends the next block.
+ * @return true if at least one new byte was read.
+ */
+bool InputReader::refill()
+{
+    if (eof)
+    {
+        return false;
+    }
+
+    size_t remaining = end - begin;
+    memmove(buffer, buffer + begin, remaining);
+    begin = 0;
+    end = remaining;
+    if (end == capacity)
+    {
+        return false; // A token longer than the whole buffer; the parsers treat it as malformed.
+    }
+
+    size_t read = fread(buffer + end, 1, capacity - end, input);
+    end += read;
+    if (read == 0)
+    {
+        eof = true;
+    }
+    return read != 0;
+}
+
+/**
+ * @brief Makes sure that at least 'size' unread bytes are buffered, unless the input ends first.
+ * @param size Number of bytes the next token may span.
+ */
+void InputReader::ensure(size_t size)
+{
+    if (size > capacity)
+    {
+        size = capacity;
+    }
+    while (end - begin < size && refill())
+    {
+    }
+}
+
+/**
+ * @brief Skips whitespace, refilling the buffer as needed.
+ * @return true if a non-whitespace byte is available at 'begin'.
+ */
+bool InputReader::skip_whitespace()
+{
+    for (;;)
+    {
+        while (begin < end && is_space(data[begin]))
+        {
+            begin++;
+        }
+        if (begin < end)
+        {
+            return true;
+        }
+        if (!refill())
+        {
+            return false;
+        }
+    }
+}
+
+bool InputReader::next_int(int &value)
+{
+    return skip_whitespace() && parse_int(value);
+}
+
+bool InputReader::next_int_on_line(int &value)
+{
+    return skip_blanks() && data[begin] != '\n' && parse_int(value);
+}
+
+bool InputReader::at_line_end()
+{
+    return !skip_blanks() || data[begin] == '\n';
+}
+
+/**
+ * @brief Skips spaces, tabs and carriage returns, but not line breaks.
+ * @return false if the input ended before any other byte.
+ */
+bool InputReader::skip_blanks()
+{
+    for (;;)
+    {
+        while (begin < end && (data[begin] == ' ' || data[begin] == '\t' || data[begin] == '\r'))
+        {
+            begin++;
+        }
+        if (begin < end)
+        {
+            return true;
+        }
+        if (!refill())
+        {
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief Parses an integer starting at 'begin', which must point at a non-whitespace byte.
+ * @param value Receives the parsed value.
+ * @return true if an integer was parsed.
+ */
+bool InputReader::parse_int(int &value)
+{
+    // A number is at most a sign and ten digits, so make sure the whole token is in the buffer.
+    ensure(16);
+
+    const char *p = data + begin;
+    const char *limit = data + end;
+    unsigned negative = (unsigned)(*p == '-');
+    p += negative | (unsigned)(*p == '+');
+
+    const char *digits = p;
+    unsigned result = 0;
+    while (p < limit && is_digit(*p))
+    {
+        result = result * 10 + (unsigned)(*p - '0');
+        p++;
+    }
+    if (p == digits)
+    {
+        return false;
+    }
+
+    begin = (size_t)(p - data);
+    value = (int)((result ^ (0u - negative)) + negative); // Branch-free negation
+    return true;
+}
+
+bool InputReader::next_long(long long &value)
+{
+    if (!skip_whitespace())
+    {
+        return false;
+    }
+    // A sign and nineteen digits.
+    ensure(24);
+
+    const char *p = data + begin;
+    const char *limit = data + end;
+    bool negative = *p == '-';
+    p += negative || *p == '+';
+
+    const char *digits = p;
+    unsigned long long result = 0;
+    while (p < limit && is_digit(*p))
+    {
+        result = result * 10 + (unsigned long long)(*p - '0');
+        p++;
+    }
+    if (p == digits)
+    {
+        return false;
+    }
+
+    begin = (size_t)(p - data);
+    value = negative ? (long long)(0 - result) : (long long)result;
+    return true;
+}
+
+bool InputReader::next_double(double &value)
+{
+    const size_t MAX_NUMBER_LENGTH = 64;
+
+    if (!skip_whitespace())
+    {
+        return false;
+    }
+    ensure(MAX_NUMBER_LENGTH);
+
+    const char *start = data + begin;
+    const char *limit = data + end;
+    const char *p = start;
+    bool negative = *p == '-';
+    p += negative || *p == '+';
+
+    unsigned long long mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    while (p < limit && is_digit(*p))
+    {
+        mantissa = mantissa * 10 + (unsigned)(*p - '0');
+        // Count significant digits from the digits themselves; the mantissa may already have wrapped.
+        digits += digits > 0 || *p != '0';
+        p++;
+    }
+    bool any_digit = p != start + (start[0] == '-' || start[0] == '+');
+    if (p < limit && *p == '.')
+    {
+        p++;
+        const char *fraction = p;
+        while (p < limit && is_digit(*p))
+        {
+            mantissa = mantissa * 10 + (unsigned)(*p - '0');
+            digits += digits > 0 || *p != '0';
+            exponent--;
+            p++;
+        }
+        any_digit = any_digit || p != fraction;
+    }
+
+    bool plain = any_digit && (p == limit || is_space(*p)) && digits <= 19;
+    if (plain && mantissa < (1ULL << 53) && exponent >= -22)
+    {
+        // Both operands are exact, so the single division is correctly rounded, just like strtod.
+        double magnitude = (double)mantissa / POWERS_OF_TEN[-exponent];
+        value = negative ? -magnitude : magnitude;
+        begin = (size_t)(p - data);
+        return true;
+    }
+
+    // Exponents, long mantissas, "inf", hexadecimal numbers and the like go through strtod.
+    char token[MAX_NUMBER_LENGTH + 1];
+    size_t length = 0;
+    while (start + length < limit && length < MAX_NUMBER_LENGTH && !is_space(start[length]))
+    {
+        token[length] = start[length];
+        length++;
+    }
+    token[length] = '\0';
+    char *parsed_end = NULL;
+    value = strtod(token, &parsed_end);
+    if (parsed_end == token)
+    {
+        return false;
+    }
+    begin += (size_t)(parsed_end - token);
+    return true;
+}
+
+bool InputReader::next_word(const char *&word, size_t &length)
+{
+    if (!skip_whitespace())
+    {
+        return false;
+    }
+    ensure(MAX_WORD_LENGTH);
+
+    size_t pos = begin;
+    size_t limit = end - begin < MAX_WORD_LENGTH ? end : begin + MAX_WORD_LENGTH;
+    while (pos < limit && !is_space(data[pos]))
+    {
+        pos++;
+    }
+
+    word = data + begin;
+    length = pos - begin;
+    begin = pos;
+    return true;
+}
+
+bool InputReader::next_chunk(const char *&chunk, size_t &length, size_t target)
+{
+    ensure(target);
+    if (begin == end)
+    {
+        return false;
+    }
+
+    size_t stop = end - begin > target ? begin + target : end;
+    if (stop < end)
+    {
+        const char *newline = (const char *)memchr(data + stop, '\n', end - stop);
+        if (newline)
+        {
+            stop = (size_t)(newline - data) + 1;
+        }
+        else if (is_mapped() || eof)
+        {
+            stop = end;
+        }
+        else
+        {
+            // The last line is incomplete; cut before it unless it is the only line in the buffer.
+            const char *last = (const char *)memrchr(data + begin, '\n', stop - begin);
+            stop = last ? (size_t)(last - data) + 1 : stop;
+        }
+    }
+    else if (!eof)
+    {
+        const char *last = (const char *)memrchr(data + begin, '\n', stop - begin);
+        stop = last ? (size_t)(last - data) + 1 : stop;
+    }
+
+    chunk = data + begin;
+    length = stop - begin;
+    begin = stop;
+    return true;
+}
+
+size_t InputReader::peek(const char *&bytes, size_t size)
+{
+    ensure(size);
+    bytes = data + begin;
+    return end - begin;
+}
+
+void InputReader::consume(size_t length)
+{
+    begin += length;
+}
+
+bool InputReader::at_end()
+{
+    return !skip_whitespace();
+}
+
+OutputBuffer::OutputBuffer(FILE *output, size_t capacity)
+    : output(output), buffer((char *)malloc(capacity)), capacity(capacity), used(0)
+{
+}
+
+OutputBuffer::OutputBuffer(size_t capacity)
+    : output(NULL), buffer((char *)malloc(capacity)), capacity(capacity), used(0)
+{
+}
+
+OutputBuffer::~OutputBuffer()
+{
+    flush();
+    free(buffer);
+}
+
+char *OutputBuffer::reserve(size_t size)
+{
+    if (capacity - used < size)
+    {
+        if (output)
+        {
+            flush();
+        }
+        else
+        {
+            while (capacity - used < size)
+            {
+                capacity *= 2;
+            }
+            buffer = (char *)realloc(buffer, capacity);
+        }
+    }
+    return buffer + used;
+}
+
+void OutputBuffer::commit(char *end)
+{
+    used = (size_t)(end - buffer);
+}
+
+void OutputBuffer::write(const char *data, size_t size)
+{
+    if (!output)
+    {
+        memcpy(reserve(size), data, size);
+        used += size;
+        return;
+    }
+
+    while (size > 0)
+    {
+        if (used == capacity)
+        {
+            flush();
+        }
+        size_t chunk = capacity - used < size ? capacity - used : size;
+        memcpy(buffer + used, data, chunk);
+        used += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+void OutputBuffer::flush()
+{
+    if (!output)
+    {
+        return;
+    }
+    if (used > 0)
+    {
+        fwrite(buffer, 1, used, output);
+        used = 0;
+    }
+    fflush(output);
+}
+
+void OutputBuffer::clear()
+{
+    used = 0;
+}
+
+const char *OutputBuffer::data() const
+{
+    return buffer;
+}
+
+size_t OutputBuffer::size() const
+{
+    return used;
+}
+
+/** End of buffered_io.cpp */
\ No newline at end of file
@@ -0,0 +1,241 @@
+/**
+ * @file cohort_stats.cpp
+ * @brief Implementation of the streaming cohort statistics.
+ * @details The histogram bucket of a student is computed from the integer sum and count as
+ *          round(100 * sum / count) - 100, so no double average has to be formed for it. Students
+ *          are read in gradebook blocks and classified by the vector kernels before they reach the
+ *          accumulator.
+ *
+ * @see cohort_stats.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "cohort_stats.h"
+#include "format.h"
+#include "grade_class.h"
+#include "gradebook.h"
+#include <math.h>
+#include <vector>
+
+namespace
+{
+/** Percentiles printed in the summary. */
+const int PERCENTILES[] = {50, 90, 99};
+
+/** Number of hundredths per bin of the printed histogram. */
+const int PRINTED_BIN_WIDTH = 50;
+
+/**
+ * @brief Maps a class bit to its slot in CohortStats::classes.
+ */
+inline int class_slot(int bit)
+{
+    return bit == GRADE_DISTINCTION ? 0 : bit == GRADE_PASSED ? 1 : bit == GRADE_FAILED ? 2 : 3;
+}
+
+/**
+ * @brief Writes a count followed by its share of the total in percent.
+ */
+char *format_share(char *p, long long count, long long total)
+{
+    p = format_long(p, count);
+    p = format_literal(p, " (");
+    p = format_fixed(p, total > 0 ? 100.0 * (double)count / (double)total : 0, 2);
+    return format_literal(p, " %)\n");
+}
+} // namespace
+
+CohortStats::CohortStats() : total(0), average_sum(0)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        classes[i] = 0;
+    }
+    for (int i = 0; i < COHORT_STATS_BUCKETS; i++)
+    {
+        histogram[i] = 0;
+    }
+}
+
+void CohortStats::add(int sum, int count, unsigned char grade_class)
+{
+    total++;
+    classes[0] += grade_class & GRADE_DISTINCTION;
+    classes[1] += (grade_class & GRADE_PASSED) >> 1;
+    classes[2] += (grade_class & GRADE_FAILED) >> 2;
+    classes[3] += (grade_class & GRADE_INVALID) >> 3;
+    if (grade_class & GRADE_INVALID)
+    {
+        return;
+    }
+
+    double average = (double)sum / count;
+    average_sum += average;
+    long long hundredths = (long long)round_fixed(average, 2);
+    histogram[hundredths - 100]++;
+}
+
+void CohortStats::add(const int *sums, const int *counts, const unsigned char *classes, size_t students)
+{
+    for (size_t i = 0; i < students; i++)
+    {
+        add(sums[i], counts[i], classes[i]);
+    }
+}
+
+void CohortStats::merge(const CohortStats &other)
+{
+    total += other.total;
+    average_sum += other.average_sum;
+    for (int i = 0; i < 4; i++)
+    {
+        classes[i] += other.classes[i];
+    }
+    for (int i = 0; i < COHORT_STATS_BUCKETS; i++)
+    {
+        histogram[i] += other.histogram[i];
+    }
+}
+
+long long CohortStats::students() const
+{
+    return total;
+}
+
+long long CohortStats::count(int bit) const
+{
+    return classes[class_slot(bit)];
+}
+
+double CohortStats::mean() const
+{
+    long long valid = total - classes[3];
+    return valid > 0 ? average_sum / (double)valid : 0;
+}
+
+double CohortStats::percentile(double fraction) const
+{
+    long long valid = total - classes[3];
+    if (valid == 0)
+    {
+        return 0;
+    }
+
+    long long rank = (long long)ceil(fraction * (double)valid);
+    rank = rank < 1 ? 1 : rank;
+    long long seen = 0;
+    for (int i = 0; i < COHORT_STATS_BUCKETS; i++)
+    {
+        seen += histogram[i];
+        if (seen >= rank)
+        {
+            return (100 + i) / 100.0;
+        }
+    }
+    return 5;
+}
+
+char *CohortStats::format(char *p) const
+{
+    p = format_literal(p, "Studentů: ");
+    p = format_long(p, total);
+    p = format_literal(p, "\nPrůměr: ");
+    p = format_fixed(p, mean(), 2);
+    p = format_literal(p, "\nProspěl s vyznamenáním: ");
+    p = format_share(p, classes[0], total);
+    p = format_literal(p, "Prospěl: ");
+    p = format_share(p, classes[1], total);
+    p = format_literal(p, "Neprospěl: ");
+    p = format_share(p, classes[2], total);
+    p = format_literal(p, "Neplatný průměr: ");
+    p = format_share(p, classes[3], total);
+    for (int percent : PERCENTILES)
+    {
+        p = format_literal(p, "Percentil ");
+        p = format_long(p, percent);
+        p = format_literal(p, ": ");
+        p = format_fixed(p, percentile(percent / 100.0), 2);
+        *p++ = '\n';
+    }
+
+    p = format_literal(p, "Histogram:\n");
+    for (int first = 0; first < COHORT_STATS_BUCKETS - 1; first += PRINTED_BIN_WIDTH)
+    {
+        // The last bin also takes the single bucket of 5.00.
+        int last = first + PRINTED_BIN_WIDTH - 1;
+        last = last < COHORT_STATS_BUCKETS - 2 ? last : COHORT_STATS_BUCKETS - 1;
+        long long students = 0;
+        for (int i = first; i <= last; i++)
+        {
+            students += histogram[i];
+        }
+        p = format_fixed(p, (100 + first) / 100.0, 2);
+        *p++ = '-';
+        p = format_fixed(p, (100 + last) / 100.0, 2);
+        p = format_literal(p, ": ");
+        p = format_long(p, students);
+        *p++ = '\n';
+    }
+    return p;
+}
+
+long u1_2_statistics(FILE *input, FILE *output)
+{
+    return u1_2_statistics(input, output, 0);
+}
+
+long u1_2_statistics(FILE *input, FILE *output, long interval)
+{
+    InputReader reader(input);
+    OutputBuffer out(output);
+    CohortStats stats;
+
+    Gradebook book;
+    std::vector<int> sums(GRADEBOOK_BLOCK_STUDENTS);
+    std::vector<int> counts(GRADEBOOK_BLOCK_STUDENTS);
+    std::vector<unsigned char> classes(GRADEBOOK_BLOCK_STUDENTS);
+
+    long until_report = interval;
+    bool reported = false;
+    bool wellformed = true;
+    for (;;)
+    {
+        size_t wanted = GRADEBOOK_BLOCK_STUDENTS;
+        if (interval > 0 && (size_t)until_report < wanted)
+        {
+            wanted = (size_t)until_report;
+        }
+
+        gradebook_clear(book);
+        wellformed = gradebook_read(reader, book, wanted);
+        size_t block = gradebook_students(book);
+        gradebook_sums(book, sums.data());
+        gradebook_counts(book, counts.data());
+        classify_grade_sums(sums.data(), counts.data(), classes.data(), block);
+        stats.add(sums.data(), counts.data(), classes.data(), block);
+
+        if (block > 0)
+        {
+            reported = false;
+        }
+        if (interval > 0 && block > 0 && (until_report -= (long)block) == 0)
+        {
+            out.commit(stats.format(out.reserve(COHORT_STATS_MAX_LENGTH)));
+            until_report = interval;
+            reported = true;
+        }
+        if (!wellformed || block < wanted)
+        {
+            break;
+        }
+    }
+
+    if (!reported)
+    {
+        out.commit(stats.format(out.reserve(COHORT_STATS_MAX_LENGTH)));
+    }
+    return wellformed && reader.at_end() ? (long)stats.students() : -1;
+}
+
+/** End of cohort_stats.cpp */
\ No newline at end of file
@@ -0,0 +1,203 @@
+/**
+ * @file compute.cpp
+ * @brief Implementation of the pure compute API.
+ * @details The span functions copy the fields their kernel needs into small stack blocks, so the
+ *          VAT and grade-class kernels run on contiguous arrays while callers keep one record per
+ *          struct. The text functions format straight into the caller's buffer when it is large
+ *          enough for the worst case; only a smaller buffer costs a scratch allocation.
+ *
+ * @see compute.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "compute.h"
+#include "format.h"
+#include "grade_class.h"
+#include "vat.h"
+#include <string.h>
+#include <vector>
+
+namespace
+{
+/** Number of records handed to a kernel at once; the blocks live on the stack. */
+const size_t COMPUTE_BLOCK = 1024;
+
+/**
+ * @brief Runs a formatter on the caller's buffer with snprintf-like semantics.
+ * @param buffer Buffer of the caller.
+ * @param capacity Size of the buffer.
+ * @param bound Longest text the formatter can produce.
+ * @param format Formatter taking a write position and returning the position after the text.
+ * @return Length of the text; it was written only if it fits.
+ */
+template <typename Formatter>
+size_t format_bounded(char *buffer, size_t capacity, size_t bound, const Formatter &format)
+{
+    if (capacity >= bound)
+    {
+        return (size_t)(format(buffer) - buffer);
+    }
+    std::vector<char> scratch(bound);
+    size_t length = (size_t)(format(&scratch[0]) - &scratch[0]);
+    if (length <= capacity)
+    {
+        memcpy(buffer, &scratch[0], length);
+    }
+    return length;
+}
+} // namespace
+
+bool compute_receipt(const ReceiptRecord &record, Receipt &receipt)
+{
+    VatRate rate;
+    if (!vat_rate_from_percent(record.percent, rate))
+    {
+        return false;
+    }
+    receipt.gross = vat_gross_price(record.price, rate);
+    receipt.net_total = (long long)record.price * record.count;
+    receipt.gross_total = (long long)receipt.gross * record.count;
+    return true;
+}
+
+size_t compute_receipt(const ReceiptRecord *records, size_t count, Receipt *receipts)
+{
+    int prices[COMPUTE_BLOCK];
+    unsigned char rates[COMPUTE_BLOCK];
+    int gross[COMPUTE_BLOCK];
+
+    for (size_t first = 0; first < count; first += COMPUTE_BLOCK)
+    {
+        size_t block = count - first < COMPUTE_BLOCK ? count - first : COMPUTE_BLOCK;
+        for (size_t i = 0; i < block; i++)
+        {
+            VatRate rate;
+            if (!vat_rate_from_percent(records[first + i].percent, rate))
+            {
+                // Price the valid records in front of the bad one, then stop.
+                block = i;
+                count = first + i;
+                break;
+            }
+            prices[i] = records[first + i].price;
+            rates[i] = (unsigned char)rate;
+        }
+
+        vat_gross_prices_mixed(prices, rates, gross, block);
+
+        for (size_t i = 0; i < block; i++)
+        {
+            const ReceiptRecord &record = records[first + i];
+            Receipt &receipt = receipts[first + i];
+            receipt.gross = gross[i];
+            receipt.net_total = (long long)record.price * record.count;
+            receipt.gross_total = (long long)gross[i] * record.count;
+        }
+    }
+    return count;
+}
+
+size_t receipt_text(const ReceiptRecord &record, const Receipt &receipt, char *buffer, size_t capacity)
+{
+    return format_bounded(buffer, capacity, FORMAT_RECEIPT_MAX_LENGTH, [&](char *p) {
+        return format_u1_1_receipt(p, record.count, record.price, receipt.gross, receipt.net_total,
+                                   receipt.gross_total, record.percent);
+    });
+}
+
+void write_receipts(const ReceiptRecord *records, const Receipt *receipts, size_t count, OutputBuffer &out)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        char *p = out.reserve(FORMAT_RECEIPT_MAX_LENGTH);
+        out.commit(format_u1_1_receipt(p, records[i].count, records[i].price, receipts[i].gross, receipts[i].net_total,
+                                       receipts[i].gross_total, records[i].percent));
+    }
+}
+
+GradeReport compute_grade_report(const GradeRecord &record)
+{
+    int sum = 0;
+    for (int i = 0; i < COMPUTE_GRADES; i++)
+    {
+        sum += record.grades[i];
+    }
+
+    GradeReport report;
+    report.average = (double)sum / COMPUTE_GRADES;
+    report.status = grade_status(report.average);
+    return report;
+}
+
+void compute_grade_report(const GradeRecord *records, size_t count, GradeReport *reports)
+{
+    int sums[COMPUTE_BLOCK];
+    unsigned char classes[COMPUTE_BLOCK];
+
+    for (size_t first = 0; first < count; first += COMPUTE_BLOCK)
+    {
+        size_t block = count - first < COMPUTE_BLOCK ? count - first : COMPUTE_BLOCK;
+        for (size_t i = 0; i < block; i++)
+        {
+            const int *grades = records[first + i].grades;
+            sums[i] = grades[0] + grades[1] + grades[2] + grades[3] + grades[4];
+        }
+
+        classify_grade_sums(sums, COMPUTE_GRADES, classes, block);
+
+        for (size_t i = 0; i < block; i++)
+        {
+            reports[first + i].average = (double)sums[i] / COMPUTE_GRADES;
+            reports[first + i].status = grade_status_from_class(classes[i]);
+        }
+    }
+}
+
+size_t grade_report_text(const GradeRecord &record, const GradeReport &report, char *buffer, size_t capacity)
+{
+    return format_bounded(buffer, capacity, FORMAT_REPORT_MAX_LENGTH, [&](char *p) {
+        return format_u1_2_report(p, record.grades, report.average, report.status);
+    });
+}
+
+void write_grade_reports(const GradeRecord *records, const GradeReport *reports, size_t count, OutputBuffer &out)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        char *p = out.reserve(FORMAT_REPORT_MAX_LENGTH);
+        out.commit(format_u1_2_report(p, records[i].grades, reports[i].average, reports[i].status));
+    }
+}
+
+int compute_exchange(const ExchangeRecord &record)
+{
+    return round_half_up(record.rate * record.count);
+}
+
+void compute_exchange(const ExchangeRecord *records, size_t count, int *rounded)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        rounded[i] = round_half_up(records[i].rate * records[i].count);
+    }
+}
+
+size_t exchange_text(const ExchangeRecord &record, int rounded, char *buffer, size_t capacity)
+{
+    return format_bounded(buffer, capacity, format_conversion_max_length(record.length), [&](char *p) {
+        return format_u1_3_conversion(p, record.currency, record.length, record.rate, record.count, rounded);
+    });
+}
+
+void write_exchanges(const ExchangeRecord *records, const int *rounded, size_t count, OutputBuffer &out)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        const ExchangeRecord &record = records[i];
+        char *p = out.reserve(format_conversion_max_length(record.length));
+        out.commit(format_u1_3_conversion(p, record.currency, record.length, record.rate, record.count, rounded[i]));
+    }
+}
+
+/** End of compute.cpp */
\ No newline at end of file
@@ -0,0 +1,318 @@
+/**
+ * @file cross_rates.cpp
+ * @brief Implementation of the cross-rate matrix and the cross conversion mode.
+ * @details The currencies are indexed in alphabetical order and located through the slot of their
+ *          key in the ISO 4217 perfect hash of rate_table.h, so finding the row of a currency is one
+ *          probe as well. The batch kernel parses a block of records, orders it by source with a
+ *          counting sort, multiplies row by row and then formats the results in input order.
+ *
+ * @see cross_rates.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "cross_rates.h"
+#include "format.h"
+#include "functions.h"
+#include <algorithm>
+#include <string.h>
+
+namespace
+{
+/** Number of records converted together. */
+const size_t BLOCK_RECORDS = 4096;
+
+/** Number of doubles in a 64-byte cache line; rows are padded to a multiple of it. */
+const size_t LINE_DOUBLES = 8;
+
+/** Upper bound of one conversion line apart from the formatted result. */
+const size_t MAX_LINE_LENGTH = 96;
+
+/** Key of the base currency. */
+const uint32_t CZK_KEY = currency_key("CZK");
+
+/**
+ * @brief Reads the base rates of a table, adding CZK with the rate 1 if the table has no rate for it.
+ */
+void collect(const RateTable &rates, std::vector<uint32_t> &keys, std::vector<double> &base)
+{
+    keys.resize(rates.size());
+    base.resize(rates.size());
+    if (!keys.empty())
+    {
+        rates.list(&keys[0], &base[0]);
+    }
+    std::vector<uint32_t>::iterator position = std::lower_bound(keys.begin(), keys.end(), CZK_KEY);
+    if (position == keys.end() || *position != CZK_KEY)
+    {
+        base.insert(base.begin() + (position - keys.begin()), 1.0);
+        keys.insert(position, CZK_KEY);
+    }
+}
+} // namespace
+
+CrossRateMatrix::CrossRateMatrix() : indices(RATE_TABLE_SLOTS, -1), first_row(NULL), stride(LINE_DOUBLES)
+{
+    build(RateTable());
+}
+
+void CrossRateMatrix::build(const RateTable &rates)
+{
+    std::vector<uint32_t> new_keys;
+    std::vector<double> new_base;
+    collect(rates, new_keys, new_base);
+    rebuild(new_keys, new_base);
+}
+
+/**
+ * @brief Lays out the matrix for a new set of currencies and fills every cell.
+ */
+void CrossRateMatrix::rebuild(const std::vector<uint32_t> &new_keys, const std::vector<double> &new_base)
+{
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        indices[currency_slot(keys[i])] = -1;
+    }
+    keys = new_keys;
+    base = new_base;
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        indices[currency_slot(keys[i])] = (int16_t)i;
+    }
+
+    size_t count = keys.size();
+    stride = (count + LINE_DOUBLES - 1) / LINE_DOUBLES * LINE_DOUBLES;
+    cells.assign(stride * count + LINE_DOUBLES, 0.0);
+    uintptr_t address = (uintptr_t)cells.data();
+    first_row = (double *)((address + 63) & ~(uintptr_t)63);
+
+    for (size_t source = 0; source < count; source++)
+    {
+        double *cells_row = first_row + source * stride;
+        for (size_t target = 0; target < count; target++)
+        {
+            cells_row[target] = base[source] / base[target];
+        }
+    }
+}
+
+/**
+ * @brief Recomputes the row and the column of one currency from the current base rates.
+ */
+void CrossRateMatrix::recompute(int changed)
+{
+    size_t count = keys.size();
+    double *changed_row = first_row + (size_t)changed * stride;
+    for (size_t target = 0; target < count; target++)
+    {
+        changed_row[target] = base[changed] / base[target];
+    }
+    for (size_t source = 0; source < count; source++)
+    {
+        first_row[source * stride + changed] = base[source] / base[changed];
+    }
+}
+
+size_t CrossRateMatrix::update(const RateTable &rates)
+{
+    std::vector<uint32_t> new_keys;
+    std::vector<double> new_base;
+    collect(rates, new_keys, new_base);
+    if (new_keys != keys)
+    {
+        rebuild(new_keys, new_base);
+        return keys.size();
+    }
+
+    size_t changed = 0;
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        if (new_base[i] != base[i])
+        {
+            base[i] = new_base[i];
+            recompute((int)i);
+            changed++;
+        }
+    }
+    return changed;
+}
+
+bool CrossRateMatrix::update(uint32_t key, double rate)
+{
+    if (!is_iso_currency(key))
+    {
+        return false;
+    }
+    int position = indices[currency_slot(key)];
+    if (position >= 0)
+    {
+        base[position] = rate;
+        recompute(position);
+        return true;
+    }
+
+    std::vector<uint32_t> new_keys(keys);
+    std::vector<double> new_base(base);
+    std::vector<uint32_t>::iterator inserted = std::lower_bound(new_keys.begin(), new_keys.end(), key);
+    new_base.insert(new_base.begin() + (inserted - new_keys.begin()), rate);
+    new_keys.insert(inserted, key);
+    rebuild(new_keys, new_base);
+    return true;
+}
+
+size_t CrossRateMatrix::currencies() const
+{
+    return keys.size();
+}
+
+int CrossRateMatrix::index(const CurrencyCode &code) const
+{
+    uint32_t code_key = 0;
+    if (code.tag != CURRENCY_INLINE || !currency_key(code.bytes, 3, code_key))
+    {
+        return -1;
+    }
+    int position = indices[currency_slot(code_key)];
+    return position >= 0 && keys[position] == code_key ? position : -1;
+}
+
+uint32_t CrossRateMatrix::key(int position) const
+{
+    return keys[position];
+}
+
+namespace
+{
+/**
+ * @brief Converts the records block by block, calling 'refresh' before each block is parsed.
+ * @details The matrix may change in 'refresh' only, so all records of a block use the same rates.
+ */
+template <typename Refresh>
+long convert_blocks(const CrossRateMatrix &matrix, InputReader &reader, OutputBuffer &out, Refresh refresh)
+{
+    std::vector<int> sources(BLOCK_RECORDS);
+    std::vector<int> targets(BLOCK_RECORDS);
+    std::vector<int> amounts(BLOCK_RECORDS);
+    std::vector<double> results(BLOCK_RECORDS);
+    std::vector<unsigned> order(BLOCK_RECORDS);
+    std::vector<unsigned> starts;
+
+    long records = 0;
+    bool wellformed = true;
+    for (;;)
+    {
+        refresh();
+        const size_t currencies = matrix.currencies();
+        starts.resize(currencies + 1);
+
+        size_t filled = 0;
+        const char *word = NULL;
+        size_t length = 0;
+        while (filled < BLOCK_RECORDS && reader.next_word(word, length))
+        {
+            CurrencyCode source;
+            CurrencyCode target;
+            bool parsed = currency_code_pack(word, length, source) && reader.next_word(word, length) &&
+                          currency_code_pack(word, length, target) && reader.next_int(amounts[filled]);
+            sources[filled] = parsed ? matrix.index(source) : -1;
+            targets[filled] = parsed ? matrix.index(target) : -1;
+            if (sources[filled] < 0 || targets[filled] < 0)
+            {
+                wellformed = false;
+                break;
+            }
+            filled++;
+        }
+
+        // Counting sort by source, so every row is loaded once per block.
+        std::fill(starts.begin(), starts.end(), 0);
+        for (size_t i = 0; i < filled; i++)
+        {
+            starts[sources[i] + 1]++;
+        }
+        for (size_t c = 0; c < currencies; c++)
+        {
+            starts[c + 1] += starts[c];
+        }
+        for (size_t i = 0; i < filled; i++)
+        {
+            order[starts[sources[i]]++] = (unsigned)i;
+        }
+        for (size_t k = 0; k < filled;)
+        {
+            const double *rates = matrix.row(sources[order[k]]);
+            int source = sources[order[k]];
+            for (; k < filled && sources[order[k]] == source; k++)
+            {
+                unsigned i = order[k];
+                results[i] = amounts[i] * rates[targets[i]];
+            }
+        }
+
+        for (size_t i = 0; i < filled; i++)
+        {
+            char source[3];
+            char target[3];
+            currency_letters(matrix.key(sources[i]), source);
+            currency_letters(matrix.key(targets[i]), target);
+
+            char *p = out.reserve(FORMAT_FIXED_MAX_LENGTH + MAX_LINE_LENGTH);
+            p = format_long(p, amounts[i]);
+            *p++ = ' ';
+            memcpy(p, source, 3);
+            p = format_literal(p + 3, " = ");
+            p = format_fixed(p, results[i], 1);
+            *p++ = ' ';
+            memcpy(p, target, 3);
+            p = format_literal(p + 3, " Zaokrouhleno: ");
+            p = format_long(p, round_half_up(results[i]));
+            *p++ = ' ';
+            memcpy(p, target, 3);
+            p += 3;
+            *p++ = '\n';
+            out.commit(p);
+        }
+        records += (long)filled;
+        if (!wellformed || filled < BLOCK_RECORDS)
+        {
+            break;
+        }
+    }
+
+    return wellformed && reader.at_end() ? records : -1;
+}
+} // namespace
+
+long u1_3_cross_conversions(const CrossRateMatrix &matrix, InputReader &reader, OutputBuffer &out)
+{
+    return convert_blocks(matrix, reader, out, []() {});
+}
+
+long u1_3_live_cross_conversions(RateSnapshots &snapshots, CrossRateMatrix &matrix, InputReader &reader,
+                                 OutputBuffer &out)
+{
+    RateSnapshots::Reader rates(snapshots);
+    unsigned long long version = 0;
+    auto refresh = [&]() {
+        if (snapshots.version() == version)
+        {
+            return;
+        }
+        const RateSnapshot *snapshot = rates.acquire();
+        if (snapshot)
+        {
+            matrix.update(snapshot->rates);
+            version = snapshot->version;
+        }
+        rates.release();
+    };
+
+    refresh();
+    if (version == 0)
+    {
+        return -1;
+    }
+    return convert_blocks(matrix, reader, out, refresh);
+}
+
+/** End of cross_rates.cpp */
\ No newline at end of file
@@ -0,0 +1,51 @@
+/**
+ * @file currency_code.cpp
+ * @brief Implementation of the currency code interner.
+ * @details Only words that are not three bytes long reach the hash map; the common ISO codes are
+ *          packed without touching it.
+ *
+ * @see currency_code.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "currency_code.h"
+
+bool CurrencyInterner::intern(const char *text, size_t length, CurrencyCode &code)
+{
+    if (currency_code_pack(text, length, code))
+    {
+        return true;
+    }
+
+    std::string name(text, length);
+    std::unordered_map<std::string, uint32_t>::const_iterator found = indices.find(name);
+    uint32_t position = 0;
+    if (found != indices.end())
+    {
+        position = found->second;
+    }
+    else
+    {
+        if (names.size() >= CURRENCY_MAX_INTERNED)
+        {
+            return false;
+        }
+        position = (uint32_t)names.size();
+        names.push_back(name);
+        indices.insert(std::make_pair(name, position));
+    }
+
+    code.bytes[0] = (char)(position & 0xff);
+    code.bytes[1] = (char)(position >> 8 & 0xff);
+    code.bytes[2] = (char)(position >> 16 & 0xff);
+    code.tag = CURRENCY_INTERNED;
+    return true;
+}
+
+size_t CurrencyInterner::interned() const
+{
+    return names.size();
+}
+
+/** End of currency_code.cpp */
\ No newline at end of file
@@ -0,0 +1,683 @@
+/**
+ * @file daemon.cpp
+ * @brief Implementation of the request server and its client.
+ * @details The loop watches the listening socket, an eventfd for stop() and every connection with
+ *          the descriptor itself as the epoll data, and finds the connection state in a vector
+ *          indexed by descriptor. Responses are formatted directly into the connection's
+ *          OutputBuffer, which is cleared whenever the socket has taken all of it.
+ *
+ * @see daemon.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "daemon.h"
+#include "grade_class.h"
+#include "vat.h"
+#include <chrono>
+#include <errno.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+/** Number of grades in a grade report request. */
+const int DAEMON_GRADES_COUNT = 5;
+
+/** Size of the receive buffer of a connection; holds many pipelined requests. */
+const size_t RECEIVE_BUFFER_SIZE = 64 << 10;
+
+/** Number of events taken from the kernel per epoll_wait(). */
+const int EVENTS_PER_WAIT = 64;
+
+/** Size of the body of a receipt request. */
+const size_t RECEIPT_BODY = 1 + 4 + 4 + 1;
+
+/** Size of the body of a grade report request. */
+const size_t GRADES_BODY = 1 + DAEMON_GRADES_COUNT;
+
+/** Size of the body of a conversion request without the name. */
+const size_t CONVERSION_BODY = 1 + 1 + 8 + 4;
+
+void store_u16(char *p, size_t value)
+{
+    p[0] = (char)(value & 0xff);
+    p[1] = (char)(value >> 8 & 0xff);
+}
+
+size_t load_u16(const char *p)
+{
+    return (size_t)(unsigned char)p[0] | (size_t)(unsigned char)p[1] << 8;
+}
+
+void store_u32(char *p, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        p[i] = (char)(value >> 8 * i & 0xff);
+    }
+}
+
+uint32_t load_u32(const char *p)
+{
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--)
+    {
+        value = value << 8 | (unsigned char)p[i];
+    }
+    return value;
+}
+
+void store_u64(char *p, uint64_t value)
+{
+    store_u32(p, (uint32_t)value);
+    store_u32(p + 4, (uint32_t)(value >> 32));
+}
+
+uint64_t load_u64(const char *p)
+{
+    return (uint64_t)load_u32(p) | (uint64_t)load_u32(p + 4) << 32;
+}
+
+/**
+ * @brief Formats the text of a request into 'p'.
+ * @return Position after the text, or NULL with 'status' set if the request is not answered.
+ */
+char *answer(const char *body, size_t length, char *p, DaemonStatus &status)
+{
+    status = DAEMON_MALFORMED;
+    switch ((unsigned char)body[0])
+    {
+    case DAEMON_RECEIPT: {
+        VatRate rate;
+        if (length != RECEIPT_BODY || !vat_rate_from_percent((unsigned char)body[9], rate))
+        {
+            return NULL;
+        }
+        int percent = (unsigned char)body[9];
+        int count = (int)load_u32(body + 1);
+        int price = (int)load_u32(body + 5);
+        status = DAEMON_OK;
+        return format_u1_1_receipt(p, count, price, vat_gross_price(price, rate), percent);
+    }
+    case DAEMON_GRADES: {
+        if (length != GRADES_BODY)
+        {
+            return NULL;
+        }
+        int grades[DAEMON_GRADES_COUNT];
+        int sum = 0;
+        for (int i = 0; i < DAEMON_GRADES_COUNT; i++)
+        {
+            grades[i] = (unsigned char)body[1 + i];
+            sum += grades[i];
+        }
+        GradeStatus grade_status = grade_status_from_class(classify_grade_sum(sum, U1_2_THRESHOLDS));
+        status = DAEMON_OK;
+        return format_u1_2_report(p, grades, (double)sum / DAEMON_GRADES_COUNT, grade_status);
+    }
+    case DAEMON_CONVERSION: {
+        size_t name_length = length >= 2 ? (unsigned char)body[1] : 0;
+        if (length != CONVERSION_BODY + name_length)
+        {
+            return NULL;
+        }
+        const char *fields = body + 2 + name_length;
+        uint64_t bits = load_u64(fields);
+        double rate;
+        memcpy(&rate, &bits, sizeof(rate));
+        int count = (int)load_u32(fields + 8);
+        status = DAEMON_OK;
+        return format_u1_3_conversion(p, body + 2, name_length, rate, count, round_half_up(rate * count));
+    }
+    default:
+        status = DAEMON_UNKNOWN_TASK;
+        return NULL;
+    }
+}
+} // namespace
+
+size_t daemon_receipt_request(char *frame, int count, int price, int percent)
+{
+    char *body = frame + DAEMON_LENGTH_SIZE;
+    body[0] = (char)DAEMON_RECEIPT;
+    store_u32(body + 1, (uint32_t)count);
+    store_u32(body + 5, (uint32_t)price);
+    body[9] = (char)percent;
+    store_u16(frame, RECEIPT_BODY);
+    return DAEMON_LENGTH_SIZE + RECEIPT_BODY;
+}
+
+size_t daemon_grades_request(char *frame, const unsigned char *grades)
+{
+    char *body = frame + DAEMON_LENGTH_SIZE;
+    body[0] = (char)DAEMON_GRADES;
+    memcpy(body + 1, grades, DAEMON_GRADES_COUNT);
+    store_u16(frame, GRADES_BODY);
+    return DAEMON_LENGTH_SIZE + GRADES_BODY;
+}
+
+size_t daemon_conversion_request(char *frame, const char *currency, size_t length, double rate, int count)
+{
+    if (length > 255)
+    {
+        return 0;
+    }
+    char *body = frame + DAEMON_LENGTH_SIZE;
+    body[0] = (char)DAEMON_CONVERSION;
+    body[1] = (char)length;
+    memcpy(body + 2, currency, length);
+    uint64_t bits;
+    memcpy(&bits, &rate, sizeof(bits));
+    store_u64(body + 2 + length, bits);
+    store_u32(body + 10 + length, (uint32_t)count);
+    store_u16(frame, CONVERSION_BODY + length);
+    return DAEMON_LENGTH_SIZE + CONVERSION_BODY + length;
+}
+
+char *daemon_respond(const char *body, size_t length, char *p)
+{
+    char *frame = p;
+    DaemonStatus status;
+    char *end = length > 0 ? answer(body, length, frame + DAEMON_LENGTH_SIZE + 1, status) : NULL;
+    if (!end)
+    {
+        end = frame + DAEMON_LENGTH_SIZE + 1;
+    }
+    frame[DAEMON_LENGTH_SIZE] = length > 0 ? (char)status : (char)DAEMON_MALFORMED;
+    store_u16(frame, (size_t)(end - frame) - DAEMON_LENGTH_SIZE);
+    return end;
+}
+
+/**
+ * @brief State of one client connection.
+ */
+struct DaemonServer::Connection
+{
+    explicit Connection(int fd)
+        : fd(fd), input(RECEIVE_BUFFER_SIZE), filled(0), sent(0), events(EPOLLIN), finished(false)
+    {
+    }
+
+    int fd;
+    std::vector<char> input; ///< Received bytes; starts with an incomplete frame, if any.
+    size_t filled;           ///< Number of bytes in 'input'.
+    OutputBuffer output;     ///< Responses not yet taken by the socket.
+    size_t sent;             ///< Bytes of 'output' already taken by the socket.
+    uint32_t events;         ///< Events the connection is registered for.
+    bool finished;           ///< The client shut down its side; close once all responses are sent.
+};
+
+DaemonServer::DaemonServer() : listener(-1), epoll(-1), wakeup(-1), answered(0)
+{
+}
+
+DaemonServer::~DaemonServer()
+{
+    for (size_t fd = 0; fd < connections.size(); fd++)
+    {
+        if (connections[fd])
+        {
+            close((int)fd);
+        }
+    }
+    if (listener >= 0)
+    {
+        close(listener);
+        unlink(path.c_str());
+    }
+    if (epoll >= 0)
+    {
+        close(epoll);
+    }
+    if (wakeup >= 0)
+    {
+        close(wakeup);
+    }
+}
+
+bool DaemonServer::listen(const char *path)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        return false;
+    }
+    strcpy(address.sun_path, path);
+
+    epoll = epoll_create1(EPOLL_CLOEXEC);
+    wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (epoll < 0 || wakeup < 0 || listener < 0)
+    {
+        return false;
+    }
+
+    // Only a leftover socket is removed; any other file at the path makes bind() fail instead.
+    struct stat status;
+    if (lstat(path, &status) == 0 && S_ISSOCK(status.st_mode))
+    {
+        unlink(path);
+    }
+    if (bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        close(listener);
+        listener = -1;
+        return false;
+    }
+    this->path = path;
+    if (::listen(listener, SOMAXCONN) != 0)
+    {
+        return false;
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = listener;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event);
+    event.data.fd = wakeup;
+    return epoll_ctl(epoll, EPOLL_CTL_ADD, wakeup, &event) == 0;
+}
+
+bool DaemonServer::run()
+{
+    if (listener < 0)
+    {
+        return false;
+    }
+
+    struct epoll_event events[EVENTS_PER_WAIT];
+    for (;;)
+    {
+        int ready = epoll_wait(epoll, events, EVENTS_PER_WAIT, -1);
+        if (ready < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+
+        for (int i = 0; i < ready; i++)
+        {
+            int fd = events[i].data.fd;
+            if (fd == wakeup)
+            {
+                uint64_t count;
+                if (read(wakeup, &count, sizeof(count)) == (ssize_t)sizeof(count))
+                {
+                    return true;
+                }
+                continue;
+            }
+            if (fd == listener)
+            {
+                accept_connections();
+                continue;
+            }
+            if (!connections[fd])
+            {
+                continue;
+            }
+
+            Connection &connection = *connections[fd];
+            bool alive = !(events[i].events & (EPOLLERR | EPOLLHUP)) || (events[i].events & EPOLLIN);
+            if (alive && (events[i].events & EPOLLIN))
+            {
+                alive = receive(connection);
+            }
+            if (alive)
+            {
+                alive = transmit(connection);
+            }
+            if (!alive)
+            {
+                close_connection(fd);
+            }
+        }
+    }
+}
+
+void DaemonServer::stop()
+{
+    uint64_t one = 1;
+    ssize_t written = write(wakeup, &one, sizeof(one));
+    (void)written;
+}
+
+unsigned long long DaemonServer::requests() const
+{
+    return answered.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Accepts all pending connections.
+ */
+void DaemonServer::accept_connections()
+{
+    for (;;)
+    {
+        int fd = accept4(listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            return;
+        }
+
+        if ((size_t)fd >= connections.size())
+        {
+            connections.resize((size_t)fd + 1);
+        }
+        connections[fd].reset(new Connection(fd));
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            connections[fd].reset();
+            close(fd);
+        }
+    }
+}
+
+/**
+ * @brief Reads what has arrived and answers every complete request.
+ * @return false if the connection has to be closed.
+ */
+bool DaemonServer::receive(Connection &connection)
+{
+    while (!connection.finished && connection.output.size() - connection.sent <= DAEMON_MAX_PENDING)
+    {
+        ssize_t count = read(connection.fd, &connection.input[connection.filled],
+                             connection.input.size() - connection.filled);
+        if (count == 0)
+        {
+            // A trailing partial frame is dropped; the complete ones are still answered.
+            connection.finished = true;
+            break;
+        }
+        if (count < 0)
+        {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        connection.filled += (size_t)count;
+
+        // Answer every complete frame; the buffer always has room for the longest one.
+        size_t offset = 0;
+        const char *input = &connection.input[0];
+        while (connection.filled - offset >= DAEMON_LENGTH_SIZE)
+        {
+            size_t length = load_u16(input + offset);
+            if (length == 0 || length > DAEMON_MAX_REQUEST)
+            {
+                return false;
+            }
+            if (connection.filled - offset - DAEMON_LENGTH_SIZE < length)
+            {
+                break;
+            }
+            char *p = connection.output.reserve(DAEMON_MAX_RESPONSE);
+            connection.output.commit(daemon_respond(input + offset + DAEMON_LENGTH_SIZE, length, p));
+            offset += DAEMON_LENGTH_SIZE + length;
+            answered.fetch_add(1, std::memory_order_relaxed);
+        }
+        memmove(&connection.input[0], input + offset, connection.filled - offset);
+        connection.filled -= offset;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes pending responses and adjusts the events the connection waits for.
+ * @return false if the connection has to be closed.
+ */
+bool DaemonServer::transmit(Connection &connection)
+{
+    while (connection.sent < connection.output.size())
+    {
+        ssize_t count = ::send(connection.fd, connection.output.data() + connection.sent,
+                               connection.output.size() - connection.sent, MSG_NOSIGNAL);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            return false;
+        }
+        connection.sent += (size_t)count;
+    }
+
+    size_t pending = connection.output.size() - connection.sent;
+    if (pending == 0)
+    {
+        if (connection.finished)
+        {
+            return false;
+        }
+        connection.output.clear();
+        connection.sent = 0;
+    }
+
+    uint32_t events = EPOLLIN;
+    if (pending > 0)
+    {
+        events = pending > DAEMON_MAX_PENDING || connection.finished ? EPOLLOUT : EPOLLIN | EPOLLOUT;
+    }
+    if (events != connection.events)
+    {
+        struct epoll_event event;
+        event.events = events;
+        event.data.fd = connection.fd;
+        if (epoll_ctl(epoll, EPOLL_CTL_MOD, connection.fd, &event) != 0)
+        {
+            return false;
+        }
+        connection.events = events;
+    }
+    return true;
+}
+
+void DaemonServer::close_connection(int fd)
+{
+    epoll_ctl(epoll, EPOLL_CTL_DEL, fd, NULL);
+    close(fd);
+    connections[fd].reset();
+}
+
+DaemonClient::DaemonClient() : socket(-1), input(RECEIVE_BUFFER_SIZE), filled(0)
+{
+}
+
+DaemonClient::~DaemonClient()
+{
+    if (socket >= 0)
+    {
+        close(socket);
+    }
+}
+
+bool DaemonClient::connect(const char *path)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        return false;
+    }
+    strcpy(address.sun_path, path);
+
+    socket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    return socket >= 0 && ::connect(socket, (struct sockaddr *)&address, sizeof(address)) == 0;
+}
+
+bool DaemonClient::send(const char *frame, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t count = ::send(socket, frame, size, MSG_NOSIGNAL);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        frame += count;
+        size -= (size_t)count;
+    }
+    return true;
+}
+
+bool DaemonClient::receive(int &status, std::string &text)
+{
+    for (;;)
+    {
+        if (filled >= DAEMON_LENGTH_SIZE)
+        {
+            size_t length = load_u16(&input[0]);
+            if (length == 0)
+            {
+                return false;
+            }
+            size_t frame = DAEMON_LENGTH_SIZE + length;
+            if (filled >= frame)
+            {
+                status = (unsigned char)input[DAEMON_LENGTH_SIZE];
+                text.assign(&input[DAEMON_LENGTH_SIZE + 1], length - 1);
+                memmove(&input[0], &input[frame], filled - frame);
+                filled -= frame;
+                return true;
+            }
+        }
+
+        ssize_t count = recv(socket, &input[filled], input.size() - filled, 0);
+        if (count <= 0)
+        {
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        filled += (size_t)count;
+    }
+}
+
+bool DaemonClient::call(const char *frame, size_t size, int &status, std::string &text)
+{
+    return send(frame, size) && receive(status, text);
+}
+
+long daemon_replay(DaemonClient &client, DaemonTask task, InputReader &reader, OutputBuffer &out,
+                   std::vector<double> &latencies)
+{
+    char frame[DAEMON_MAX_REQUEST_FRAME];
+    char name[255];
+    std::string text;
+    long records = 0;
+    for (;;)
+    {
+        size_t size = 0;
+        if (task == DAEMON_RECEIPT)
+        {
+            int count = 0;
+            int price = 0;
+            int percent = 20;
+            if (!reader.next_int(count))
+            {
+                break;
+            }
+            if (!reader.next_int(price))
+            {
+                return -1;
+            }
+            if (reader.next_int_on_line(percent) && (percent < 0 || percent > 255))
+            {
+                return -1;
+            }
+            size = daemon_receipt_request(frame, count, price, percent);
+        }
+        else if (task == DAEMON_GRADES)
+        {
+            unsigned char grades[DAEMON_GRADES_COUNT];
+            for (int i = 0; i < DAEMON_GRADES_COUNT; i++)
+            {
+                int grade = 0;
+                if (!reader.next_int(grade))
+                {
+                    if (i == 0)
+                    {
+                        return reader.at_end() ? records : -1;
+                    }
+                    return -1;
+                }
+                if (grade < 0 || grade > 255)
+                {
+                    return -1;
+                }
+                grades[i] = (unsigned char)grade;
+            }
+            size = daemon_grades_request(frame, grades);
+        }
+        else
+        {
+            const char *currency = NULL;
+            size_t length = 0;
+            double rate = 0;
+            int count = 0;
+            if (!reader.next_word(currency, length))
+            {
+                break;
+            }
+            if (length > sizeof(name))
+            {
+                return -1;
+            }
+            // The name is copied before the next token is read; a refill may move it.
+            memcpy(name, currency, length);
+            if (!reader.next_double(rate) || !reader.next_int(count))
+            {
+                return -1;
+            }
+            size = daemon_conversion_request(frame, name, length, rate, count);
+        }
+
+        int status = DAEMON_OK;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (!client.call(frame, size, status, text))
+        {
+            return -1;
+        }
+        latencies.push_back(
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        if (status != DAEMON_OK)
+        {
+            return -1;
+        }
+        out.write(text.data(), text.size());
+        records++;
+    }
+
+    return reader.at_end() ? records : -1;
+}
+
+/** End of daemon.cpp */
\ No newline at end of file
@@ -0,0 +1,464 @@
+/**
+ * @file external_group.cpp
+ * @brief Implementation of the external merge sort behind the grouping mode.
+ * @details Events are kept as fixed-size binary records so that runs can be written and read with
+ *          `pwrite`/`pread` of whole buffers at their offset in a spill file. Every event carries a
+ *          sequence number in input order; sorting by (student, sequence) makes the order total, so
+ *          the result does not depend on how the input was split into runs.
+ *
+ * @see external_group.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "external_group.h"
+#include "buffered_io.h"
+#include "format.h"
+#include "grade_class.h"
+#include "gradebook.h"
+#include <algorithm>
+#include <functional>
+#include <limits.h>
+#include <memory>
+#include <queue>
+#include <stdint.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+/**
+ * @brief One grade event as stored in the runs.
+ */
+struct GradeEvent
+{
+    int32_t student;   ///< Student ID.
+    int32_t grade;     ///< Grade.
+    uint64_t sequence; ///< Position of the event in the input.
+};
+
+inline bool operator<(const GradeEvent &a, const GradeEvent &b)
+{
+    return a.student != b.student ? a.student < b.student : a.sequence < b.sequence;
+}
+
+/** Smallest read buffer of a run during merging. */
+const size_t MIN_MERGE_BUFFER = 16 << 10;
+
+/** The input, output and spill write buffers get one part in IO_SHARE of the memory limit. */
+const size_t IO_SHARE = 8;
+
+/** Upper bound of the "Student <id>" header, the "Známky: " prefix and one grade. */
+const size_t MAX_HEADER_LENGTH = 64;
+
+/**
+ * @brief Sorted run stored in a spill file.
+ */
+struct Run
+{
+    uint64_t offset; ///< Position of the first event, counted in events.
+    uint64_t events; ///< Number of events.
+};
+
+/**
+ * @class SpillFile
+ * @brief Temporary file holding sorted runs one after another.
+ * @details Runs are addressed by offset, so one file holds any number of them and the grouping
+ *          keeps only two files open however large the input is.
+ */
+class SpillFile
+{
+  public:
+    SpillFile() : file(NULL), size(0)
+    {
+    }
+
+    ~SpillFile()
+    {
+        if (file)
+        {
+            fclose(file);
+        }
+    }
+
+    /**
+     * @brief Appends events at the end of the file, creating it on first use.
+     * @return false if the file could not be created or written.
+     */
+    bool append(const GradeEvent *events, size_t count)
+    {
+        if (!file && !(file = tmpfile()))
+        {
+            return false;
+        }
+        const char *data = (const char *)events;
+        size_t left = count * sizeof(GradeEvent);
+        off_t position = (off_t)(size * sizeof(GradeEvent));
+        while (left > 0)
+        {
+            ssize_t written = pwrite(fileno(file), data, left, position);
+            if (written <= 0)
+            {
+                return false;
+            }
+            data += written;
+            left -= (size_t)written;
+            position += written;
+        }
+        size += count;
+        return true;
+    }
+
+    /**
+     * @brief Reads events from a position.
+     * @return false on a read error or if the file ends early.
+     */
+    bool read(uint64_t offset, GradeEvent *events, size_t count) const
+    {
+        char *data = (char *)events;
+        size_t left = count * sizeof(GradeEvent);
+        off_t position = (off_t)(offset * sizeof(GradeEvent));
+        while (left > 0)
+        {
+            ssize_t got = file ? pread(fileno(file), data, left, position) : -1;
+            if (got <= 0)
+            {
+                return false;
+            }
+            data += got;
+            left -= (size_t)got;
+            position += got;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Returns the number of events written so far; the next run starts there.
+     */
+    uint64_t events() const
+    {
+        return size;
+    }
+
+    /**
+     * @brief Drops all runs and gives their disk space back.
+     * @return false if the file could not be truncated.
+     */
+    bool clear()
+    {
+        size = 0;
+        return !file || ftruncate(fileno(file), 0) == 0;
+    }
+
+  private:
+    SpillFile(const SpillFile &);
+    SpillFile &operator=(const SpillFile &);
+
+    FILE *file;
+    uint64_t size;
+};
+
+/**
+ * @brief Sequential reader of one sorted run.
+ */
+class RunReader
+{
+  public:
+    RunReader(const SpillFile &spill, const Run &run, size_t buffer_events)
+        : spill(spill), offset(run.offset), remaining(run.events),
+          buffer(std::max<size_t>(1, std::min<uint64_t>(buffer_events, run.events))), position(0), filled(0),
+          failed(false)
+    {
+    }
+
+    bool next(GradeEvent &event)
+    {
+        if (position == filled)
+        {
+            if (remaining == 0)
+            {
+                return false;
+            }
+            filled = remaining < buffer.size() ? (size_t)remaining : buffer.size();
+            position = 0;
+            if (!spill.read(offset, buffer.data(), filled))
+            {
+                failed = true;
+                remaining = 0;
+                filled = 0;
+                return false;
+            }
+            offset += filled;
+            remaining -= filled;
+        }
+        event = buffer[position++];
+        return true;
+    }
+
+    /**
+     * @brief Tells whether the run could not be read to its end.
+     */
+    bool read_failed() const
+    {
+        return failed;
+    }
+
+  private:
+    const SpillFile &spill;
+    uint64_t offset;    ///< Position of the next block to read.
+    uint64_t remaining; ///< Events of the run not read into the buffer yet.
+    std::vector<GradeEvent> buffer;
+    size_t position;
+    size_t filled;
+    bool failed;
+};
+
+/** Next event of a run and the index of that run. */
+typedef std::pair<GradeEvent, size_t> Head;
+
+/**
+ * @brief Orders the merge heap so that the earliest event is on top.
+ */
+struct LaterHead
+{
+    bool operator()(const Head &a, const Head &b) const
+    {
+        return b.first < a.first;
+    }
+};
+
+/**
+ * @brief Merges sorted runs and hands every event, in order, to a consumer.
+ * @param spill File holding the runs.
+ * @param runs Runs to merge.
+ * @param count Number of runs.
+ * @param memory Memory shared by the read buffers.
+ * @param consume Called for every event.
+ * @return false if a run could not be read.
+ */
+bool merge_runs(const SpillFile &spill, const Run *runs, size_t count, size_t memory,
+                const std::function<void(const GradeEvent &)> &consume)
+{
+    size_t buffer_events = memory / count / sizeof(GradeEvent);
+    std::vector<std::unique_ptr<RunReader>> readers;
+    std::priority_queue<Head, std::vector<Head>, LaterHead> heads;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        readers.push_back(std::unique_ptr<RunReader>(new RunReader(spill, runs[i], buffer_events)));
+        GradeEvent event;
+        if (readers[i]->next(event))
+        {
+            heads.push(Head(event, i));
+        }
+    }
+    while (!heads.empty())
+    {
+        Head head = heads.top();
+        heads.pop();
+        consume(head.first);
+        if (readers[head.second]->next(head.first))
+        {
+            heads.push(head);
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (readers[i]->read_failed())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Prints the report of one student at a time while their grades stream past.
+ * @details Only the running sum and count are kept; the grades go straight into the output buffer,
+ *          so a student with any number of grades costs no memory.
+ */
+class StudentReporter
+{
+  public:
+    StudentReporter(FILE *output, size_t capacity) : out(output, capacity), student(0), sum(0), count(0), students(0)
+    {
+    }
+
+    void add(const GradeEvent &event)
+    {
+        if (count > 0 && event.student != student)
+        {
+            flush();
+        }
+        char *p = out.reserve(MAX_HEADER_LENGTH);
+        if (count == 0)
+        {
+            student = event.student;
+            p = format_literal(p, "Student ");
+            p = format_long(p, student);
+            p = format_literal(p, "\nZnámky: ");
+        }
+        else
+        {
+            *p++ = '\t';
+        }
+        out.commit(format_long(p, event.grade));
+        sum += event.grade;
+        count++;
+    }
+
+    long finish()
+    {
+        if (count > 0)
+        {
+            flush();
+        }
+        return students;
+    }
+
+  private:
+    void flush()
+    {
+        // Sums beyond an int mean grades above WORST_GRADE, which are invalid anyway.
+        unsigned char grade_class = count <= GRADE_CLASS_MAX_COUNT && sum <= INT_MAX
+                                        ? classify_grade_sum((int)sum, grade_thresholds((int)count))
+                                        : (unsigned char)GRADE_INVALID;
+        char *p = out.reserve(FORMAT_REPORT_MAX_LENGTH);
+        *p++ = '\n';
+        out.commit(format_grade_summary(p, (double)sum / count, grade_status_from_class(grade_class)));
+        sum = 0;
+        count = 0;
+        students++;
+    }
+
+    OutputBuffer out;
+    int student;
+    long long sum;   ///< Sum of the current student's grades so far.
+    long long count; ///< Number of the current student's grades so far.
+    long students;
+};
+} // namespace
+
+long u1_2_group(FILE *const *inputs, size_t input_count, FILE *output, size_t memory_limit)
+{
+    memory_limit = memory_limit < GROUP_MIN_MEMORY ? GROUP_MIN_MEMORY : memory_limit;
+    const size_t io_buffer = memory_limit / IO_SHARE;
+    const size_t work_memory = memory_limit - io_buffer;
+    const size_t run_events = work_memory / sizeof(GradeEvent);
+    const size_t fan_in = std::max<size_t>(2, work_memory / MIN_MERGE_BUFFER);
+
+    std::vector<GradeEvent> buffer;
+    buffer.reserve(run_events);
+    SpillFile spills[2];
+    SpillFile *current = &spills[0];
+    SpillFile *spare = &spills[1];
+    std::vector<Run> runs;
+    bool malformed = false;
+    bool spill_failed = false;
+    uint64_t sequence = 0;
+
+    // Sorts the buffer and appends it to the current spill file as one run.
+    auto spill_buffer = [&]() {
+        std::sort(buffer.begin(), buffer.end());
+        Run run = {current->events(), buffer.size()};
+        spill_failed = !current->append(buffer.data(), buffer.size());
+        runs.push_back(run);
+        buffer.clear();
+    };
+
+    // Run generation.
+    for (size_t f = 0; f < input_count && !malformed && !spill_failed; f++)
+    {
+        InputReader reader(inputs[f], io_buffer);
+        GradeEvent event;
+        const char *subject = NULL;
+        size_t length = 0;
+        while (!spill_failed && reader.next_int(event.student))
+        {
+            if (!reader.next_word(subject, length) || !reader.next_int(event.grade) || event.grade < 0 ||
+                event.grade > GRADEBOOK_MAX_GRADE)
+            {
+                malformed = true;
+                break;
+            }
+            event.sequence = sequence++;
+            buffer.push_back(event);
+            if (buffer.size() == run_events)
+            {
+                spill_buffer();
+            }
+        }
+        malformed = malformed || (!spill_failed && !reader.at_end());
+    }
+
+    long students = 0;
+    if (!malformed && !spill_failed && runs.empty())
+    {
+        // Everything fit into memory; no run ever reaches the disk.
+        std::sort(buffer.begin(), buffer.end());
+        StudentReporter reporter(output, io_buffer);
+        for (size_t i = 0; i < buffer.size(); i++)
+        {
+            reporter.add(buffer[i]);
+        }
+        students = reporter.finish();
+    }
+    else if (!malformed && !spill_failed)
+    {
+        if (!buffer.empty())
+        {
+            spill_buffer();
+        }
+        std::vector<GradeEvent>().swap(buffer);
+
+        // Every pass merges groups of fan_in runs into the spare file, until one merge takes all runs.
+        std::vector<GradeEvent> pending;
+        pending.reserve(io_buffer / sizeof(GradeEvent));
+        while (!spill_failed && runs.size() > fan_in)
+        {
+            std::vector<Run> merged_runs;
+            for (size_t first = 0; first < runs.size() && !spill_failed; first += fan_in)
+            {
+                Run merged = {spare->events(), 0};
+                size_t count = std::min(fan_in, runs.size() - first);
+                bool read_ok = merge_runs(*current, &runs[first], count, work_memory, [&](const GradeEvent &event) {
+                    pending.push_back(event);
+                    if (pending.size() == pending.capacity())
+                    {
+                        spill_failed = spill_failed || !spare->append(pending.data(), pending.size());
+                        pending.clear();
+                    }
+                });
+                spill_failed = spill_failed || !read_ok || !spare->append(pending.data(), pending.size());
+                pending.clear();
+                merged.events = spare->events() - merged.offset;
+                merged_runs.push_back(merged);
+            }
+            spill_failed = spill_failed || !current->clear();
+            std::swap(current, spare);
+            runs.swap(merged_runs);
+        }
+
+        if (!spill_failed)
+        {
+            StudentReporter reporter(output, io_buffer);
+            spill_failed = !merge_runs(*current, runs.data(), runs.size(), work_memory,
+                                       [&reporter](const GradeEvent &event) { reporter.add(event); });
+            students = reporter.finish();
+        }
+    }
+
+    if (malformed)
+    {
+        return -1;
+    }
+    return spill_failed ? GROUP_SPILL_FAILED : students;
+}
+
+long u1_2_group(FILE *input, FILE *output)
+{
+    return u1_2_group(&input, 1, output, GROUP_DEFAULT_MEMORY);
+}
+
+/** End of external_group.cpp */
\ No newline at end of file
@@ -0,0 +1,656 @@
+/**
+ * @file fixed_decimal.cpp
+ * @brief Implementation of the fixed-point rates and the batch converter.
+ * @details Both the rounded result and the result in tenths are floor((p + d / 2) / d) of the
+ *          exact product p in millionths, with d = 10^6 and d = 10^5. The vector kernel splits p
+ *          into units * amount, an exact 64-bit product, and micros * amount, which it divides in
+ *          double precision; doubles are turned back into integers with the 2^52 + 2^51 trick, as
+ *          AVX2 has no 64-bit conversion.
+ *
+ *          The batch kernel reads records straight from the input buffer. A record of the usual
+ *          shape is split into tokens with a few SSE2 comparisons and its digits are converted a word
+ *          at a time; anything else goes through the InputReader token parsers, so both paths accept
+ *          the same input. Numbers are written the same way, from eight digits spread over a word.
+ *
+ * @see fixed_decimal.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "fixed_decimal.h"
+#include "currency_code.h"
+#include "format.h"
+#include <string.h>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ZSP_FIXED_DECIMAL_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__)
+#define ZSP_FIXED_DECIMAL_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+/** Number of records parsed and converted together. */
+const size_t BLOCK_RECORDS = 4096;
+
+/** Number of millionths in a tenth. */
+const int32_t MICROS_PER_TENTH = FIXED_SCALE / 10;
+
+/** Number of bytes the record scanner asks the reader for at once. */
+const size_t SCAN_WINDOW = 1 << 16;
+
+/** Number of conversions formatted into one reservation of the output buffer. */
+const size_t FORMAT_GROUP_RECORDS = 64;
+
+/** Numbers below this limit are written by write_small(). */
+const uint64_t SMALL_LIMIT = 100000000;
+
+#if defined(__SIZEOF_INT128__)
+/**
+ * @brief Returns floor(numerator / denominator) for a positive denominator.
+ */
+inline int64_t floor_divide(__int128 numerator, int64_t denominator)
+{
+    __int128 quotient = numerator / denominator;
+    return (int64_t)(quotient - (numerator % denominator != 0 && numerator < 0));
+}
+#else
+inline int64_t floor_divide(int64_t numerator, int64_t denominator)
+{
+    int64_t quotient = numerator / denominator;
+    return quotient - (numerator % denominator != 0 && numerator < 0);
+}
+#endif
+
+inline bool is_space(char c)
+{
+    return c == ' ' || (unsigned)(c - '\t') <= '\r' - '\t';
+}
+
+/**
+ * @brief Reads one record from buffered bytes without a call into the reader per token.
+ * @details Gives up on a token that runs into 'limit', so every record it accepts is read exactly as
+ *          InputReader::next_word(), fixed_rate_parse() and InputReader::next_int() would read it; the
+ *          caller leaves the rest, such as the last record of a buffer, to those parsers.
+ * @return Position after the record, or NULL if the scanner did not accept it.
+ */
+const char *scan_record(const char *p, const char *limit, CurrencyInterner &interner, CurrencyCode &currency,
+                        FixedRate &rate, int32_t &count)
+{
+    const char *token[2];
+    size_t length[2];
+    for (int field = 0; field < 2; field++)
+    {
+        while (p < limit && is_space(*p))
+        {
+            p++;
+        }
+        token[field] = p;
+        while (p < limit && !is_space(*p))
+        {
+            p++;
+        }
+        length[field] = (size_t)(p - token[field]);
+        if (p == limit || length[field] > InputReader::MAX_WORD_LENGTH)
+        {
+            return NULL;
+        }
+    }
+    if (!interner.intern(token[0], length[0], currency) || !fixed_rate_parse(token[1], length[1], rate))
+    {
+        return NULL;
+    }
+
+    while (p < limit && is_space(*p))
+    {
+        p++;
+    }
+    if (p == limit)
+    {
+        return NULL;
+    }
+    unsigned negative = (unsigned)(*p == '-');
+    p += negative | (unsigned)(*p == '+');
+    const char *digits = p;
+    unsigned value = 0;
+    while (p < limit && (unsigned)(*p - '0') < 10)
+    {
+        value = value * 10 + (unsigned)(*p - '0');
+        p++;
+    }
+    if (p == digits || p == limit)
+    {
+        return NULL;
+    }
+    count = (int32_t)((value ^ (0u - negative)) + negative);
+    return p;
+}
+
+#ifdef ZSP_FIXED_DECIMAL_SSE2
+/** Bytes scan_plain_record() may read from the start of a record. */
+const size_t PLAIN_RECORD_WINDOW = 48;
+
+/**
+ * @brief Marks the whitespace bytes among 16, one bit per byte.
+ */
+inline uint32_t space_bits(__m128i bytes)
+{
+    __m128i controls = _mm_sub_epi8(bytes, _mm_set1_epi8('\t'));
+    __m128i is_control = _mm_cmpeq_epi8(_mm_min_epu8(controls, _mm_set1_epi8('\r' - '\t')), controls);
+    return (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')), is_control));
+}
+
+/**
+ * @brief Marks the decimal digits among 16 bytes, one bit per byte.
+ */
+inline uint32_t digit_bits(__m128i bytes)
+{
+    __m128i values = _mm_sub_epi8(bytes, _mm_set1_epi8('0'));
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(values, _mm_set1_epi8(9)), values));
+}
+
+/**
+ * @brief Returns the value of eight digit bytes, the first digit in the lowest byte.
+ * @details Adjacent digits are combined into pairs, pairs into quads and quads into the result,
+ *          each step with one multiplication for all lanes.
+ */
+inline uint32_t eight_digits(uint64_t bytes)
+{
+    uint64_t value = bytes & 0x0F0F0F0F0F0F0F0FULL;
+    value = (value * 10 + (value >> 8)) & 0x00FF00FF00FF00FFULL;
+    value = (value * 100 + (value >> 16)) & 0x0000FFFF0000FFFFULL;
+    return (uint32_t)((value * 10000 + (value >> 32)) & 0xFFFFFFFF);
+}
+
+/**
+ * @brief Returns the value of 1 to 8 digits at 'text'.
+ */
+inline uint32_t leading_digits(const char *text, unsigned digits)
+{
+    uint64_t bytes;
+    memcpy(&bytes, text, 8);
+    return eight_digits(bytes << (8 * (8 - digits))); // Bytes after the digits fall off the top.
+}
+
+/**
+ * @brief Reads one record of the usual shape in a few vector and word operations.
+ * @details Handles a three-letter currency, a rate with at most eight whole digits and six decimal
+ *          places and an amount of at most eight digits, all within 32 bytes. Such a record is read
+ *          as scan_record() reads it; for any other record the caller falls back to that function.
+ *          At least PLAIN_RECORD_WINDOW bytes must be readable at 'p'.
+ * @return Position after the record, or NULL if the record has another shape.
+ */
+inline const char *scan_plain_record(const char *p, CurrencyCode &currency, FixedRate &rate, int32_t &count)
+{
+    __m128i low = _mm_loadu_si128((const __m128i *)p);
+    __m128i high = _mm_loadu_si128((const __m128i *)(p + 16));
+    uint32_t spaces = space_bits(low) | space_bits(high) << 16;
+    uint32_t digits = digit_bits(low) | digit_bits(high) << 16;
+    uint32_t dots = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(low, _mm_set1_epi8('.'))) |
+                    (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(high, _mm_set1_epi8('.'))) << 16;
+
+    // A token starts at a non-space byte after a space or at 'p' and ends at the next space.
+    uint32_t starts = ~spaces & ~(~spaces << 1);
+    uint32_t ends = spaces & ~spaces << 1;
+    unsigned start[3];
+    unsigned end[3];
+    for (int field = 0; field < 3; field++)
+    {
+        if (ends == 0)
+        {
+            return NULL;
+        }
+        start[field] = (unsigned)__builtin_ctz(starts);
+        end[field] = (unsigned)__builtin_ctz(ends);
+        starts &= starts - 1;
+        ends &= ends - 1;
+    }
+    if (end[0] - start[0] != 3)
+    {
+        return NULL;
+    }
+
+    uint32_t rate_bits = ((1u << end[1]) - 1) & ~((1u << start[1]) - 1);
+    uint32_t rate_dots = dots & rate_bits;
+    unsigned dot = rate_dots ? (unsigned)__builtin_ctz(rate_dots) : end[1];
+    unsigned whole = dot - start[1];
+    unsigned decimals = rate_dots ? end[1] - dot - 1 : 0;
+    if (((digits & rate_bits) | rate_dots) != rate_bits || (rate_dots & (rate_dots - 1)) != 0 || whole > 8 ||
+        decimals > 6 || whole + decimals == 0)
+    {
+        return NULL;
+    }
+
+    unsigned sign = (unsigned)(p[start[2]] == '-' || p[start[2]] == '+');
+    unsigned amount_digits = end[2] - start[2] - sign;
+    uint32_t amount_bits = ((1u << end[2]) - 1) & ~((1u << (start[2] + sign)) - 1);
+    if ((digits & amount_bits) != amount_bits || amount_digits == 0 || amount_digits > 8)
+    {
+        return NULL;
+    }
+
+    currency_code_pack(p + start[0], 3, currency);
+    rate.units = whole ? (int32_t)leading_digits(p + start[1], whole) : 0;
+    uint64_t fraction;
+    memcpy(&fraction, p + dot + 1, 8);
+    fraction &= (1ULL << (8 * decimals)) - 1; // Missing places read as zeros.
+    rate.micros = decimals ? (int32_t)(eight_digits(fraction) / 100) : 0;
+    int32_t amount = (int32_t)leading_digits(p + start[2] + sign, amount_digits);
+    count = p[start[2]] == '-' ? -amount : amount;
+    return p + end[2];
+}
+#endif
+
+/**
+ * @brief Scans records in place until the block is full or a record is left to the token parsers.
+ * @param filled Number of records already in the block; advanced past the scanned ones.
+ * @return Position after the last scanned record.
+ */
+const char *scan_records(const char *p, const char *limit, CurrencyInterner &interner, CurrencyCode *currencies,
+                         int32_t *units, int32_t *micros, int32_t *counts, size_t &filled)
+{
+    for (; filled < BLOCK_RECORDS; filled++)
+    {
+        FixedRate rate;
+        const char *next = NULL;
+#ifdef ZSP_FIXED_DECIMAL_SSE2
+        if ((size_t)(limit - p) >= PLAIN_RECORD_WINDOW)
+        {
+            next = scan_plain_record(p, currencies[filled], rate, counts[filled]);
+        }
+#endif
+        if (!next)
+        {
+            next = scan_record(p, limit, interner, currencies[filled], rate, counts[filled]);
+        }
+        if (!next)
+        {
+            break;
+        }
+        units[filled] = rate.units;
+        micros[filled] = rate.micros;
+        p = next;
+    }
+    return p;
+}
+
+/**
+ * @brief Spreads the eight decimal digits of a number below 10^8 over the bytes of a word.
+ * @details The first digit lands in the lowest byte, where store_text() expects it. Each step
+ *          splits every lane in two with a multiplication by a reciprocal: four digits, then two,
+ *          then one.
+ */
+inline uint64_t spread_digits(uint32_t value)
+{
+    uint64_t quads = (uint64_t)(value / 10000) | (uint64_t)(value % 10000) << 32;
+    uint64_t high = ((quads * 10486) >> 20) & 0x0000007F0000007FULL;
+    uint64_t pairs = (quads - high * 100) << 16 | high;
+    uint64_t tens = ((pairs * 103) >> 10) & 0x000F000F000F000FULL;
+    return (pairs - tens * 10) << 8 | tens;
+}
+
+/**
+ * @brief Text of a number below SMALL_LIMIT, held in a register.
+ */
+struct SmallNumber
+{
+    uint64_t text; ///< ASCII digits, the first one in the lowest byte, then zero bytes.
+    size_t length; ///< Number of digits.
+};
+
+inline SmallNumber small_number(uint32_t value)
+{
+    uint64_t digits = spread_digits(value);
+    int zeros = digits ? __builtin_ctzll(digits) / 8 : 7;
+    SmallNumber number = {(digits | 0x3030303030303030ULL) >> (8 * zeros), (size_t)(8 - zeros)};
+    return number;
+}
+
+/**
+ * @brief Stores eight bytes of text held with the first byte in the lowest byte of a word.
+ */
+inline void store_text(char *p, uint64_t text)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    text = __builtin_bswap64(text);
+#endif
+    memcpy(p, &text, 8);
+}
+
+/**
+ * @brief Stores a number from small_number().
+ * @param p Write position with at least 8 free bytes.
+ */
+inline char *write_small(char *p, const SmallNumber &number)
+{
+    store_text(p, number.text);
+    return p + number.length;
+}
+
+/**
+ * @brief Writes a non-negative number like format_long().
+ * @param p Write position with at least FORMAT_INTEGER_MAX_LENGTH free bytes.
+ */
+inline char *write_unsigned(char *p, uint64_t value)
+{
+    if (value < SMALL_LIMIT)
+    {
+        return write_small(p, small_number((uint32_t)value));
+    }
+    uint64_t high = value / SMALL_LIMIT;
+    p = high < SMALL_LIMIT ? write_small(p, small_number((uint32_t)high)) : format_long(p, (long long)high);
+    store_text(p, spread_digits((uint32_t)(value % SMALL_LIMIT)) | 0x3030303030303030ULL);
+    return p + 8;
+}
+
+/**
+ * @brief Copies the text of a currency; an inline code is copied as one word.
+ * @param p Write position with at least 4 free bytes.
+ */
+inline char *write_currency(char *p, const CurrencyCode &code, const char *name, size_t length)
+{
+    if (code.tag == CURRENCY_INLINE)
+    {
+        memcpy(p, &code, sizeof(code));
+        return p + 3;
+    }
+    memcpy(p, name, length);
+    return p + length;
+}
+
+/**
+ * @brief Writes an integer like format_long().
+ * @param p Write position with at least FORMAT_INTEGER_MAX_LENGTH free bytes.
+ */
+inline char *write_long(char *p, int64_t value)
+{
+    uint64_t magnitude = (uint64_t)value;
+    if (value < 0)
+    {
+        *p++ = '-';
+        magnitude = 0 - magnitude;
+    }
+    return write_unsigned(p, magnitude);
+}
+
+/**
+ * @brief Writes one conversion as format_u1_3_conversion() lays it out.
+ * @details The rate and the amount appear twice. When both are small, as they nearly always are,
+ *          their digits are computed once and stored from registers both times.
+ * @param p Write position with at least format_conversion_max_length() free bytes.
+ * @return Position after the text.
+ */
+inline char *write_conversion(char *p, const CurrencyCode &currency, const char *name, size_t length, int32_t units,
+                              int32_t micros, int32_t count, int64_t tenths, int64_t rounded)
+{
+    int64_t rate_tenths = (int64_t)units * 10 + (micros + MICROS_PER_TENTH / 2) / MICROS_PER_TENTH;
+    uint64_t rate_whole = (uint64_t)rate_tenths / 10;
+    p = format_literal(p, "1 ");
+    p = format_literal(write_currency(p, currency, name, length), " = ");
+    if (count < 0 || (uint32_t)count >= SMALL_LIMIT || rate_whole >= SMALL_LIMIT)
+    {
+        p = format_literal(format_tenths(p, rate_tenths), " Kč\nNákup: ");
+        p = write_long(p, count);
+        *p++ = ' ';
+        p = format_literal(write_currency(p, currency, name, length), "\nCelkem: ");
+        p = format_literal(write_long(p, count), " x ");
+        p = format_literal(format_tenths(p, rate_tenths), " = ");
+    }
+    else
+    {
+        SmallNumber rate = small_number((uint32_t)rate_whole);
+        SmallNumber amount = small_number((uint32_t)count);
+        char rate_tail[2] = {'.', (char)('0' + rate_tenths % 10)};
+        p = write_small(p, rate);
+        memcpy(p, rate_tail, 2);
+        p = format_literal(p + 2, " Kč\nNákup: ");
+        p = write_small(p, amount);
+        *p++ = ' ';
+        p = format_literal(write_currency(p, currency, name, length), "\nCelkem: ");
+        p = format_literal(write_small(p, amount), " x ");
+        p = write_small(p, rate);
+        memcpy(p, rate_tail, 2);
+        p = format_literal(p + 2, " = ");
+    }
+    p = format_literal(format_tenths(p, tenths), " Kč Zaokrouhleno: ");
+    return format_literal(write_long(p, rounded), " Kč\n");
+}
+} // namespace
+
+bool fixed_rate_parse(const char *text, size_t length, FixedRate &rate)
+{
+    size_t i = 0;
+    int32_t units = 0;
+    for (; i < length && text[i] >= '0' && text[i] <= '9'; i++)
+    {
+        units = units * 10 + (text[i] - '0');
+        if (units >= FIXED_MAX_UNITS)
+        {
+            return false;
+        }
+    }
+    size_t digits = i;
+
+    int32_t micros = 0;
+    int32_t scale = FIXED_SCALE;
+    bool round_up = false;
+    if (i < length && text[i] == '.')
+    {
+        size_t first = ++i;
+        for (; i < length && text[i] >= '0' && text[i] <= '9'; i++)
+        {
+            if (scale > 1)
+            {
+                micros = micros * 10 + (text[i] - '0');
+                scale /= 10;
+            }
+            else if (i == first + 6)
+            {
+                round_up = text[i] >= '5';
+            }
+        }
+        digits += i - first;
+    }
+    if (digits == 0 || i != length)
+    {
+        return false;
+    }
+
+    micros = micros * scale + round_up;
+    if (micros == FIXED_SCALE)
+    {
+        micros = 0;
+        units++;
+    }
+    rate.units = units;
+    rate.micros = micros;
+    return units < FIXED_MAX_UNITS;
+}
+
+void fixed_convert_scalar(const int32_t *units, const int32_t *micros, const int32_t *counts, int64_t *rounded,
+                          int64_t *tenths, size_t records)
+{
+    for (size_t i = 0; i < records; i++)
+    {
+#if defined(__SIZEOF_INT128__)
+        __int128 product = (__int128)((int64_t)units[i] * FIXED_SCALE + micros[i]) * counts[i];
+        rounded[i] = floor_divide(product + FIXED_SCALE / 2, FIXED_SCALE);
+        tenths[i] = floor_divide(product + MICROS_PER_TENTH / 2, MICROS_PER_TENTH);
+#else
+        int64_t whole = (int64_t)units[i] * counts[i];
+        int64_t part = (int64_t)micros[i] * counts[i];
+        rounded[i] = whole + floor_divide(part + FIXED_SCALE / 2, FIXED_SCALE);
+        tenths[i] = whole * 10 + floor_divide(part + MICROS_PER_TENTH / 2, MICROS_PER_TENTH);
+#endif
+    }
+}
+
+#ifdef ZSP_FIXED_DECIMAL_AVX2
+__attribute__((target("avx2"))) void fixed_convert_avx2(const int32_t *units, const int32_t *micros,
+                                                          const int32_t *counts, int64_t *rounded, int64_t *tenths,
+                                                          size_t records)
+{
+    const __m256d magic = _mm256_set1_pd(6755399441055744.0); // 2^52 + 2^51
+    const __m256i magic_bits = _mm256_castpd_si256(magic);
+    const __m256d half_unit = _mm256_set1_pd(FIXED_SCALE / 2);
+    const __m256d unit = _mm256_set1_pd(FIXED_SCALE);
+    const __m256d half_tenth = _mm256_set1_pd(MICROS_PER_TENTH / 2);
+    const __m256d tenth = _mm256_set1_pd(MICROS_PER_TENTH);
+
+    size_t i = 0;
+    for (; i + 4 <= records; i += 4)
+    {
+        __m128i unit_lanes = _mm_loadu_si128((const __m128i *)(units + i));
+        __m128i micro_lanes = _mm_loadu_si128((const __m128i *)(micros + i));
+        __m128i count_lanes = _mm_loadu_si128((const __m128i *)(counts + i));
+
+        __m256i whole = _mm256_mul_epi32(_mm256_cvtepi32_epi64(unit_lanes), _mm256_cvtepi32_epi64(count_lanes));
+        __m256d part = _mm256_mul_pd(_mm256_cvtepi32_pd(micro_lanes), _mm256_cvtepi32_pd(count_lanes));
+
+        __m256d units_up = _mm256_floor_pd(_mm256_div_pd(_mm256_add_pd(part, half_unit), unit));
+        __m256d tenths_up = _mm256_floor_pd(_mm256_div_pd(_mm256_add_pd(part, half_tenth), tenth));
+        __m256i units_part = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(units_up, magic)), magic_bits);
+        __m256i tenths_part = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(tenths_up, magic)), magic_bits);
+
+        __m256i whole_tenths = _mm256_add_epi64(_mm256_slli_epi64(whole, 3), _mm256_slli_epi64(whole, 1));
+        _mm256_storeu_si256((__m256i *)(rounded + i), _mm256_add_epi64(whole, units_part));
+        _mm256_storeu_si256((__m256i *)(tenths + i), _mm256_add_epi64(whole_tenths, tenths_part));
+    }
+    fixed_convert_scalar(units + i, micros + i, counts + i, rounded + i, tenths + i, records - i);
+}
+
+namespace
+{
+bool avx2_available()
+{
+    return __builtin_cpu_supports("avx2");
+}
+} // namespace
+#else
+void fixed_convert_avx2(const int32_t *units, const int32_t *micros, const int32_t *counts, int64_t *rounded,
+                        int64_t *tenths, size_t records)
+{
+    fixed_convert_scalar(units, micros, counts, rounded, tenths, records);
+}
+
+namespace
+{
+bool avx2_available()
+{
+    return false;
+}
+} // namespace
+#endif
+
+void fixed_convert(const int32_t *units, const int32_t *micros, const int32_t *counts, int64_t *rounded,
+                   int64_t *tenths, size_t records)
+{
+    static const bool use_avx2 = avx2_available();
+    if (use_avx2)
+    {
+        fixed_convert_avx2(units, micros, counts, rounded, tenths, records);
+    }
+    else
+    {
+        fixed_convert_scalar(units, micros, counts, rounded, tenths, records);
+    }
+}
+
+char *format_tenths(char *p, int64_t tenths)
+{
+    uint64_t magnitude = (uint64_t)tenths;
+    if (tenths < 0)
+    {
+        *p++ = '-';
+        magnitude = 0 - magnitude;
+    }
+    p = write_unsigned(p, magnitude / 10);
+    *p++ = '.';
+    *p++ = (char)('0' + magnitude % 10);
+    return p;
+}
+
+long u1_3_fixed_conversions(InputReader &reader, OutputBuffer &out)
+{
+    CurrencyInterner interner;
+    std::vector<CurrencyCode> currencies(BLOCK_RECORDS);
+    std::vector<int32_t> units(BLOCK_RECORDS);
+    std::vector<int32_t> micros(BLOCK_RECORDS);
+    std::vector<int32_t> counts(BLOCK_RECORDS);
+    std::vector<int64_t> rounded(BLOCK_RECORDS);
+    std::vector<int64_t> tenths(BLOCK_RECORDS);
+
+    long records = 0;
+    bool wellformed = true;
+    for (;;)
+    {
+        size_t filled = 0;
+        const char *word = NULL;
+        size_t length = 0;
+        while (filled < BLOCK_RECORDS)
+        {
+            const char *bytes = NULL;
+            size_t available = reader.peek(bytes, SCAN_WINDOW);
+            const char *end = scan_records(bytes, bytes + available, interner, currencies.data(), units.data(),
+                                           micros.data(), counts.data(), filled);
+            reader.consume((size_t)(end - bytes));
+            if (filled == BLOCK_RECORDS || !reader.next_word(word, length))
+            {
+                break;
+            }
+
+            // The scanner stopped at the end of the buffer or at a record it does not read itself.
+            // Every word is consumed before the next token is read; a refill may move it.
+            FixedRate rate;
+            int count = 0;
+            if (!interner.intern(word, length, currencies[filled]) || !reader.next_word(word, length) ||
+                !fixed_rate_parse(word, length, rate) || !reader.next_int(count))
+            {
+                wellformed = false;
+                break;
+            }
+            units[filled] = rate.units;
+            micros[filled] = rate.micros;
+            counts[filled] = count;
+            filled++;
+        }
+
+        fixed_convert(units.data(), micros.data(), counts.data(), rounded.data(), tenths.data(), filled);
+
+        // Records are formatted in groups so that the buffer is checked once per group.
+        const size_t record_bound = format_conversion_max_length(InputReader::MAX_WORD_LENGTH);
+        for (size_t i = 0; i < filled;)
+        {
+            size_t group_end = filled - i < FORMAT_GROUP_RECORDS ? filled : i + FORMAT_GROUP_RECORDS;
+            char *p = out.reserve(FORMAT_GROUP_RECORDS * record_bound);
+            for (; i < group_end; i++)
+            {
+                const char *name = interner.text(currencies[i], length);
+                p = write_conversion(p, currencies[i], name, length, units[i], micros[i], counts[i], tenths[i],
+                                     rounded[i]);
+            }
+            out.commit(p);
+        }
+        records += (long)filled;
+        if (!wellformed || filled < BLOCK_RECORDS)
+        {
+            break;
+        }
+    }
+
+    return wellformed ? records : -1;
+}
+
+long u1_3_fixed_batch(FILE *input, FILE *output)
+{
+    InputReader reader(input);
+    OutputBuffer out(output);
+    return u1_3_fixed_conversions(reader, out);
+}
+
+/** End of fixed_decimal.cpp */
\ No newline at end of file
@@ -0,0 +1,257 @@
+/**
+ * @file format.cpp
+ * @brief Implementation of the printf-free formatters.
+ * @details Integers are converted from the least significant end, two digits per division, using a
+ *          table of all pairs "00" to "99". Fixed-point numbers are scaled to an integer number of
+ *          hundredths or tenths; only when the scaled value lies within rounding error of a tie is
+ *          the exact product checked with a fused multiply-add, so the result always agrees with
+ *          the correctly rounded output of glibc's `printf`.
+ *
+ * @see format.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "format.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+namespace
+{
+/** The decimal digits of 0 to 99, two characters each. */
+const char DIGIT_PAIRS[] = "00010203040506070809"
+                           "10111213141516171819"
+                           "20212223242526272829"
+                           "30313233343536373839"
+                           "40414243444546474849"
+                           "50515253545556575859"
+                           "60616263646566676869"
+                           "70717273747576777879"
+                           "80818283848586878889"
+                           "90919293949596979899";
+
+/** Scaled values below this bound are exact integers, and so are their ties. */
+const double EXACT_LIMIT = 4503599627370496.0; // 2^52
+
+/** Relative distance from a tie below which the product is checked exactly; twice the rounding error. */
+const double TIE_MARGIN = 2.220446049250313e-16; // 2^-52
+
+/**
+ * @brief Returns the number of decimal digits of a value.
+ * @param value Value to measure.
+ * @return Number of digits, at least 1.
+ */
+inline int digit_count(uint64_t value)
+{
+    int digits = 1;
+    for (;;)
+    {
+        if (value < 10)
+        {
+            return digits;
+        }
+        if (value < 100)
+        {
+            return digits + 1;
+        }
+        if (value < 1000)
+        {
+            return digits + 2;
+        }
+        if (value < 10000)
+        {
+            return digits + 3;
+        }
+        value /= 10000;
+        digits += 4;
+    }
+}
+
+/**
+ * @brief Writes exactly 'digits' decimal digits of a value, padding with zeros.
+ * @param p Write position.
+ * @param value Value to write; must have at most 'digits' digits.
+ * @param digits Number of digits to write.
+ * @return Position after the digits.
+ */
+inline char *write_digits(char *p, uint64_t value, int digits)
+{
+    char *end = p + digits;
+    char *q = end;
+    while (value >= 100)
+    {
+        unsigned pair = (unsigned)(value % 100);
+        value /= 100;
+        q -= 2;
+        memcpy(q, DIGIT_PAIRS + 2 * pair, 2);
+    }
+    if (value >= 10)
+    {
+        q -= 2;
+        memcpy(q, DIGIT_PAIRS + 2 * value, 2);
+    }
+    else if (q > p)
+    {
+        *--q = (char)('0' + value);
+    }
+    while (q > p)
+    {
+        *--q = '0';
+    }
+    return end;
+}
+
+inline char *write_unsigned(char *p, uint64_t value)
+{
+    return write_digits(p, value, digit_count(value));
+}
+} // namespace
+
+char *format_long(char *p, long long value)
+{
+    uint64_t magnitude = (uint64_t)value;
+    if (value < 0)
+    {
+        *p++ = '-';
+        magnitude = 0 - magnitude;
+    }
+    return write_unsigned(p, magnitude);
+}
+
+uint64_t round_fixed(double value, int decimals)
+{
+    const unsigned scale = decimals == 1 ? 10 : 100;
+    double magnitude = fabs(value);
+    double scaled = magnitude * scale;
+    if (!(scaled < EXACT_LIMIT))
+    {
+        return scaled < 18446744073709551616.0 ? (uint64_t)scaled : UINT64_MAX;
+    }
+
+    // 'scaled' carries at most half an ulp of error, so unless it is that close to a tie the
+    // fraction decides the rounding; otherwise the exact product is compared with the tie.
+    double whole = floor(scaled);
+    double fraction = scaled - whole;
+    uint64_t units = (uint64_t)whole;
+    if (fabs(fraction - 0.5) > scaled * TIE_MARGIN)
+    {
+        units += fraction > 0.5;
+    }
+    else
+    {
+        double above_tie = fma(magnitude, (double)scale, -(whole + 0.5));
+        units += above_tie > 0 || (above_tie == 0 && (units & 1));
+    }
+    return units;
+}
+
+char *format_fixed(char *p, double value, int decimals)
+{
+    const unsigned scale = decimals == 1 ? 10 : 100;
+    if (!(fabs(value) * scale < EXACT_LIMIT))
+    {
+        // Infinities, NaN and huge values; also keeps the fast path free of overflow checks.
+        return p + snprintf(p, FORMAT_FIXED_MAX_LENGTH, decimals == 1 ? "%.1f" : "%.2f", value);
+    }
+
+    uint64_t units = round_fixed(value, decimals);
+    if (signbit(value))
+    {
+        *p++ = '-';
+    }
+    p = write_unsigned(p, units / scale);
+    *p++ = '.';
+    return write_digits(p, units % scale, decimals);
+}
+
+char *format_receipt_item(char *p, int count, int price, int gross, long long net_total, long long gross_total,
+                          int percent)
+{
+    p = format_literal(p, "Cena bez DPH/ks ");
+    p = format_long(p, price);
+    p = format_literal(p, " Kč\tCena s DPH/ks ");
+    p = format_long(p, gross);
+    p = format_literal(p, " Kč\nPočet kusů: ");
+    p = format_long(p, count);
+    p = format_literal(p, "\tCena bez DPH ");
+    p = format_long(p, net_total);
+    p = format_literal(p, " Kč\tCena s DPH (");
+    p = format_long(p, percent);
+    p = format_literal(p, " %) ");
+    p = format_long(p, gross_total);
+    return format_literal(p, " Kč\n");
+}
+
+char *format_u1_1_receipt(char *p, int count, int price, int gross, long long net_total, long long gross_total,
+                          int percent)
+{
+    p = format_literal(p, "Účtenka\n");
+    return format_receipt_item(p, count, price, gross, net_total, gross_total, percent);
+}
+
+char *format_u1_1_receipt(char *p, int count, int price, int gross, int percent)
+{
+    p = format_literal(p, "Účtenka\n");
+    return format_receipt_item(p, count, price, gross, (long long)price * count, (long long)gross * count, percent);
+}
+
+char *format_grade_summary(char *p, double average_grade, const GradeStatus &status)
+{
+    p = format_fixed(p, average_grade, 2);
+    p = format_literal(p, "\nProspěl s vyznamenáním: ");
+    p = status.distinction ? format_literal(p, "1:Ano\n") : format_literal(p, "0:Ne\n");
+    p = format_literal(p, "Prospěl: ");
+    p = status.passed ? format_literal(p, "1:Ano\n") : format_literal(p, "0:Ne\n");
+    p = format_literal(p, "Neprospěl: ");
+    return status.failed ? format_literal(p, "1:Ano\n") : format_literal(p, "0:Ne\n");
+}
+
+char *format_u1_2_report(char *p, const int *grades, double average_grade, const GradeStatus &status)
+{
+    p = format_literal(p, "Známky: ");
+    for (int i = 0; i < 5; i++)
+    {
+        p = format_long(p, grades[i]);
+        *p++ = i < 4 ? '\t' : '\n';
+    }
+    return format_grade_summary(p, average_grade, status);
+}
+
+char *format_grade_report(char *p, const unsigned char *grades, size_t count, double average_grade,
+                          const GradeStatus &status)
+{
+    p = format_literal(p, "Známky: ");
+    for (size_t i = 0; i < count; i++)
+    {
+        p = write_unsigned(p, grades[i]);
+        *p++ = i + 1 < count ? '\t' : '\n';
+    }
+    return format_grade_summary(p, average_grade, status);
+}
+
+char *format_u1_3_conversion(char *p, const char *currency, size_t length, double currency_value, int count,
+                             int rounded_result)
+{
+    p = format_literal(p, "1 ");
+    memcpy(p, currency, length);
+    p += length;
+    p = format_literal(p, " = ");
+    p = format_fixed(p, currency_value, 1);
+    p = format_literal(p, " Kč\nNákup: ");
+    p = format_long(p, count);
+    *p++ = ' ';
+    memcpy(p, currency, length);
+    p += length;
+    p = format_literal(p, "\nCelkem: ");
+    p = format_long(p, count);
+    p = format_literal(p, " x ");
+    p = format_fixed(p, currency_value, 1);
+    p = format_literal(p, " = ");
+    p = format_fixed(p, count * currency_value, 1);
+    p = format_literal(p, " Kč Zaokrouhleno: ");
+    p = format_long(p, rounded_result);
+    return format_literal(p, " Kč\n");
+}
+
+/** End of format.cpp */
\ No newline at end of file
@@ -40,13 +40,20 @@
  */
 
 #include "functions.h"
+#include "compute.h"
+#include "currency_code.h"
+#include "format.h"
+#include <string.h>
+#include <vector>
 
 /**
  * @brief Calculates purchase prices with and without VAT.
  *
  * @details This function takes the number of items and price per item as input and calculates
  *          the total cost both with and without VAT. The VAT rate is set at 20%. It's designed to
- *          demonstrate basic arithmetic operations and input handling in C.
+ *          demonstrate basic arithmetic operations and input handling in C. The receipt is priced
+ *          and formatted by compute_receipt() and receipt_text() from compute.h; this function only
+ *          reads the record and prints the text.
  *
  *          Example:
  *          If the user inputs 5 items each costing 100 units, the function will output
@@ -66,33 +73,44 @@
  * }
  * @endcode
  *
- * @todo Refine the rounding logic for VAT calculation to handle edge cases.
- *
  * @warning Ensure that the input values for 'count' and 'price' are non-negative to avoid
  *          incorrect calculations.
  */
 
 void u1_1()
 {
-    const double VAT = 1.2;
+    ReceiptRecord record = {0, 0, 20};
+    scanf("%d %d", &record.count, &record.price);
 
-    int count = 0;
-    int price = 0;
-    int price_w_vat = 0;
-    scanf("%d %d", &count, &price);
+    Receipt receipt;
+    compute_receipt(record, receipt);
 
-    if (price * VAT - (int)(price * VAT) >= 0.5)
-    {
-        price_w_vat = (int)(price * VAT) + 1;
-    }
-    else
-    {
-        price_w_vat = (int)(price * VAT);
-    }
+    char text[FORMAT_RECEIPT_MAX_LENGTH];
+    fwrite(text, 1, receipt_text(record, receipt, text, sizeof(text)), stdout);
+}
+
+const int BEST_GRADE = 1;
+const int WORST_GRADE = 5;
+const double PASS_BORDER = 4.00;
+const double DISTINCTION_BORDER = 1.50;
 
-    printf("Účtenka\n");
-    printf("Cena bez DPH/ks %d Kč\tCena s DPH/ks %d Kč\n", price, price_w_vat);
-    printf("Počet kusů: %d\tCena bez DPH %d Kč\tCena s DPH (20 %%) %d Kč\n", count, price * count, price_w_vat * count);
+/**
+ * @brief Categorizes an average grade.
+ *
+ * @details Applies the borders of u1_2: pass with distinction for an average between 1 and 1.50,
+ *          pass for an average between 1 and 4.00, fail for an average above 4.00 up to 5. An average
+ *          outside 1-5 sets none of the flags.
+ *
+ * @param average_grade Average of the student's grades.
+ * @return The three status flags.
+ */
+GradeStatus grade_status(double average_grade)
+{
+    GradeStatus status;
+    status.distinction = average_grade >= BEST_GRADE && average_grade <= DISTINCTION_BORDER;
+    status.passed = average_grade >= BEST_GRADE && average_grade <= PASS_BORDER;
+    status.failed = average_grade > PASS_BORDER && average_grade <= WORST_GRADE;
+    return status;
 }
 
 /**
@@ -128,58 +146,32 @@ void u1_1()
 
 void u1_2()
 {
-    const int BEST_GRADE = 1;
-    const int WORST_GRADE = 5;
-    const double PASS_BORDER = 4.00;
-    const double DISTINCTION_BORDER = 1.50;
-
-    int grades[5] = {0, 0, 0, 0, 0};
+    GradeRecord record = {{0, 0, 0, 0, 0}};
+    int *grades = record.grades;
     scanf("%d %d %d %d %d", &grades[0], &grades[1], &grades[2], &grades[3], &grades[4]);
 
-    printf("Známky: %d\t%d\t%d\t%d\t%d\n", grades[0], grades[1], grades[2], grades[3], grades[4]);
-
-    double average_grade = 0;
-    for (int i = 0; i < 5; i++)
-    {
-        average_grade += grades[i];
-    }
-    average_grade /= 5;
-    printf("%.2f\n", average_grade);
+    GradeReport report = compute_grade_report(record);
 
-    if (average_grade < BEST_GRADE && average_grade > WORST_GRADE)
-    {
-        printf("ERROR\n");
-    }
-
-    printf("Prospěl s vyznamenáním: ");
-    if (average_grade >= BEST_GRADE && average_grade <= DISTINCTION_BORDER)
-    {
-        printf("1:Ano\n");
-    }
-    else
-    {
-        printf("0:Ne\n");
-    }
-
-    printf("Prospěl: ");
-    if (average_grade >= BEST_GRADE && average_grade <= PASS_BORDER)
-    {
-        printf("1:Ano\n");
-    }
-    else
-    {
-        printf("0:Ne\n");
-    }
+    char text[FORMAT_REPORT_MAX_LENGTH];
+    fwrite(text, 1, grade_report_text(record, report, text, sizeof(text)), stdout);
+}
 
-    printf("Neprospěl: ");
-    if (average_grade > PASS_BORDER && average_grade <= WORST_GRADE)
-    {
-        printf("1:Ano\n");
-    }
-    else
+/**
+ * @brief Rounds a value to a whole number according to mathematical rules.
+ *
+ * @details A fractional part of 0.5 or more rounds up. The integer part is obtained by truncation,
+ *          so negative values are effectively truncated towards zero, which is what u1_3 always did.
+ *
+ * @param value Value to round; must fit into an int.
+ * @return The rounded value.
+ */
+int round_half_up(double value)
+{
+    if (value - (int)value >= 0.5)
     {
-        printf("0:Ne\n");
+        return (int)value + 1;
     }
+    return (int)value;
 }
 
 /**
@@ -215,25 +207,23 @@ void u1_2()
  */
 void u1_3()
 {
-    char currency_name[256] = {0}; // Initialize the array with zeros
+    char currency_name[256]; // Only the terminator needs initialising; scanf writes the rest
+    currency_name[0] = '\0';
     double currency_value = 0;
     int count = 0;
-    scanf("%s %lf %d", currency_name, &currency_value, &count);
-
-    int rounded_result = 0;
-    if (currency_value * count - (int)(currency_value * count) >= 0.5)
-    {
-        rounded_result = (int)(currency_value * count) + 1;
-    }
-    else
-    {
-        rounded_result = (int)(currency_value * count);
-    }
-
-    printf("1 %s = %.1f Kč\n", currency_name, currency_value);
-    printf("Nákup: %d %s\n", count, currency_name);
-    printf("Celkem: %d x %.1f = %.1f Kč Zaokrouhleno: %d Kč\n", count, currency_value, count * currency_value,
-           rounded_result);
+    scanf("%255s %lf %d", currency_name, &currency_value, &count);
+
+    // The name travels as a CurrencyCode like in the batch modes: three-letter codes are packed
+    // inline, other words are interned, and the text for the output comes back from the code.
+    CurrencyInterner interner;
+    CurrencyCode code;
+    interner.intern(currency_name, strlen(currency_name), code);
+    size_t length = 0;
+    const char *name = interner.text(code, length);
+
+    ExchangeRecord record = {name, length, currency_value, count};
+    std::vector<char> text(format_conversion_max_length(record.length));
+    fwrite(&text[0], 1, exchange_text(record, compute_exchange(record), &text[0], text.size()), stdout);
 }
 
 /** End of functions.cpp */
\ No newline at end of file
@@ -0,0 +1,122 @@
+/**
+ * @file grade_class.cpp
+ * @brief Implementation of the branchless grade classification kernels.
+ * @details Each comparison yields 0 or 1 (scalar) or an all-zeros/all-ones lane (AVX2); the class
+ *          byte is assembled from them with ands, ors and shifts. Nothing depends on the data, so
+ *          the loop runs at the same speed whatever the distribution of grades is. The thresholds
+ *          of a lane are derived from its count with a shift and additions only.
+ *
+ * @see grade_class.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "grade_class.h"
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ZSP_GRADE_CLASS_AVX2 1
+#include <immintrin.h>
+#endif
+
+unsigned char classify_grade_sum(int sum, const GradeThresholds &thresholds)
+{
+    unsigned valid = (unsigned)(sum >= thresholds.min_sum) & (unsigned)(sum <= thresholds.max_sum) &
+                     (unsigned)(thresholds.min_sum > 0);
+    unsigned distinction = valid & (unsigned)(sum <= thresholds.distinction_sum);
+    unsigned passed = valid & (unsigned)(sum <= thresholds.pass_sum);
+    unsigned failed = valid & (unsigned)(sum > thresholds.pass_sum);
+    return (unsigned char)(distinction | passed << 1 | failed << 2 | (valid ^ 1) << 3);
+}
+
+void classify_grade_sums(const int *sums, int count, unsigned char *classes, size_t students)
+{
+    const GradeThresholds thresholds = grade_thresholds(count);
+    for (size_t i = 0; i < students; i++)
+    {
+        classes[i] = classify_grade_sum(sums[i], thresholds);
+    }
+}
+
+void classify_grade_sums_scalar(const int *sums, const int *counts, unsigned char *classes, size_t students)
+{
+    for (size_t i = 0; i < students; i++)
+    {
+        classes[i] = classify_grade_sum(sums[i], grade_thresholds(counts[i]));
+    }
+}
+
+#ifdef ZSP_GRADE_CLASS_AVX2
+__attribute__((target("avx2"))) void classify_grade_sums_avx2(const int *sums, const int *counts,
+                                                                unsigned char *classes, size_t students)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+
+    size_t i = 0;
+    for (; i + 8 <= students; i += 8)
+    {
+        __m256i sum = _mm256_loadu_si256((const __m256i *)(sums + i));
+        __m256i count = _mm256_loadu_si256((const __m256i *)(counts + i));
+        __m256i distinction_sum = _mm256_add_epi32(count, _mm256_srli_epi32(count, 1));
+        __m256i pass_sum = _mm256_slli_epi32(count, 2);
+        __m256i max_sum = _mm256_add_epi32(pass_sum, count);
+
+        // valid = count > 0 && sum >= count && sum <= max_sum, all as lane masks.
+        __m256i invalid = _mm256_or_si256(_mm256_cmpgt_epi32(count, sum), _mm256_cmpgt_epi32(sum, max_sum));
+        invalid = _mm256_or_si256(invalid, _mm256_cmpeq_epi32(count, zero));
+        __m256i above_pass = _mm256_cmpgt_epi32(sum, pass_sum);
+        __m256i above_distinction = _mm256_cmpgt_epi32(sum, distinction_sum);
+
+        __m256i distinction = _mm256_andnot_si256(_mm256_or_si256(invalid, above_distinction), one);
+        __m256i passed = _mm256_slli_epi32(_mm256_andnot_si256(_mm256_or_si256(invalid, above_pass), one), 1);
+        __m256i failed = _mm256_slli_epi32(_mm256_andnot_si256(invalid, _mm256_and_si256(above_pass, one)), 2);
+        __m256i invalid_bit = _mm256_slli_epi32(_mm256_and_si256(invalid, one), 3);
+        __m256i lanes = _mm256_or_si256(_mm256_or_si256(distinction, passed), _mm256_or_si256(failed, invalid_bit));
+
+        // Narrow the eight 32-bit lanes to bytes; packing works per 128-bit half.
+        __m256i bytes = _mm256_packus_epi16(_mm256_packs_epi32(lanes, lanes), zero);
+        int low = _mm_cvtsi128_si32(_mm256_castsi256_si128(bytes));
+        int high = _mm_cvtsi128_si32(_mm256_extracti128_si256(bytes, 1));
+        memcpy(classes + i, &low, 4);
+        memcpy(classes + i + 4, &high, 4);
+    }
+    classify_grade_sums_scalar(sums + i, counts + i, classes + i, students - i);
+}
+
+namespace
+{
+bool avx2_available()
+{
+    return __builtin_cpu_supports("avx2");
+}
+} // namespace
+#else
+void classify_grade_sums_avx2(const int *sums, const int *counts, unsigned char *classes, size_t students)
+{
+    classify_grade_sums_scalar(sums, counts, classes, students);
+}
+
+namespace
+{
+bool avx2_available()
+{
+    return false;
+}
+} // namespace
+#endif
+
+void classify_grade_sums(const int *sums, const int *counts, unsigned char *classes, size_t students)
+{
+    static const bool use_avx2 = avx2_available();
+    if (use_avx2)
+    {
+        classify_grade_sums_avx2(sums, counts, classes, students);
+    }
+    else
+    {
+        classify_grade_sums_scalar(sums, counts, classes, students);
+    }
+}
+
+/** End of grade_class.cpp */
\ No newline at end of file
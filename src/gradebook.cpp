@@ -0,0 +1,191 @@
+/**
+ * @file gradebook.cpp
+ * @brief Implementation of the columnar gradebook.
+ * @details The grades of one student are summed sixteen at a time: a 16-byte load is masked down to
+ *          the bytes that belong to the student and reduced with `psadbw`, which adds eight bytes
+ *          into each 64-bit half in a single instruction. Students with at most sixteen grades, the
+ *          common case, take one load and one reduction each. The last student of the column falls
+ *          back to scalar code whenever a full load would read past the end of the column.
+ *
+ * @see gradebook.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "gradebook.h"
+#include "format.h"
+#include "grade_class.h"
+
+#if defined(__SSE2__)
+#define ZSP_GRADEBOOK_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+inline int sum_scalar(const unsigned char *grades, size_t count)
+{
+    int sum = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        sum += grades[i];
+    }
+    return sum;
+}
+} // namespace
+
+void gradebook_clear(Gradebook &book)
+{
+    book.grades.clear();
+    book.offsets.resize(1);
+}
+
+void gradebook_sums_scalar(const Gradebook &book, int *sums)
+{
+    size_t students = gradebook_students(book);
+    for (size_t i = 0; i < students; i++)
+    {
+        sums[i] = sum_scalar(book.grades.data() + book.offsets[i], book.offsets[i + 1] - book.offsets[i]);
+    }
+}
+
+#ifdef ZSP_GRADEBOOK_SSE2
+void gradebook_sums(const Gradebook &book, int *sums)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lane_index = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const unsigned char *column = book.grades.data();
+    const size_t column_size = book.grades.size();
+
+    size_t students = gradebook_students(book);
+    for (size_t i = 0; i < students; i++)
+    {
+        size_t position = book.offsets[i];
+        size_t end = book.offsets[i + 1];
+
+        __m128i total = zero;
+        for (; position + 16 <= end; position += 16)
+        {
+            __m128i block = _mm_loadu_si128((const __m128i *)(column + position));
+            total = _mm_add_epi64(total, _mm_sad_epu8(block, zero));
+        }
+
+        size_t remaining = end - position;
+        int tail = 0;
+        if (remaining > 0 && position + 16 <= column_size)
+        {
+            __m128i block = _mm_loadu_si128((const __m128i *)(column + position));
+            __m128i keep = _mm_cmplt_epi8(lane_index, _mm_set1_epi8((char)remaining));
+            total = _mm_add_epi64(total, _mm_sad_epu8(_mm_and_si128(block, keep), zero));
+        }
+        else
+        {
+            tail = sum_scalar(column + position, remaining);
+        }
+
+        total = _mm_add_epi64(total, _mm_unpackhi_epi64(total, total));
+        sums[i] = _mm_cvtsi128_si32(total) + tail;
+    }
+}
+#else
+void gradebook_sums(const Gradebook &book, int *sums)
+{
+    gradebook_sums_scalar(book, sums);
+}
+#endif
+
+void gradebook_counts(const Gradebook &book, int *counts)
+{
+    size_t students = gradebook_students(book);
+    for (size_t i = 0; i < students; i++)
+    {
+        counts[i] = (int)(book.offsets[i + 1] - book.offsets[i]);
+    }
+}
+
+void gradebook_averages(const int *sums, const int *counts, double *averages, size_t students)
+{
+    for (size_t i = 0; i < students; i++)
+    {
+        averages[i] = counts[i] > 0 ? (double)sums[i] / counts[i] : 0;
+    }
+}
+
+bool gradebook_read(InputReader &reader, Gradebook &book, size_t max_students)
+{
+    int grade = 0;
+    while (gradebook_students(book) < max_students && reader.next_int(grade))
+    {
+        size_t count = 0;
+        do
+        {
+            if (grade < 0 || grade > GRADEBOOK_MAX_GRADE || count == GRADEBOOK_MAX_GRADES)
+            {
+                book.grades.resize(book.offsets.back());
+                return false;
+            }
+            book.grades.push_back((unsigned char)grade);
+            count++;
+        } while (reader.next_int_on_line(grade));
+        if (!reader.at_line_end())
+        {
+            // The rest of the line is not a grade: reject the whole student, not just the tail.
+            book.grades.resize(book.offsets.back());
+            return false;
+        }
+        book.offsets.push_back(book.grades.size());
+    }
+    return true;
+}
+
+long u1_2_gradebook_reports(InputReader &reader, OutputBuffer &out)
+{
+    const size_t MAX_REPORT_LENGTH = format_grade_report_max_length(GRADEBOOK_MAX_GRADES);
+
+    Gradebook book;
+    std::vector<int> sums(GRADEBOOK_BLOCK_STUDENTS);
+    std::vector<int> counts(GRADEBOOK_BLOCK_STUDENTS);
+    std::vector<double> averages(GRADEBOOK_BLOCK_STUDENTS);
+    std::vector<unsigned char> classes(GRADEBOOK_BLOCK_STUDENTS);
+
+    long students = 0;
+    for (;;)
+    {
+        gradebook_clear(book);
+        bool wellformed = gradebook_read(reader, book, GRADEBOOK_BLOCK_STUDENTS);
+
+        size_t block = gradebook_students(book);
+        gradebook_sums(book, sums.data());
+        gradebook_counts(book, counts.data());
+        gradebook_averages(sums.data(), counts.data(), averages.data(), block);
+        classify_grade_sums(sums.data(), counts.data(), classes.data(), block);
+        for (size_t i = 0; i < block; i++)
+        {
+            const unsigned char *grades = book.grades.data() + book.offsets[i];
+            char *p = out.reserve(MAX_REPORT_LENGTH);
+            out.commit(format_grade_report(p, grades, (size_t)counts[i], averages[i],
+                                           grade_status_from_class(classes[i])));
+        }
+        students += (long)block;
+
+        if (!wellformed)
+        {
+            return -1;
+        }
+        if (block < GRADEBOOK_BLOCK_STUDENTS)
+        {
+            break;
+        }
+    }
+
+    return reader.at_end() ? students : -1;
+}
+
+long u1_2_gradebook(FILE *input, FILE *output)
+{
+    InputReader reader(input);
+    OutputBuffer out(output);
+    return u1_2_gradebook_reports(reader, out);
+}
+
+/** End of gradebook.cpp */
\ No newline at end of file
@@ -0,0 +1,94 @@
+/**
+ * @file arena.h
+ * @brief Bump-pointer arena for short-lived per-receipt allocations.
+ * @details Everything a basket receipt needs while it is being built (its line arrays and its
+ *          formatted text) is carved out of an Arena and released all at once with reset(). The
+ *          arena keeps its memory between resets, so once it has grown to the size of the largest
+ *          receipt the hot path performs no `malloc` or `free` at all.
+ *
+ * @see arena.cpp for the implementation.
+ * @see basket.h for the receipt engine using it.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_ARENA_H
+#define ZSP_ARENA_H
+#include <stddef.h>
+
+/**
+ * @class Arena
+ * @brief Allocates memory by advancing a pointer inside large blocks.
+ *
+ * @details When the current block is exhausted a new, larger block is chained in. reset() releases
+ *          all allocations; if more than one block was in use, they are replaced by a single block
+ *          large enough for all of them, so the next receipt of the same size fits without growing.
+ */
+class Arena
+{
+  public:
+    /**
+     * @brief Creates an arena.
+     * @param initial_size Size of the first block in bytes.
+     */
+    explicit Arena(size_t initial_size = 64 * 1024);
+    ~Arena();
+
+    /**
+     * @brief Allocates uninitialised memory.
+     * @param size Number of bytes.
+     * @param alignment Required alignment, a power of two.
+     * @return Pointer valid until the next reset() or the destruction of the arena.
+     */
+    void *allocate(size_t size, size_t alignment = sizeof(void *));
+
+    /**
+     * @brief Allocates an uninitialised array.
+     * @tparam T Element type; must be trivially destructible, destructors are never run.
+     * @param count Number of elements.
+     * @return Pointer to the first element.
+     */
+    template <typename T>
+    T *allocate_array(size_t count)
+    {
+        return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * @brief Releases all allocations at once and keeps the memory for reuse.
+     */
+    void reset();
+
+    /**
+     * @brief Returns the number of bytes handed out since the last reset().
+     * @return Allocated bytes, including alignment padding.
+     */
+    size_t used() const;
+
+    /**
+     * @brief Returns the total size of all blocks owned by the arena.
+     * @return Capacity in bytes.
+     */
+    size_t capacity() const;
+
+  private:
+    Arena(const Arena &);
+    Arena &operator=(const Arena &);
+
+    struct Block
+    {
+        Block *previous;
+        size_t size;
+    };
+
+    Block *new_block(size_t size);
+
+    Block *current;
+    char *position;
+    char *limit;
+    size_t used_before_current;
+};
+
+#endif // ZSP_ARENA_H
+
+/** End of arena.h */
\ No newline at end of file
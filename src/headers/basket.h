@@ -0,0 +1,85 @@
+/**
+ * @file basket.h
+ * @brief Multi-line basket receipts built on the u1_1 pricing logic.
+ * @details A receipt from u1_1 has exactly one line item. A basket has any number of lines, each with
+ *          its own VAT rate class, and its receipt ends with a subtotal for every rate that occurs
+ *          and a grand total. Every line is printed exactly like the item part of a u1_1 receipt:
+ *
+ *              Účtenka
+ *              Cena bez DPH/ks 100 Kč<tab>Cena s DPH/ks 121 Kč
+ *              Počet kusů: 2<tab>Cena bez DPH 200 Kč<tab>Cena s DPH (21 %) 242 Kč
+ *              ...
+ *              DPH 21 %: Cena bez DPH 200 Kč<tab>Cena s DPH 242 Kč
+ *              Celkem bez DPH 200 Kč<tab>Celkem s DPH 242 Kč
+ *
+ *          All working storage of a receipt, the line arrays as well as the formatted text, comes from
+ *          an Arena that the caller resets between receipts.
+ *
+ * @see basket.cpp for the implementation.
+ * @see vat.h for the pricing kernels.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_BASKET_H
+#define ZSP_BASKET_H
+#include "arena.h"
+#include "vat.h"
+#include <stdio.h>
+
+/**
+ * @brief Line items of one basket in structure-of-arrays form.
+ */
+struct Basket
+{
+    size_t lines;         ///< Number of line items.
+    int *counts;          ///< Number of pieces of every line.
+    int *prices;          ///< Unit price without VAT of every line.
+    unsigned char *rates; ///< VatRate class of every line.
+};
+
+/**
+ * @brief Priced basket with its formatted receipt.
+ */
+struct BasketReceipt
+{
+    const char *text;                ///< Receipt text, not NUL-terminated; lives in the arena.
+    size_t length;                   ///< Length of the text in bytes.
+    long long net[VAT_RATE_COUNT];   ///< Subtotal without VAT per rate class.
+    long long gross[VAT_RATE_COUNT]; ///< Subtotal with VAT per rate class.
+    long long total_net;             ///< Grand total without VAT.
+    long long total_gross;           ///< Grand total with VAT.
+};
+
+/**
+ * @brief Allocates the line arrays of a basket in the arena.
+ * @param arena Arena of the current receipt.
+ * @param lines Number of line items.
+ * @return Basket with uninitialised line arrays.
+ */
+Basket basket_allocate(Arena &arena, size_t lines);
+
+/**
+ * @brief Prices a basket and formats its receipt.
+ * @param basket Line items; the prices must be within vat_rate_max_price() of their class.
+ * @param arena Arena of the current receipt; receives the gross prices and the text.
+ * @param receipt Receives the totals and the text.
+ */
+void basket_price(const Basket &basket, Arena &arena, BasketReceipt &receipt);
+
+/**
+ * @brief Prints a receipt for every basket in the input.
+ *
+ * @details A basket starts with a line holding its number of line items, followed by one line per
+ *          item in the u1_1 batch format: `count price [rate]`, where the optional rate is given in
+ *          percent. One arena is reused for all baskets.
+ *
+ * @param input Stream with the baskets.
+ * @param output Stream the receipts are written to.
+ * @return Number of processed baskets, or -1 if the input contained a malformed basket.
+ */
+long u1_1_baskets(FILE *input, FILE *output);
+
+#endif // ZSP_BASKET_H
+
+/** End of basket.h */
\ No newline at end of file
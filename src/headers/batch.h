@@ -0,0 +1,113 @@
+/**
+ * @file batch.h
+ * @brief Batch drivers that process whole streams of task records in one run.
+ * @details The interactive functions in functions.h handle exactly one record per program start.
+ *          The batch drivers declared here read every record from an input stream, compute the
+ *          result with the same logic and write all results through one large output buffer. The
+ *          text produced for a record is byte-for-byte the same as the interactive output.
+ *
+ *          Regular input files are memory-mapped and parsed in place, pipes are streamed; see
+ *          InputReader in buffered_io.h.
+ *
+ *          Every driver is split into the stream wrapper and a kernel that works on an InputReader
+ *          and an OutputBuffer. The kernels of the line-oriented formats also run on chunks of the
+ *          input in parallel, see parallel_batch.h.
+ *
+ * @see batch.cpp for the implementation.
+ * @see functions.h for the single-record tasks.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_BATCH_H
+#define ZSP_BATCH_H
+#include "buffered_io.h"
+#include "currency_code.h"
+#include <stdio.h>
+
+/**
+ * @brief Kernel of a batch mode: processes every record the reader yields.
+ * @return Number of processed records, or -1 if a malformed record was found.
+ */
+typedef long (*BatchKernel)(InputReader &reader, OutputBuffer &out);
+
+/**
+ * @brief Prints a receipt for every (count, price) record in the input.
+ *
+ * @details Each record consists of two integers, the number of pieces and the unit price without VAT,
+ *          exactly as u1_1() reads them, with one record per line. The receipts are written one after
+ *          another in the input order.
+ *
+ *          A record may carry a third field on the same line, the VAT rate in percent (20, 21, 12
+ *          or 0, see vat.h). Records without it are priced at 20 % like in u1_1().
+ *
+ * @param input Stream with the records.
+ * @param output Stream the receipts are written to.
+ * @return Number of processed records, or -1 if the input contained a malformed record or an unknown
+ *         VAT rate. Receipts for the records before the malformed one are still written.
+ */
+long u1_1_batch(FILE *input, FILE *output);
+
+/**
+ * @brief Kernel of u1_1_batch().
+ * @param reader Source of the records.
+ * @param out Buffer the receipts are appended to.
+ * @return Same as u1_1_batch().
+ */
+long u1_1_receipts(InputReader &reader, OutputBuffer &out);
+
+/**
+ * @brief Prints the grade report for every student record in the input.
+ *
+ * @details Each record consists of five grades, exactly as u1_2() reads them. The reports are
+ *          written one after another in the input order.
+ *
+ * @param input Stream with the records.
+ * @param output Stream the reports are written to.
+ * @return Number of processed records, or -1 if the input contained a malformed record.
+ */
+long u1_2_batch(FILE *input, FILE *output);
+
+/**
+ * @brief Kernel of u1_2_batch().
+ * @param reader Source of the records.
+ * @param out Buffer the reports are appended to.
+ * @return Same as u1_2_batch().
+ */
+long u1_2_reports(InputReader &reader, OutputBuffer &out);
+
+/**
+ * @brief One parsed (currency, rate, amount) record of the exchange mode.
+ */
+struct ConversionRecord
+{
+    CurrencyCode currency; ///< Currency, packed or interned.
+    int count;             ///< Amount to convert.
+    double rate;           ///< Rate of the currency to CZK.
+};
+
+/**
+ * @brief Prints the conversion for every (currency, rate, amount) record in the input.
+ *
+ * @details Each record consists of a currency code, its rate to CZK and the amount to convert,
+ *          exactly as u1_3() reads them. Records are parsed in blocks into 16-byte
+ *          ConversionRecords; the currency is packed into a CurrencyCode, and names other than
+ *          three bytes long are interned once per run.
+ *
+ * @param input Stream with the records.
+ * @param output Stream the conversions are written to.
+ * @return Number of processed records, or -1 if the input contained a malformed record.
+ */
+long u1_3_batch(FILE *input, FILE *output);
+
+/**
+ * @brief Kernel of u1_3_batch().
+ * @param reader Source of the records.
+ * @param out Buffer the conversions are appended to.
+ * @return Same as u1_3_batch().
+ */
+long u1_3_conversions(InputReader &reader, OutputBuffer &out);
+
+#endif // ZSP_BATCH_H
+
+/** End of batch.h */
\ No newline at end of file
@@ -0,0 +1,131 @@
+/**
+ * @file cohort_stats.h
+ * @brief Streaming statistics over the grade averages of a whole cohort.
+ * @details Instead of printing a report per student, the statistics mode feeds every student into a
+ *          CohortStats accumulator and prints one summary: the number of students, the mean
+ *          average, the distinction/pass/fail rates, percentiles of the averages and a histogram.
+ *          The accumulator has a fixed size, so a cohort of any size is summarised in one pass and
+ *          constant memory.
+ *
+ *          Averages are counted in a histogram of hundredths between 1.00 and 5.00, the resolution
+ *          u1_2() prints them with. Each average goes into the bucket of its printed text, ties to
+ *          even included, so an average of 1.125 is counted as 1.12. The percentiles are read from
+ *          that histogram and are therefore exact up to the rounding to hundredths.
+ *
+ * @see cohort_stats.cpp for the implementation.
+ * @see gradebook.h for the input format.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_COHORT_STATS_H
+#define ZSP_COHORT_STATS_H
+#include <stddef.h>
+#include <stdio.h>
+
+/** Number of histogram buckets, one per hundredth from 1.00 to 5.00. */
+const int COHORT_STATS_BUCKETS = 401;
+
+/** Longest text produced by CohortStats::format(). */
+const size_t COHORT_STATS_MAX_LENGTH = 1024;
+
+/**
+ * @class CohortStats
+ * @brief Accumulates counts, rates and a histogram of averages.
+ *
+ * @details Students are added as integer grade sums with their counts and class bytes (see
+ *          grade_class.h). Students with an invalid average are counted, but they are not part of
+ *          the mean, the percentiles or the histogram. Two accumulators can be merged, so partial
+ *          statistics can be collected independently and combined.
+ */
+class CohortStats
+{
+  public:
+    CohortStats();
+
+    /**
+     * @brief Adds one student.
+     * @param sum Sum of the grades.
+     * @param count Number of grades.
+     * @param grade_class Class byte from classify_grade_sums().
+     */
+    void add(int sum, int count, unsigned char grade_class);
+
+    /**
+     * @brief Adds a block of students.
+     * @param sums Sums of the grades.
+     * @param counts Number of grades of every student.
+     * @param classes Class bytes.
+     * @param students Number of students.
+     */
+    void add(const int *sums, const int *counts, const unsigned char *classes, size_t students);
+
+    /**
+     * @brief Adds all students counted by another accumulator.
+     * @param other Accumulator to merge in.
+     */
+    void merge(const CohortStats &other);
+
+    /**
+     * @brief Returns the number of students added so far.
+     * @return Number of students, valid or not.
+     */
+    long long students() const;
+
+    /**
+     * @brief Returns the number of students whose class byte has the given bit set.
+     * @param bit One of GradeClassBits.
+     * @return Number of students.
+     */
+    long long count(int bit) const;
+
+    /**
+     * @brief Returns the mean of the valid averages.
+     * @return Mean, or 0 if there is no valid student.
+     */
+    double mean() const;
+
+    /**
+     * @brief Returns a percentile of the valid averages, by the nearest-rank method.
+     * @param fraction Fraction of the students at or below the result, between 0 and 1.
+     * @return Average rounded to hundredths, or 0 if there is no valid student.
+     */
+    double percentile(double fraction) const;
+
+    /**
+     * @brief Writes the summary.
+     * @param p Write position with at least COHORT_STATS_MAX_LENGTH free bytes.
+     * @return Position after the summary.
+     */
+    char *format(char *p) const;
+
+  private:
+    long long total;
+    long long classes[4]; ///< Students per class bit: distinction, passed, failed, invalid.
+    double average_sum;   ///< Sum of the valid averages.
+    long long histogram[COHORT_STATS_BUCKETS];
+};
+
+/**
+ * @brief Prints a summary of all students in the input.
+ * @details The input has the format of u1_2_gradebook(): one student per line.
+ * @param input Stream with the records.
+ * @param output Stream the summary is written to.
+ * @return Number of processed students, or -1 if the input contained a malformed record.
+ */
+long u1_2_statistics(FILE *input, FILE *output);
+
+/**
+ * @brief Prints a running summary after every 'interval' students and a final one at the end.
+ * @details Every summary covers all students read so far. The final summary is left out when the
+ *          last periodic one already covered every student.
+ * @param input Stream with the records.
+ * @param output Stream the summaries are written to.
+ * @param interval Number of students between two summaries; 0 prints only the final summary.
+ * @return Same as u1_2_statistics().
+ */
+long u1_2_statistics(FILE *input, FILE *output, long interval);
+
+#endif // ZSP_COHORT_STATS_H
+
+/** End of cohort_stats.h */
\ No newline at end of file
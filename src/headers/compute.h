@@ -0,0 +1,188 @@
+/**
+ * @file compute.h
+ * @brief Pricing, grading and conversion as pure functions over caller-provided memory.
+ * @details u1_1(), u1_2() and u1_3() read their record with `scanf` and print with `fwrite`, so
+ *          embedding them means redirecting the process-wide standard streams. The functions
+ *          declared here take the record as a value and return the result, and the text functions
+ *          write into a buffer the caller provides. Nothing here touches a stream, a global or the
+ *          heap on its normal path, so all of it can be called from any number of threads at once.
+ *
+ *          Every task has four entry points:
+ *          - compute_*() computes the result of one record;
+ *          - the array overload computes a whole span of records with the vectorised kernels;
+ *          - *_text() writes the text u1_*() would print for one record into a buffer;
+ *          - write_*() appends the texts of a span of records to an OutputBuffer.
+ *
+ *          The *_text() functions follow `snprintf`: they return the length of the whole text and
+ *          write it only if it fits, without a terminating NUL.
+ *
+ * @see compute.cpp for the implementation.
+ * @see functions.h for the interactive tasks built on top of these functions.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_COMPUTE_H
+#define ZSP_COMPUTE_H
+#include "buffered_io.h"
+#include "functions.h"
+#include <stddef.h>
+
+/** Number of grades of a u1_2 record. */
+const int COMPUTE_GRADES = 5;
+
+/**
+ * @brief Input of one receipt.
+ */
+struct ReceiptRecord
+{
+    int count;   ///< Number of pieces.
+    int price;   ///< Unit price without VAT, within vat_rate_max_price() of the rate.
+    int percent; ///< VAT rate in percent: 20, 21, 12 or 0.
+};
+
+/**
+ * @brief Priced receipt.
+ */
+struct Receipt
+{
+    int gross;             ///< Unit price with VAT.
+    long long net_total;   ///< Price of all pieces without VAT.
+    long long gross_total; ///< Price of all pieces with VAT.
+};
+
+/**
+ * @brief Input of one grade report.
+ */
+struct GradeRecord
+{
+    int grades[COMPUTE_GRADES]; ///< The five grades.
+};
+
+/**
+ * @brief Result of one grade report.
+ */
+struct GradeReport
+{
+    double average;     ///< Average of the grades.
+    GradeStatus status; ///< Classification of the average.
+};
+
+/**
+ * @brief Input of one conversion.
+ */
+struct ExchangeRecord
+{
+    const char *currency; ///< Currency name, not necessarily NUL-terminated.
+    size_t length;        ///< Length of the name in bytes.
+    double rate;          ///< Rate of the currency to CZK.
+    int count;            ///< Amount to convert.
+};
+
+/**
+ * @brief Prices one receipt.
+ * @param record Receipt input.
+ * @param receipt Receives the prices.
+ * @return false if the VAT rate is unknown; 'receipt' is then left unchanged.
+ */
+bool compute_receipt(const ReceiptRecord &record, Receipt &receipt);
+
+/**
+ * @brief Prices a span of receipts.
+ * @param records Receipt inputs.
+ * @param count Number of receipts.
+ * @param receipts Receives the prices, one per record.
+ * @return Number of priced receipts; pricing stops at the first record with an unknown VAT rate.
+ */
+size_t compute_receipt(const ReceiptRecord *records, size_t count, Receipt *receipts);
+
+/**
+ * @brief Writes the text u1_1() prints for a receipt.
+ * @param record Receipt input.
+ * @param receipt Prices from compute_receipt().
+ * @param buffer Receives the text if it fits.
+ * @param capacity Size of the buffer; FORMAT_RECEIPT_MAX_LENGTH always suffices.
+ * @return Length of the text.
+ */
+size_t receipt_text(const ReceiptRecord &record, const Receipt &receipt, char *buffer, size_t capacity);
+
+/**
+ * @brief Appends the texts of a span of priced receipts.
+ * @param records Receipt inputs.
+ * @param receipts Prices from compute_receipt().
+ * @param count Number of receipts.
+ * @param out Buffer the texts are appended to.
+ */
+void write_receipts(const ReceiptRecord *records, const Receipt *receipts, size_t count, OutputBuffer &out);
+
+/**
+ * @brief Grades one student.
+ * @param record The five grades.
+ * @return Average and classification.
+ */
+GradeReport compute_grade_report(const GradeRecord &record);
+
+/**
+ * @brief Grades a span of students.
+ * @param records Grades of every student.
+ * @param count Number of students.
+ * @param reports Receives one report per student.
+ */
+void compute_grade_report(const GradeRecord *records, size_t count, GradeReport *reports);
+
+/**
+ * @brief Writes the text u1_2() prints for a student.
+ * @param record The five grades.
+ * @param report Result of compute_grade_report().
+ * @param buffer Receives the text if it fits.
+ * @param capacity Size of the buffer; FORMAT_REPORT_MAX_LENGTH always suffices.
+ * @return Length of the text.
+ */
+size_t grade_report_text(const GradeRecord &record, const GradeReport &report, char *buffer, size_t capacity);
+
+/**
+ * @brief Appends the texts of a span of graded students.
+ * @param records Grades of every student.
+ * @param reports Results of compute_grade_report().
+ * @param count Number of students.
+ * @param out Buffer the texts are appended to.
+ */
+void write_grade_reports(const GradeRecord *records, const GradeReport *reports, size_t count, OutputBuffer &out);
+
+/**
+ * @brief Converts one amount to CZK.
+ * @param record Conversion input.
+ * @return The converted amount rounded like u1_3(); the product must fit into an int.
+ */
+int compute_exchange(const ExchangeRecord &record);
+
+/**
+ * @brief Converts a span of amounts to CZK.
+ * @param records Conversion inputs.
+ * @param count Number of conversions.
+ * @param rounded Receives the rounded amounts, one per record.
+ */
+void compute_exchange(const ExchangeRecord *records, size_t count, int *rounded);
+
+/**
+ * @brief Writes the text u1_3() prints for a conversion.
+ * @param record Conversion input.
+ * @param rounded Result of compute_exchange().
+ * @param buffer Receives the text if it fits.
+ * @param capacity Size of the buffer; format_conversion_max_length() of the name always suffices.
+ * @return Length of the text.
+ */
+size_t exchange_text(const ExchangeRecord &record, int rounded, char *buffer, size_t capacity);
+
+/**
+ * @brief Appends the texts of a span of conversions.
+ * @param records Conversion inputs.
+ * @param rounded Results of compute_exchange().
+ * @param count Number of conversions.
+ * @param out Buffer the texts are appended to.
+ */
+void write_exchanges(const ExchangeRecord *records, const int *rounded, size_t count, OutputBuffer &out);
+
+#endif // ZSP_COMPUTE_H
+
+/** End of compute.h */
\ No newline at end of file
@@ -0,0 +1,151 @@
+/**
+ * @file cross_rates.h
+ * @brief Dense cross-rate matrix for conversions between any two currencies.
+ * @details The rate file gives every currency's rate to CZK. Converting EUR to USD through CZK
+ *          takes two conversions and two roundings. The CrossRateMatrix instead holds the rate of
+ *          every pair, rate(source) / rate(target), so a conversion is one multiplication of the
+ *          amount and one rounding of the result.
+ *
+ *          The matrix is stored by rows: row s holds the rates from currency s to all targets. Rows
+ *          start on 64-byte boundaries, and the batch mode processes the records of a block grouped
+ *          by source, so one row stays in cache while all records of its currency are converted.
+ *          CZK is always part of the matrix with the rate 1 unless the rate file lists it.
+ *
+ *          When a single base rate changes, only its row and its column are recomputed: O(N)
+ *          instead of the O(N^2) of a full rebuild.
+ *
+ * @see cross_rates.cpp for the implementation.
+ * @see rate_table.h for the base rates.
+ * @see rate_snapshot.h for the published rates of the live mode.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_CROSS_RATES_H
+#define ZSP_CROSS_RATES_H
+#include "buffered_io.h"
+#include "currency_code.h"
+#include "rate_snapshot.h"
+#include "rate_table.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @class CrossRateMatrix
+ * @brief Rates between all pairs of currencies of a rate table.
+ */
+class CrossRateMatrix
+{
+  public:
+    CrossRateMatrix();
+
+    /**
+     * @brief Rebuilds the whole matrix from base rates.
+     * @param rates Rates to CZK.
+     */
+    void build(const RateTable &rates);
+
+    /**
+     * @brief Brings the matrix up to date with new base rates.
+     * @details Only the rows and columns of currencies whose rate changed are recomputed. If a
+     *          currency was added or removed, the matrix is rebuilt.
+     * @param rates Rates to CZK.
+     * @return Number of currencies whose row and column were recomputed.
+     */
+    size_t update(const RateTable &rates);
+
+    /**
+     * @brief Changes the base rate of one currency.
+     * @details An existing currency gets its row and column recomputed; a new one triggers a
+     *          rebuild.
+     * @param key Key of the currency from currency_key().
+     * @param rate New rate to CZK.
+     * @return false if the key is not an ISO 4217 code; the matrix is left unchanged then.
+     */
+    bool update(uint32_t key, double rate);
+
+    /**
+     * @brief Returns the number of currencies in the matrix.
+     * @return N.
+     */
+    size_t currencies() const;
+
+    /**
+     * @brief Returns the row and column index of a currency.
+     * @param code Currency code.
+     * @return Index, or -1 if the currency is not in the matrix.
+     */
+    int index(const CurrencyCode &code) const;
+
+    /**
+     * @brief Returns the key of the currency at an index.
+     * @param index Index below currencies().
+     * @return Key from currency_key().
+     */
+    uint32_t key(int index) const;
+
+    /**
+     * @brief Returns the rates from one currency to all currencies.
+     * @param source Index of the source currency.
+     * @return Row with currencies() entries; valid until the matrix changes.
+     */
+    const double *row(int source) const
+    {
+        return first_row + (size_t)source * stride;
+    }
+
+    /**
+     * @brief Returns the rate from one currency to another.
+     * @param source Index of the source currency.
+     * @param target Index of the target currency.
+     * @return Units of the target per unit of the source.
+     */
+    double rate(int source, int target) const
+    {
+        return row(source)[target];
+    }
+
+  private:
+    CrossRateMatrix(const CrossRateMatrix &);
+    CrossRateMatrix &operator=(const CrossRateMatrix &);
+
+    void rebuild(const std::vector<uint32_t> &new_keys, const std::vector<double> &new_rates);
+    void recompute(int changed);
+
+    std::vector<uint32_t> keys;   ///< Key of every currency, ascending.
+    std::vector<double> base;     ///< Rate to CZK of every currency.
+    std::vector<int16_t> indices; ///< Index of the currency in every RateTable slot, or -1.
+    std::vector<double> cells;    ///< Storage of the rows, with room for the alignment.
+    double *first_row;            ///< First row, aligned to 64 bytes.
+    size_t stride;                ///< Distance between two rows, a multiple of 8.
+};
+
+/**
+ * @brief Converts every (source, target, amount) record with the cross-rate matrix.
+ * @details A record is `EUR USD 100`; the result is printed as
+ *          `100 EUR = 108.7 USD Zaokrouhleno: 109 USD`, with the rounding of u1_3().
+ * @param matrix Cross rates.
+ * @param reader Source of the records.
+ * @param out Buffer the conversions are appended to.
+ * @return Number of processed records, or -1 if a record was malformed or named a currency that is
+ *         not in the matrix.
+ */
+long u1_3_cross_conversions(const CrossRateMatrix &matrix, InputReader &reader, OutputBuffer &out);
+
+/**
+ * @brief Converts every (source, target, amount) record with cross rates that follow published base rates.
+ * @details Before each block of records the matrix is brought up to date with the newest snapshot
+ *          through CrossRateMatrix::update(), so a changed rate recomputes only its row and column.
+ *          A snapshot published while the input is processed applies from the next block on.
+ * @param snapshots Published base rates.
+ * @param matrix Matrix owned by this call while it runs; it is left at the last snapshot used.
+ * @param reader Source of the records.
+ * @param out Buffer the conversions are appended to.
+ * @return Same as u1_3_cross_conversions(), and -1 if no snapshot was published.
+ */
+long u1_3_live_cross_conversions(RateSnapshots &snapshots, CrossRateMatrix &matrix, InputReader &reader,
+                                 OutputBuffer &out);
+
+#endif // ZSP_CROSS_RATES_H
+
+/** End of cross_rates.h */
\ No newline at end of file
@@ -0,0 +1,138 @@
+/**
+ * @file currency_code.h
+ * @brief Currency codes packed into 32 bits, with interning for longer names.
+ * @details u1_3() accepts any word as the currency. Almost all of them are three-letter ISO 4217
+ *          codes, which fit into a 32-bit value together with a tag byte: comparing, hashing or
+ *          copying such a code is one integer operation and a record holding it stays small. Words
+ *          of any other length are interned: the CurrencyInterner stores the text once and the code
+ *          carries its index instead of the letters.
+ *
+ * @see currency_code.cpp for the implementation.
+ * @see batch.h for the conversion records built on it.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_CURRENCY_CODE_H
+#define ZSP_CURRENCY_CODE_H
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Kind of a CurrencyCode.
+ */
+enum CurrencyTag
+{
+    CURRENCY_INLINE = 0,  ///< The three bytes are the text of the code.
+    CURRENCY_INTERNED = 1 ///< The three bytes are an index into a CurrencyInterner.
+};
+
+/** Largest number of names one CurrencyInterner can hold. */
+const uint32_t CURRENCY_MAX_INTERNED = 1u << 24;
+
+/**
+ * @brief Currency code in four bytes: three bytes of text or index and a CurrencyTag.
+ */
+struct CurrencyCode
+{
+    char bytes[3]; ///< Text of an inline code, or the little-endian index of an interned one.
+    uint8_t tag;   ///< CurrencyTag.
+
+    /**
+     * @brief Returns all four bytes as one integer, for comparison and hashing.
+     * @return Packed value.
+     */
+    uint32_t value() const
+    {
+        uint32_t packed;
+        memcpy(&packed, this, sizeof(packed));
+        return packed;
+    }
+};
+
+inline bool operator==(const CurrencyCode &a, const CurrencyCode &b)
+{
+    return a.value() == b.value();
+}
+
+inline bool operator!=(const CurrencyCode &a, const CurrencyCode &b)
+{
+    return a.value() != b.value();
+}
+
+/**
+ * @brief Packs a three-byte word into an inline code.
+ * @param text Word, not necessarily NUL-terminated.
+ * @param length Length of the word in bytes.
+ * @param code Receives the code.
+ * @return false if the word is not three bytes long.
+ */
+inline bool currency_code_pack(const char *text, size_t length, CurrencyCode &code)
+{
+    if (length != 3)
+    {
+        return false;
+    }
+    memcpy(code.bytes, text, 3);
+    code.tag = CURRENCY_INLINE;
+    return true;
+}
+
+/**
+ * @class CurrencyInterner
+ * @brief Turns currency words into codes and codes back into text.
+ */
+class CurrencyInterner
+{
+  public:
+    /**
+     * @brief Returns the code of a word; three-byte words are packed inline, others interned.
+     * @param text Word, not necessarily NUL-terminated.
+     * @param length Length of the word in bytes.
+     * @param code Receives the code.
+     * @return false if a new name would exceed CURRENCY_MAX_INTERNED.
+     */
+    bool intern(const char *text, size_t length, CurrencyCode &code);
+
+    /**
+     * @brief Returns the text of a code.
+     * @param code Code from this interner; an inline code's text points into the code itself.
+     * @param length Receives the length of the text in bytes.
+     * @return Text, not NUL-terminated.
+     */
+    const char *text(const CurrencyCode &code, size_t &length) const
+    {
+        if (code.tag == CURRENCY_INLINE)
+        {
+            length = 3;
+            return code.bytes;
+        }
+        const std::string &name = names[index(code)];
+        length = name.size();
+        return name.data();
+    }
+
+    /**
+     * @brief Returns the number of interned names.
+     * @return Number of names.
+     */
+    size_t interned() const;
+
+  private:
+    static uint32_t index(const CurrencyCode &code)
+    {
+        return (uint32_t)(unsigned char)code.bytes[0] | (uint32_t)(unsigned char)code.bytes[1] << 8 |
+               (uint32_t)(unsigned char)code.bytes[2] << 16;
+    }
+
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint32_t> indices;
+};
+
+#endif // ZSP_CURRENCY_CODE_H
+
+/** End of currency_code.h */
\ No newline at end of file
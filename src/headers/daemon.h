@@ -0,0 +1,242 @@
+/**
+ * @file daemon.h
+ * @brief Server mode answering receipt, grade and conversion requests over a Unix domain socket.
+ * @details Starting the program for a single record costs far more than computing it. DaemonServer
+ *          keeps one warm process listening on a local socket; one thread runs an epoll loop over
+ *          all connections and answers every request in place, without a thread handoff.
+ *
+ *          Requests and responses are frames: a 16-bit body length followed by the body. A request
+ *          body is a DaemonTask byte followed by the fields of the task:
+ *
+ *              DAEMON_RECEIPT     int32 count, int32 price, uint8 VAT rate in percent
+ *              DAEMON_GRADES      5 x uint8 grade
+ *              DAEMON_CONVERSION  uint8 name length, name, float64 rate, int32 amount
+ *
+ *          A response body is a DaemonStatus byte followed by the text the --batch, --grades or
+ *          --exchange mode prints for the record. All numbers are little-endian. A client may send
+ *          any number of requests without waiting; the responses come back in request order. An
+ *          empty request or one longer than DAEMON_MAX_REQUEST closes the connection.
+ *
+ * @see daemon.cpp for the implementation.
+ * @see batch.h for the text of the responses.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_DAEMON_H
+#define ZSP_DAEMON_H
+#include "buffered_io.h"
+#include "format.h"
+#include <atomic>
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/** Size of the length prefix of a frame. */
+const size_t DAEMON_LENGTH_SIZE = 2;
+
+/** Longest request body; a conversion with a 255-byte currency name has 268 bytes. */
+const size_t DAEMON_MAX_REQUEST = 512;
+
+/** Longest request frame. */
+const size_t DAEMON_MAX_REQUEST_FRAME = DAEMON_LENGTH_SIZE + DAEMON_MAX_REQUEST;
+
+/** Longest response frame. */
+const size_t DAEMON_MAX_RESPONSE = DAEMON_LENGTH_SIZE + 1 + 2 * 255 + 3 * FORMAT_FIXED_MAX_LENGTH + 128;
+
+/** Responses a connection may have waiting before its requests are no longer read. */
+const size_t DAEMON_MAX_PENDING = 64 << 10;
+
+/**
+ * @brief Task of a request.
+ */
+enum DaemonTask
+{
+    DAEMON_RECEIPT = 1,   ///< Receipt of u1_1.
+    DAEMON_GRADES = 2,    ///< Grade report of u1_2.
+    DAEMON_CONVERSION = 3 ///< Conversion of u1_3.
+};
+
+/**
+ * @brief First byte of a response body.
+ */
+enum DaemonStatus
+{
+    DAEMON_OK = 0,          ///< The text of the record follows.
+    DAEMON_MALFORMED = 1,   ///< The fields do not match the task, or the VAT rate is unknown.
+    DAEMON_UNKNOWN_TASK = 2 ///< The task byte is not a DaemonTask.
+};
+
+/**
+ * @brief Encodes a receipt request.
+ * @param frame Receives the frame; needs DAEMON_MAX_REQUEST_FRAME bytes.
+ * @param count Number of pieces.
+ * @param price Unit price without VAT.
+ * @param percent VAT rate in percent, see vat.h.
+ * @return Size of the frame.
+ */
+size_t daemon_receipt_request(char *frame, int count, int price, int percent);
+
+/**
+ * @brief Encodes a grade report request.
+ * @param frame Receives the frame; needs DAEMON_MAX_REQUEST_FRAME bytes.
+ * @param grades The five grades.
+ * @return Size of the frame.
+ */
+size_t daemon_grades_request(char *frame, const unsigned char *grades);
+
+/**
+ * @brief Encodes a conversion request.
+ * @param frame Receives the frame; needs DAEMON_MAX_REQUEST_FRAME bytes.
+ * @param currency Currency name, at most 255 bytes.
+ * @param length Length of the name in bytes.
+ * @param rate Rate of the currency to CZK.
+ * @param count Amount to convert.
+ * @return Size of the frame, or 0 if the name is too long.
+ */
+size_t daemon_conversion_request(char *frame, const char *currency, size_t length, double rate, int count);
+
+/**
+ * @brief Answers one request.
+ * @param body Request body, without its length prefix.
+ * @param length Length of the body.
+ * @param p Receives the response frame; needs DAEMON_MAX_RESPONSE bytes.
+ * @return Position after the response frame.
+ */
+char *daemon_respond(const char *body, size_t length, char *p);
+
+/**
+ * @class DaemonServer
+ * @brief Single-threaded epoll server for the request protocol.
+ *
+ * @details The sockets are non-blocking and watched level-triggered. A connection reads whatever
+ *          has arrived, answers every complete frame into its output buffer and writes as much of
+ *          it as the socket takes. While more than DAEMON_MAX_PENDING bytes of responses wait for a
+ *          slow reader, its requests are not read, so one client cannot grow the server's memory.
+ */
+class DaemonServer
+{
+  public:
+    DaemonServer();
+
+    /**
+     * @brief Closes all connections and removes the socket file.
+     */
+    ~DaemonServer();
+
+    /**
+     * @brief Creates the listening socket; a stale socket file at the path is replaced.
+     * @param path Path of the socket file.
+     * @return true on success; false if the path exists and is not a socket, which is left alone.
+     */
+    bool listen(const char *path);
+
+    /**
+     * @brief Serves connections until stop() is called.
+     * @return false if listen() did not succeed or waiting for events failed.
+     */
+    bool run();
+
+    /**
+     * @brief Makes run() return; safe to call from other threads and from signal handlers.
+     */
+    void stop();
+
+    /**
+     * @brief Returns the number of answered requests.
+     * @return Number of requests.
+     */
+    unsigned long long requests() const;
+
+  private:
+    DaemonServer(const DaemonServer &);
+    DaemonServer &operator=(const DaemonServer &);
+
+    struct Connection;
+
+    void accept_connections();
+    bool receive(Connection &connection);
+    bool transmit(Connection &connection);
+    void close_connection(int fd);
+
+    int listener;
+    int epoll;
+    int wakeup; ///< eventfd written by stop().
+    std::string path;
+    std::vector<std::unique_ptr<Connection>> connections; ///< Indexed by file descriptor.
+    std::atomic<unsigned long long> answered;
+};
+
+/**
+ * @class DaemonClient
+ * @brief Blocking client for the request protocol.
+ *
+ * @details send() and receive() may be used separately to keep several requests in flight.
+ */
+class DaemonClient
+{
+  public:
+    DaemonClient();
+
+    /**
+     * @brief Closes the connection.
+     */
+    ~DaemonClient();
+
+    /**
+     * @brief Connects to a server.
+     * @param path Path of the socket file.
+     * @return true on success.
+     */
+    bool connect(const char *path);
+
+    /**
+     * @brief Sends one request frame.
+     * @param frame Frame produced by one of the daemon_*_request() functions.
+     * @param size Size of the frame.
+     * @return false if the connection failed.
+     */
+    bool send(const char *frame, size_t size);
+
+    /**
+     * @brief Waits for the response to the oldest unanswered request.
+     * @param status Receives the DaemonStatus.
+     * @param text Receives the text of the response.
+     * @return false if the connection failed or was closed by the server.
+     */
+    bool receive(int &status, std::string &text);
+
+    /**
+     * @brief Sends one request and waits for its response.
+     * @return false if the connection failed.
+     */
+    bool call(const char *frame, size_t size, int &status, std::string &text);
+
+  private:
+    DaemonClient(const DaemonClient &);
+    DaemonClient &operator=(const DaemonClient &);
+
+    int socket;
+    std::vector<char> input;
+    size_t filled;
+};
+
+/**
+ * @brief Sends every record of a batch input to a server, one request at a time.
+ * @details The records have the format of the --batch, --grades or --exchange mode matching the
+ *          task; the texts of the responses are written in input order.
+ * @param client Connected client.
+ * @param task Task of all records.
+ * @param reader Source of the records.
+ * @param out Buffer the response texts are appended to.
+ * @param latencies Receives the round-trip time of every request in microseconds.
+ * @return Number of answered records, or -1 if a record was malformed, rejected by the server or
+ *         the connection failed.
+ */
+long daemon_replay(DaemonClient &client, DaemonTask task, InputReader &reader, OutputBuffer &out,
+                   std::vector<double> &latencies);
+
+#endif // ZSP_DAEMON_H
+
+/** End of daemon.h */
\ No newline at end of file
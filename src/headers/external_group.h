@@ -0,0 +1,75 @@
+/**
+ * @file external_group.h
+ * @brief Out-of-core grouping of grade events by student.
+ * @details u1_2() expects all grades of a student on one line. Real feeds deliver single grade
+ *          events, `<student> <subject> <grade>` one per line, in no particular order and spread
+ *          over many files that together may be larger than the memory of the machine. The
+ *          grouping mode sorts the events by student with an external merge sort:
+ *
+ *          1. Run generation: events are read into a buffer bounded by the memory limit, sorted
+ *             and appended to a temporary spill file as one sorted run.
+ *          2. Merging: the runs are merged k at a time through a heap, with k chosen so that the
+ *             read buffers of all k runs fit in the memory limit. Each pass writes its merged runs
+ *             into a second spill file and truncates the first, until one final merge can produce
+ *             the whole sorted stream.
+ *
+ *          All runs of a pass share one file and are addressed by offset, so at most two temporary
+ *          files are open however many runs the input makes. Runs are written and read in large
+ *          blocks. Inputs that fit into a single run never touch the disk. The grades of each
+ *          student, in the order in which they arrived, are then averaged and classified like in
+ *          u1_2() and printed as a report headed by the student ID; they are streamed into the
+ *          report, so a student with any number of grades needs no memory.
+ *
+ *          The memory limit covers the event buffer, the merge read buffers and the input, output
+ *          and spill write buffers, which get one eighth of it. Beyond that only the merge heap and
+ *          the list of runs are allocated, a few dozen bytes per run. Mapped input files are not
+ *          counted; they live in the page cache.
+ *
+ * @see external_group.cpp for the implementation.
+ * @see gradebook.h for the report layout.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_EXTERNAL_GROUP_H
+#define ZSP_EXTERNAL_GROUP_H
+#include <stddef.h>
+#include <stdio.h>
+
+/** Default memory limit of the grouping mode in bytes. */
+const size_t GROUP_DEFAULT_MEMORY = 64 << 20;
+
+/** Smallest memory limit accepted; smaller limits are raised to it. */
+const size_t GROUP_MIN_MEMORY = 64 << 10;
+
+/** Returned by u1_2_group() when a spill file cannot be created, written or read back. */
+const long GROUP_SPILL_FAILED = -2;
+
+/**
+ * @brief Groups the events of several inputs by student and prints a report per student.
+ *
+ * @details Students are reported in ascending order of their IDs. A report is "Student <id>"
+ *          followed by the u1_2() report over all grades of the student; the subject only
+ *          identifies the event and is not part of the report.
+ *
+ * @param inputs Streams with the events; all of them are read to the end.
+ * @param input_count Number of streams.
+ * @param output Stream the reports are written to.
+ * @param memory_limit Upper bound of the memory used for sorting and merging, in bytes.
+ * @return Number of reported students; -1 if an input contained a malformed event or a grade outside
+ *         0-255, and nothing is written then; GROUP_SPILL_FAILED if a spill file failed, in which
+ *         case the reports written before the failure are incomplete.
+ */
+long u1_2_group(FILE *const *inputs, size_t input_count, FILE *output, size_t memory_limit);
+
+/**
+ * @brief Groups the events of one input with the default memory limit; see above.
+ * @param input Stream with the events.
+ * @param output Stream the reports are written to.
+ * @return Same as the multi-input version.
+ */
+long u1_2_group(FILE *input, FILE *output);
+
+#endif // ZSP_EXTERNAL_GROUP_H
+
+/** End of external_group.h */
\ No newline at end of file
@@ -0,0 +1,123 @@
+/**
+ * @file fixed_decimal.h
+ * @brief Fixed-point decimal rates and an exact, vectorised batch converter.
+ * @details u1_3() multiplies a double rate by the amount and rounds with round_half_up(). A rate
+ *          such as 24.35 has no exact binary representation, so a product that is exactly on .5 in
+ *          decimal can land just below it and round down. The fixed-point path keeps a rate as
+ *          whole CZK plus millionths, both read exactly from the decimal text, and computes with
+ *          integers only where exactness matters:
+ *
+ *              rate * amount = units * amount + micros * amount / 10^6
+ *
+ *          The second term is an integer below 2^51 divided by 10^6; its floor is exact in double
+ *          arithmetic because the exact quotient is never closer than 10^-6 to an integer, which is
+ *          far more than the rounding error of one division. That lets the AVX2 kernel convert four
+ *          records per iteration. The scalar reference uses a 128-bit intermediate instead.
+ *
+ *          Results are rounded half up on the exact decimal value, i.e. to floor(x + 0.5): the same
+ *          as round_half_up() for every non-negative product that double arithmetic gets right,
+ *          including all u1_3() test cases. Negative products, which round_half_up() truncates,
+ *          round to the nearest integer as well.
+ *
+ *          Parsing and formatting dominate a batch run, not the arithmetic: at -O2 the compiler
+ *          vectorises the double conversion too, so fixed_convert() is only about 1.6 times as fast as
+ *          compute_exchange(). u1_3_fixed_conversions() therefore reads records of the usual shape in
+ *          place with SSE2 and formats the rate and the amount once per record, which makes it about
+ *          2.4 times as fast as u1_3_conversions(). That is short of the five-fold speedup the batch
+ *          mode was asked for; the rest needs scanning and formatting several records per vector.
+ *          See BM_FixedConvert and the *ConversionsKernel benchmarks in benchmarks.cpp.
+ *
+ * @see fixed_decimal.cpp for the implementation.
+ * @see batch.h for the double-based exchange mode.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_FIXED_DECIMAL_H
+#define ZSP_FIXED_DECIMAL_H
+#include "buffered_io.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/** Number of millionths in one unit. */
+const int32_t FIXED_SCALE = 1000000;
+
+/** Rates must stay below this number of whole CZK, so that every intermediate fits 64 bits. */
+const int32_t FIXED_MAX_UNITS = 100000000;
+
+/**
+ * @brief Non-negative decimal rate with six decimal places.
+ */
+struct FixedRate
+{
+    int32_t units;  ///< Whole CZK, below FIXED_MAX_UNITS.
+    int32_t micros; ///< Millionths of CZK, below FIXED_SCALE.
+};
+
+/**
+ * @brief Reads a decimal rate exactly.
+ * @details Accepts digits with an optional fraction, such as `24`, `24.35` or `.5`. Digits after
+ *          the sixth decimal place are rounded half up.
+ * @param text Token, not necessarily NUL-terminated.
+ * @param length Length of the token in bytes.
+ * @param rate Receives the rate.
+ * @return false for a sign, an exponent, any other character or a rate of FIXED_MAX_UNITS or more.
+ */
+bool fixed_rate_parse(const char *text, size_t length, FixedRate &rate);
+
+/**
+ * @brief Converts a batch of amounts, rounding half up exactly.
+ * @details Uses AVX2 where available.
+ * @param units Whole CZK of every rate.
+ * @param micros Millionths of every rate.
+ * @param counts Amounts to convert.
+ * @param rounded Receives the results rounded to whole CZK.
+ * @param tenths Receives the results rounded to tenths of CZK, in tenths.
+ * @param records Number of records.
+ */
+void fixed_convert(const int32_t *units, const int32_t *micros, const int32_t *counts, int64_t *rounded,
+                   int64_t *tenths, size_t records);
+
+/**
+ * @brief Scalar version of fixed_convert() with a 128-bit intermediate; used as the reference in tests.
+ */
+void fixed_convert_scalar(const int32_t *units, const int32_t *micros, const int32_t *counts, int64_t *rounded,
+                          int64_t *tenths, size_t records);
+
+/**
+ * @brief AVX2 version of fixed_convert(); only called when the CPU supports AVX2.
+ */
+void fixed_convert_avx2(const int32_t *units, const int32_t *micros, const int32_t *counts, int64_t *rounded,
+                        int64_t *tenths, size_t records);
+
+/**
+ * @brief Writes a number given in tenths with one decimal place, e.g. -153 as `-15.3`.
+ * @param p Write position with at least FORMAT_INTEGER_MAX_LENGTH + 3 free bytes.
+ * @param tenths Number in tenths.
+ * @return Position after the number.
+ */
+char *format_tenths(char *p, int64_t tenths);
+
+/**
+ * @brief Kernel of u1_3_fixed_batch(); also usable with batch_parallel().
+ * @param reader Source of the records.
+ * @param out Buffer the conversions are appended to.
+ * @return Same as u1_3_fixed_batch().
+ */
+long u1_3_fixed_conversions(InputReader &reader, OutputBuffer &out);
+
+/**
+ * @brief Prints the conversion for every (currency, rate, amount) record with fixed-point arithmetic.
+ * @details The records and the text are those of u1_3_batch(); the rate and the product are shown
+ *          rounded half up to one decimal place on their exact decimal values.
+ * @param input Stream with the records.
+ * @param output Stream the conversions are written to.
+ * @return Number of processed records, or -1 if the input contained a malformed record or a rate
+ *         fixed_rate_parse() does not accept.
+ */
+long u1_3_fixed_batch(FILE *input, FILE *output);
+
+#endif // ZSP_FIXED_DECIMAL_H
+
+/** End of fixed_decimal.h */
\ No newline at end of file
@@ -0,0 +1,196 @@
+/**
+ * @file format.h
+ * @brief printf-free text formatting for the receipts, grade reports and conversions.
+ * @details The output of the three tasks consists of a few constant UTF-8 fragments ("Účtenka",
+ *          "Cena s DPH/ks", "Kč", ...) interleaved with integers and numbers with one or two
+ *          decimals. The functions declared here copy the fragments as pre-encoded byte arrays and
+ *          convert the numbers with a two-digits-per-step table, writing into a buffer owned by the
+ *          caller. No format string is parsed and no stdio lock is taken; the bytes produced are
+ *          exactly those of the `printf` calls they replace, including the rounding of `%.1f` and
+ *          `%.2f`.
+ *
+ *          Every formatter takes a write position and returns the position after the written
+ *          text. The caller guarantees enough room; the *_MAX_LENGTH constants give the bounds.
+ *
+ * @see format.cpp for the implementation.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_FORMAT_H
+#define ZSP_FORMAT_H
+#include "functions.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/** Longest text produced by format_long(). */
+const size_t FORMAT_INTEGER_MAX_LENGTH = 20;
+
+/** Longest text produced by format_fixed(); `%.1f` of the largest double has 311 bytes. */
+const size_t FORMAT_FIXED_MAX_LENGTH = 320;
+
+/**
+ * Longest text produced by format_receipt_item(): 94 bytes of fixed text, four `int` fields of up to 11
+ * bytes and two `long long` fields of up to 20 bytes make 178, rounded up.
+ */
+const size_t FORMAT_ITEM_MAX_LENGTH = 192;
+
+/** Longest text produced by format_u1_1_receipt(). */
+const size_t FORMAT_RECEIPT_MAX_LENGTH = 208;
+
+/** Longest text produced by format_u1_2_report(). */
+const size_t FORMAT_REPORT_MAX_LENGTH = 192;
+
+/**
+ * @brief Longest text produced by format_grade_report().
+ * @param count Number of grades.
+ * @return Upper bound in bytes.
+ */
+inline size_t format_grade_report_max_length(size_t count)
+{
+    return 4 * count + FORMAT_REPORT_MAX_LENGTH;
+}
+
+/**
+ * @brief Longest text produced by format_u1_3_conversion().
+ * @param currency_length Length of the currency code in bytes.
+ * @return Upper bound in bytes.
+ */
+inline size_t format_conversion_max_length(size_t currency_length)
+{
+    return 2 * currency_length + 3 * FORMAT_FIXED_MAX_LENGTH + 128;
+}
+
+/**
+ * @brief Copies a constant text fragment.
+ * @tparam N Size of the string literal including its terminating NUL, which is not copied.
+ * @param p Write position.
+ * @param text String literal.
+ * @return Position after the fragment.
+ */
+template <size_t N>
+inline char *format_literal(char *p, const char (&text)[N])
+{
+    memcpy(p, text, N - 1);
+    return p + N - 1;
+}
+
+/**
+ * @brief Writes an integer like `%lld`.
+ * @param p Write position.
+ * @param value Value to write.
+ * @return Position after the number.
+ */
+char *format_long(char *p, long long value);
+
+/**
+ * @brief Rounds the magnitude of a number to tenths or hundredths exactly as format_fixed() prints it.
+ * @details Code that classifies printed values, such as a histogram of averages, uses this so that its
+ *          buckets agree with the text, ties to even included.
+ * @param value Value to round; NaN is not allowed.
+ * @param decimals Number of decimals, 1 or 2.
+ * @return Magnitude in units of the last decimal, saturated at UINT64_MAX.
+ */
+uint64_t round_fixed(double value, int decimals);
+
+/**
+ * @brief Writes a number with a fixed number of decimals like `%.1f` or `%.2f`.
+ * @details The exact binary value is rounded to nearest with ties to even, as glibc does; negative
+ *          values, including those that round to zero, keep their minus sign. Values too large for
+ *          the exact integer path are passed to `snprintf`.
+ * @param p Write position.
+ * @param value Value to write.
+ * @param decimals Number of decimals, 1 or 2.
+ * @return Position after the number.
+ */
+char *format_fixed(char *p, double value, int decimals);
+
+/**
+ * @brief Writes the two lines of one receipt item, as printed by u1_1() after the header.
+ * @param p Write position.
+ * @param count Number of pieces.
+ * @param price Unit price without VAT.
+ * @param gross Unit price with VAT.
+ * @param net_total Price of all pieces without VAT.
+ * @param gross_total Price of all pieces with VAT.
+ * @param percent VAT rate in percent.
+ * @return Position after the item.
+ */
+char *format_receipt_item(char *p, int count, int price, int gross, long long net_total, long long gross_total,
+                          int percent);
+
+/**
+ * @brief Writes a whole u1_1() receipt.
+ * @param p Write position.
+ * @param count Number of pieces.
+ * @param price Unit price without VAT.
+ * @param gross Unit price with VAT.
+ * @param percent VAT rate in percent.
+ * @return Position after the receipt.
+ */
+char *format_u1_1_receipt(char *p, int count, int price, int gross, int percent);
+
+/**
+ * @brief Writes a whole u1_1() receipt with totals computed by the caller, e.g. by compute_receipt().
+ * @param p Write position.
+ * @param count Number of pieces.
+ * @param price Unit price without VAT.
+ * @param gross Unit price with VAT.
+ * @param net_total Price of all pieces without VAT.
+ * @param gross_total Price of all pieces with VAT.
+ * @param percent VAT rate in percent.
+ * @return Position after the receipt.
+ */
+char *format_u1_1_receipt(char *p, int count, int price, int gross, long long net_total, long long gross_total,
+                          int percent);
+
+/**
+ * @brief Writes a u1_2() grade report.
+ * @param p Write position.
+ * @param grades The five grades.
+ * @param average_grade Average of the grades.
+ * @param status Classification of the average.
+ * @return Position after the report.
+ */
+char *format_u1_2_report(char *p, const int *grades, double average_grade, const GradeStatus &status);
+
+/**
+ * @brief Writes the part of a grade report that follows the line of grades.
+ * @details Lets a caller stream the grades of a student it does not hold in memory and finish the
+ *          report with the same text as format_grade_report().
+ * @param p Write position with at least FORMAT_REPORT_MAX_LENGTH free bytes.
+ * @param average_grade Average of the grades.
+ * @param status Classification of the average.
+ * @return Position after the report.
+ */
+char *format_grade_summary(char *p, double average_grade, const GradeStatus &status);
+
+/**
+ * @brief Writes a grade report in the layout of u1_2() for any number of grades.
+ * @param p Write position.
+ * @param grades Grades of the student.
+ * @param count Number of grades, at least 1.
+ * @param average_grade Average of the grades.
+ * @param status Classification of the average.
+ * @return Position after the report.
+ */
+char *format_grade_report(char *p, const unsigned char *grades, size_t count, double average_grade,
+                          const GradeStatus &status);
+
+/**
+ * @brief Writes a u1_3() conversion.
+ * @param p Write position.
+ * @param currency Currency code, not necessarily NUL-terminated.
+ * @param length Length of the currency code in bytes.
+ * @param currency_value Rate of the currency to CZK.
+ * @param count Amount to convert.
+ * @param rounded_result Rounded result in CZK.
+ * @return Position after the conversion.
+ */
+char *format_u1_3_conversion(char *p, const char *currency, size_t length, double currency_value, int count,
+                             int rounded_result);
+
+#endif // ZSP_FORMAT_H
+
+/** End of format.h */
\ No newline at end of file
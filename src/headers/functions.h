@@ -14,7 +14,9 @@
  *          Function Prototypes:
  *          - void u1_1(): Calculate and display prices with VAT.
  *          - void u1_2(): Process and categorize student grades.
+ *          - GradeStatus grade_status(double): Categorize an average grade.
  *          - void u1_3(): Convert foreign currency amount to CZK.
+ *          - int round_half_up(double): Round the converted amount.
  *
  * @see functions.cpp for the implementation of these functions.
  *
@@ -45,6 +47,23 @@ void u1_1();
  */
 void u1_2();
 
+/**
+ * @brief Grade status flags as printed by u1_2.
+ */
+struct GradeStatus
+{
+    bool distinction; ///< Passed with distinction.
+    bool passed;      ///< Passed.
+    bool failed;      ///< Failed.
+};
+
+/**
+ * @brief Categorizes an average grade with the borders used by u1_2.
+ * @param average_grade Average of the student's grades.
+ * @return The status flags; all are false for an average outside 1-5.
+ */
+GradeStatus grade_status(double average_grade);
+
 /**
  * @brief Converts a given amount of foreign currency into Czech Koruna (CZK).
  * @details This function prompts the user for a currency abbreviation, its exchange rate to CZK,
@@ -53,6 +72,13 @@ void u1_2();
  */
 void u1_3();
 
+/**
+ * @brief Rounds a value to a whole number the way u1_3 rounds the converted amount.
+ * @param value Value to round; must fit into an int.
+ * @return The rounded value.
+ */
+int round_half_up(double value);
+
 #endif // ZSP_FUNCTIONS01_H
 
 /** End of functions.h */
\ No newline at end of file
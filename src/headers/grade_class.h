@@ -0,0 +1,115 @@
+/**
+ * @file grade_class.h
+ * @brief Branchless classification of grade sums without division.
+ * @details grade_status() classifies an average, which first costs a division by the number of
+ *          grades. Because the borders 1, 1.50, 4.00 and 5 are exact binary fractions and an average
+ *          of n integers can only come as close to them as 1/n, comparing the average with a border
+ *          gives the same answer as comparing the integer sum with the border multiplied by n. The
+ *          kernels declared here therefore compare the sums with per-count thresholds and produce
+ *          one class byte per student, using only comparisons and masks.
+ *
+ * @see grade_class.cpp for the implementation.
+ * @see functions.h for grade_status(), whose results these kernels reproduce.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_GRADE_CLASS_H
+#define ZSP_GRADE_CLASS_H
+#include "functions.h"
+#include <stddef.h>
+
+/**
+ * @brief Bits of a class byte.
+ * @details A valid average sets GRADE_PASSED or GRADE_FAILED and possibly GRADE_DISTINCTION; an
+ *          average outside 1-5, or a student without grades, sets only GRADE_INVALID.
+ */
+enum GradeClassBits
+{
+    GRADE_DISTINCTION = 1, ///< Average between 1 and 1.50.
+    GRADE_PASSED = 2,      ///< Average between 1 and 4.00.
+    GRADE_FAILED = 4,      ///< Average above 4.00 up to 5.
+    GRADE_INVALID = 8      ///< Average outside 1-5.
+};
+
+/**
+ * @brief Integer sum thresholds for one number of grades.
+ */
+struct GradeThresholds
+{
+    int min_sum;          ///< Smallest valid sum, BEST_GRADE * count.
+    int distinction_sum;  ///< Largest sum with distinction, floor(1.50 * count).
+    int pass_sum;         ///< Largest passing sum, 4 * count.
+    int max_sum;          ///< Largest valid sum, WORST_GRADE * count.
+};
+
+/**
+ * @brief Derives the thresholds for a number of grades; usable in constant expressions.
+ * @param count Number of grades, at most GRADE_CLASS_MAX_COUNT.
+ * @return The thresholds.
+ */
+constexpr GradeThresholds grade_thresholds(int count)
+{
+    return GradeThresholds{count, count + (count >> 1), 4 * count, 5 * count};
+}
+
+/** Largest number of grades per student the kernels accept; keeps every threshold far below 2^31. */
+const int GRADE_CLASS_MAX_COUNT = 1 << 24;
+
+/** Thresholds of u1_2(), fixed at compile time. */
+constexpr GradeThresholds U1_2_THRESHOLDS = grade_thresholds(5);
+
+/**
+ * @brief Classifies one sum.
+ * @param sum Sum of the grades.
+ * @param thresholds Thresholds of the number of grades.
+ * @return Class byte, a combination of GradeClassBits.
+ */
+unsigned char classify_grade_sum(int sum, const GradeThresholds &thresholds);
+
+/**
+ * @brief Classifies many sums that all have the same number of grades.
+ * @param sums Sums of the grades.
+ * @param count Number of grades of every student; 0 makes every student invalid.
+ * @param classes Receives one class byte per student.
+ * @param students Number of students.
+ */
+void classify_grade_sums(const int *sums, int count, unsigned char *classes, size_t students);
+
+/**
+ * @brief Classifies many sums, each with its own number of grades.
+ * @details Uses the AVX2 kernel when the CPU supports it.
+ * @param sums Sums of the grades.
+ * @param counts Number of grades of every student.
+ * @param classes Receives one class byte per student.
+ * @param students Number of students.
+ */
+void classify_grade_sums(const int *sums, const int *counts, unsigned char *classes, size_t students);
+
+/**
+ * @brief Portable scalar version of classify_grade_sums(); used as the reference in tests.
+ */
+void classify_grade_sums_scalar(const int *sums, const int *counts, unsigned char *classes, size_t students);
+
+/**
+ * @brief AVX2 version of classify_grade_sums(); must only be called when the CPU supports AVX2.
+ */
+void classify_grade_sums_avx2(const int *sums, const int *counts, unsigned char *classes, size_t students);
+
+/**
+ * @brief Converts a class byte to the flags printed by u1_2().
+ * @param grade_class Class byte.
+ * @return The three status flags.
+ */
+inline GradeStatus grade_status_from_class(unsigned char grade_class)
+{
+    GradeStatus status;
+    status.distinction = (grade_class & GRADE_DISTINCTION) != 0;
+    status.passed = (grade_class & GRADE_PASSED) != 0;
+    status.failed = (grade_class & GRADE_FAILED) != 0;
+    return status;
+}
+
+#endif // ZSP_GRADE_CLASS_H
+
+/** End of grade_class.h */
\ No newline at end of file
@@ -0,0 +1,131 @@
+/**
+ * @file gradebook.h
+ * @brief Columnar gradebook for students with any number of grades.
+ * @details u1_2() grades exactly one student with five grades. A gradebook holds many students,
+ *          each with their own number of grades, in structure-of-arrays form: the grades of all
+ *          students sit one after another in a single byte column, and an offset array marks where
+ *          every student starts. The sums of all students are then computed with vector reductions
+ *          over the column and classified by the branchless kernels of grade_class.h, with the same
+ *          result as grade_status() in u1_2().
+ *
+ * @see gradebook.cpp for the implementation.
+ * @see functions.h for u1_2() and grade_status().
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_GRADEBOOK_H
+#define ZSP_GRADEBOOK_H
+#include "buffered_io.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <vector>
+
+/**
+ * @brief Grades of many students in structure-of-arrays form.
+ * @details Student i owns the grades `grades[offsets[i]]` to `grades[offsets[i + 1] - 1]`, so
+ *          'offsets' always has one entry more than there are students.
+ */
+struct Gradebook
+{
+    std::vector<unsigned char> grades; ///< Grades of all students, one student after another.
+    std::vector<size_t> offsets;       ///< Start of every student's grades, followed by the end.
+
+    Gradebook() : offsets(1, 0)
+    {
+    }
+};
+
+/** Largest grade value a gradebook can store. */
+const int GRADEBOOK_MAX_GRADE = 255;
+
+/** Largest number of grades accepted for one student by gradebook_read(). */
+const size_t GRADEBOOK_MAX_GRADES = 1024;
+
+/** Number of students the batch modes read, reduce and format together. */
+const size_t GRADEBOOK_BLOCK_STUDENTS = 4096;
+
+/**
+ * @brief Removes all students and keeps the allocated memory.
+ * @param book Gradebook to clear.
+ */
+void gradebook_clear(Gradebook &book);
+
+/**
+ * @brief Returns the number of students in a gradebook.
+ * @param book Gradebook.
+ * @return Number of students.
+ */
+inline size_t gradebook_students(const Gradebook &book)
+{
+    return book.offsets.size() - 1;
+}
+
+/**
+ * @brief Computes the sum of the grades of every student.
+ * @details Uses SSE2 byte reductions where available.
+ * @param book Gradebook.
+ * @param sums Receives one sum per student.
+ */
+void gradebook_sums(const Gradebook &book, int *sums);
+
+/**
+ * @brief Portable scalar version of gradebook_sums(); used as the reference in tests.
+ */
+void gradebook_sums_scalar(const Gradebook &book, int *sums);
+
+/**
+ * @brief Computes the number of grades of every student.
+ * @param book Gradebook.
+ * @param counts Receives one count per student.
+ */
+void gradebook_counts(const Gradebook &book, int *counts);
+
+/**
+ * @brief Computes the average grade of every student.
+ * @details The average is the sum divided by the number of grades, which is exactly the value u1_2()
+ *          obtains by adding the grades as doubles. A student without grades gets an average of 0.
+ * @param sums Sums from gradebook_sums().
+ * @param counts Counts from gradebook_counts().
+ * @param averages Receives one average per student.
+ * @param students Number of students.
+ */
+void gradebook_averages(const int *sums, const int *counts, double *averages, size_t students);
+
+/**
+ * @brief Appends students from the input until the gradebook holds 'max_students' of them.
+ * @details Every line holds the grades of one student, between 1 and GRADEBOOK_MAX_GRADES of them,
+ *          each between 0 and GRADEBOOK_MAX_GRADE. Fewer students are appended only when the input
+ *          has no more records; the caller tells a clean end from a bad token with at_end().
+ * @param reader Source of the records.
+ * @param book Gradebook to append to.
+ * @param max_students Number of students the gradebook should hold afterwards.
+ * @return false if a record had a grade out of range, too many grades or a token that is not a
+ *         grade; the students before it are kept and the bad record is dropped entirely.
+ */
+bool gradebook_read(InputReader &reader, Gradebook &book, size_t max_students);
+
+/**
+ * @brief Kernel of u1_2_gradebook(); also usable with batch_parallel().
+ * @param reader Source of the records.
+ * @param out Buffer the reports are appended to.
+ * @return Same as u1_2_gradebook().
+ */
+long u1_2_gradebook_reports(InputReader &reader, OutputBuffer &out);
+
+/**
+ * @brief Prints the grade report for every student in the input.
+ *
+ * @details Each line holds the grades of one student, see gradebook_read(). The report has the
+ *          layout of u1_2() with all grades listed on the first line. Students are processed in
+ *          blocks, so the memory use does not depend on the size of the input.
+ *
+ * @param input Stream with the records.
+ * @param output Stream the reports are written to.
+ * @return Number of processed students, or -1 if the input contained a malformed record.
+ */
+long u1_2_gradebook(FILE *input, FILE *output);
+
+#endif // ZSP_GRADEBOOK_H
+
+/** End of gradebook.h */
\ No newline at end of file
@@ -0,0 +1,163 @@
+/**
+ * @file incremental_gradebook.h
+ * @brief Gradebook indexed by student ID that re-evaluates a student in constant time per edit.
+ * @details The batch modes evaluate every student from the raw grades. During grading season most
+ *          input consists of single-grade corrections against a book that is otherwise unchanged.
+ *          The IncrementalGradebook keeps a running sum and count for every student in a hash
+ *          index, so inserting, deleting or replacing one grade adjusts that student's average and
+ *          classification in O(1) without looking at the other grades or students. Only edits that
+ *          actually change a student's result are reported.
+ *
+ *          Edit stream format, one edit per line:
+ *
+ *              insert <id> <grade>
+ *              delete <id> <grade>
+ *              update <id> <old grade> <new grade>
+ *
+ *          The edits apply to an empty book or to one loaded from a text or packed gradebook file,
+ *          whose n-th student gets the ID n.
+ *
+ *          Every changed result is printed as one line:
+ *
+ *              Student 42: 2.33<tab>Prospěl s vyznamenáním: 0:Ne<tab>Prospěl: 1:Ano<tab>Neprospěl: 0:Ne
+ *
+ * @see incremental_gradebook.cpp for the implementation.
+ * @see grade_class.h for the classification.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_INCREMENTAL_GRADEBOOK_H
+#define ZSP_INCREMENTAL_GRADEBOOK_H
+#include <stddef.h>
+#include <stdio.h>
+#include <unordered_map>
+
+/** Number of grade values an incremental gradebook keeps counts for, BEST_GRADE to WORST_GRADE. */
+const int INCREMENTAL_GRADE_VALUES = 5;
+
+/**
+ * @brief Running totals of one student.
+ * @details The per-value counts let deletions and replacements be checked against the grades the
+ *          student actually has; the sum and count are kept alongside so nothing is recomputed.
+ */
+struct StudentTotals
+{
+    int sum;                                        ///< Sum of the grades.
+    int count;                                      ///< Number of grades.
+    unsigned grade_counts[INCREMENTAL_GRADE_VALUES]; ///< Number of grades of every value.
+    unsigned char grade_class;                      ///< Class byte of the current average.
+};
+
+/**
+ * @brief Outcome of one edit.
+ */
+enum EditResult
+{
+    EDIT_UNCHANGED, ///< The edit was applied; the average and classification stayed the same.
+    EDIT_CHANGED,   ///< The edit was applied and changed the average or the classification.
+    EDIT_REJECTED   ///< The grade was out of range or the student did not have it; nothing changed.
+};
+
+/**
+ * @class IncrementalGradebook
+ * @brief Hash index from student ID to running totals.
+ *
+ * @details A student enters the index with their first grade and leaves it when their last grade
+ *          is deleted. Grades must be between BEST_GRADE and WORST_GRADE.
+ */
+class IncrementalGradebook
+{
+  public:
+    /**
+     * @brief Creates an empty gradebook.
+     * @param expected_students Number of students to reserve index space for.
+     */
+    explicit IncrementalGradebook(size_t expected_students = 0);
+
+    /**
+     * @brief Adds a grade to a student, creating the student if needed.
+     * @param id Student ID.
+     * @param grade Grade to add.
+     * @return Outcome of the edit.
+     */
+    EditResult insert(int id, int grade);
+
+    /**
+     * @brief Removes one grade of the given value from a student.
+     * @param id Student ID.
+     * @param grade Grade to remove.
+     * @return Outcome of the edit; EDIT_REJECTED if the student has no such grade.
+     */
+    EditResult remove(int id, int grade);
+
+    /**
+     * @brief Replaces one grade of a student with another.
+     * @param id Student ID.
+     * @param old_grade Grade to replace.
+     * @param new_grade Grade to put in its place.
+     * @return Outcome of the edit; EDIT_REJECTED if the student has no such grade.
+     */
+    EditResult update(int id, int old_grade, int new_grade);
+
+    /**
+     * @brief Replaces the contents with a text gradebook in the format of u1_2_gradebook().
+     * @details The student on line n of the file gets the ID n, so edits can refer to the students
+     *          of an existing book without replaying its grades as insertions.
+     * @param input Stream with the gradebook.
+     * @return false if a record is malformed or has a grade outside BEST_GRADE to WORST_GRADE; the
+     *         gradebook is empty then.
+     */
+    bool load(FILE *input);
+
+    /**
+     * @brief Replaces the contents with a packed gradebook written by u1_2_pack(); see load().
+     * @details The student at index i of the file gets the ID i + 1; students without grades are
+     *          left out.
+     * @param input Stream with the packed gradebook.
+     * @return false if the file is not a valid packed gradebook or has a grade outside BEST_GRADE to
+     *         WORST_GRADE; the gradebook is empty then.
+     */
+    bool load_packed(FILE *input);
+
+    /**
+     * @brief Looks up a student.
+     * @param id Student ID.
+     * @return The totals, or NULL if the student has no grades. Valid until the next edit.
+     */
+    const StudentTotals *find(int id) const;
+
+    /**
+     * @brief Returns the number of students with at least one grade.
+     * @return Number of students.
+     */
+    size_t students() const;
+
+  private:
+    EditResult apply(int id, int removed, int added);
+    void add(int id, StudentTotals &totals);
+
+    std::unordered_map<int, StudentTotals> index;
+};
+
+/**
+ * @brief Applies an edit stream to an empty gradebook and prints every changed result.
+ * @details Rejected edits are reported as "Student <id>: neplatná oprava" and skipped.
+ * @param input Stream with the edits.
+ * @param output Stream the changed results are written to.
+ * @return Number of processed edits, or -1 if the input contained a malformed edit.
+ */
+long u1_2_edits(FILE *input, FILE *output);
+
+/**
+ * @brief Applies an edit stream to an existing gradebook; see u1_2_edits().
+ * @param book Gradebook to edit.
+ * @param input Stream with the edits.
+ * @param output Stream the changed results are written to.
+ * @return Same as u1_2_edits().
+ */
+long u1_2_edits(IncrementalGradebook &book, FILE *input, FILE *output);
+
+#endif // ZSP_INCREMENTAL_GRADEBOOK_H
+
+/** End of incremental_gradebook.h */
\ No newline at end of file
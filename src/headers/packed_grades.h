@@ -0,0 +1,158 @@
+/**
+ * @file packed_grades.h
+ * @brief Bit-packed binary gradebook format that is used straight from a memory mapping.
+ * @details Grades of 1 to 5 need three bits, yet text archives spend two bytes on each and u1_2()
+ *          holds them in four-byte ints. A packed gradebook file stores 21 three-bit grades in every
+ *          64-bit word, followed by a two-level index of the students:
+ *
+ *              header       PackedGradesHeader, 32 bytes
+ *              words        ceil(grades / 21) little-endian 64-bit words; grade i is bits 3(i % 21)
+ *                           to 3(i % 21) + 2 of word i / 21
+ *              counts       one byte per student with their number of grades, padded with zeros to
+ *                           a multiple of four bytes
+ *              checkpoints  students / 64 + 1 little-endian 32-bit grade indices; checkpoint k is
+ *                           the index of the first grade of student 64k
+ *
+ *          The offset of any student is a checkpoint plus at most 63 counts, so the index costs
+ *          little more than one byte per student. A PackedGradebook maps such a file and sums the
+ *          grades of a student directly on the packed words with three population counts per word,
+ *          so loading costs page faults only and the grades are never unpacked for averaging or
+ *          classification.
+ *
+ * @see packed_grades.cpp for the implementation.
+ * @see gradebook.h for the text format the files are converted from.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_PACKED_GRADES_H
+#define ZSP_PACKED_GRADES_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/** Number of bits per packed grade. */
+const int PACKED_GRADE_BITS = 3;
+
+/** Number of grades in one 64-bit word. */
+const int PACKED_GRADES_PER_WORD = 64 / PACKED_GRADE_BITS;
+
+/** Largest grade value a packed gradebook can store. */
+const int PACKED_MAX_GRADE = (1 << PACKED_GRADE_BITS) - 1;
+
+/** Largest number of grades of one student in a packed gradebook. */
+const int PACKED_MAX_COUNT = 255;
+
+/** Number of students between two checkpoints of the index. */
+const size_t PACKED_CHECKPOINT_STUDENTS = 64;
+
+/** Version of the file layout written by u1_2_pack(). */
+const uint32_t PACKED_GRADES_VERSION = 1;
+
+/**
+ * @brief File header of a packed gradebook.
+ */
+struct PackedGradesHeader
+{
+    char magic[8];           ///< "ZSPGRADE".
+    uint32_t version;        ///< PACKED_GRADES_VERSION.
+    uint32_t bits_per_grade; ///< PACKED_GRADE_BITS.
+    uint64_t students;       ///< Number of students.
+    uint64_t grades;         ///< Number of grades of all students together.
+};
+
+/**
+ * @class PackedGradebook
+ * @brief Read-only view of a packed gradebook file.
+ *
+ * @details Regular files are memory-mapped; other streams are read into memory once. The file is
+ *          checked when it is opened, so the accessors do no further validation.
+ */
+class PackedGradebook
+{
+  public:
+    PackedGradebook();
+    ~PackedGradebook();
+
+    /**
+     * @brief Opens a packed gradebook from a stream.
+     * @param input Stream positioned at the header; it is not closed.
+     * @return false if the data is not a valid packed gradebook.
+     */
+    bool open(FILE *input);
+
+    /**
+     * @brief Returns the number of students.
+     * @return Number of students.
+     */
+    size_t students() const;
+
+    /**
+     * @brief Returns the number of grades of a student.
+     * @param student Index of the student.
+     * @return Number of grades.
+     */
+    int count(size_t student) const;
+
+    /**
+     * @brief Returns the index of a student's first grade among all grades.
+     * @param student Index of the student.
+     * @return Grade index.
+     */
+    uint64_t offset(size_t student) const;
+
+    /**
+     * @brief Extracts one grade.
+     * @param position Index of the grade among all grades.
+     * @return The grade.
+     */
+    int grade(uint64_t position) const;
+
+    /**
+     * @brief Sums the grades of a range of students on the packed words.
+     * @param first Index of the first student.
+     * @param students Number of students.
+     * @param sums Receives one sum per student.
+     * @param counts Receives the number of grades of every student.
+     */
+    void sums(size_t first, size_t students, int *sums, int *counts) const;
+
+  private:
+    PackedGradebook(const PackedGradebook &);
+    PackedGradebook &operator=(const PackedGradebook &);
+
+    void close();
+
+    const unsigned char *data;
+    size_t size;
+    bool mapped;
+    const PackedGradesHeader *header;
+    const uint64_t *words;
+    const unsigned char *counts;
+    const uint32_t *checkpoints;
+};
+
+/**
+ * @brief Converts a text gradebook into the packed format.
+ * @details The input has the format of u1_2_gradebook() with grades of 0 to PACKED_MAX_GRADE and
+ *          at most PACKED_MAX_COUNT grades per student. The packed grades and the index are
+ *          collected in memory and written at the end, so the output may be a pipe.
+ * @param input Stream with the text gradebook.
+ * @param output Stream the packed gradebook is written to.
+ * @return Number of students, or -1 if the input contained a malformed record or a student that
+ *         does not fit the format. Nothing is written in that case.
+ */
+long u1_2_pack(FILE *input, FILE *output);
+
+/**
+ * @brief Prints the grade report of every student of a packed gradebook.
+ * @details The output is the same as that of u1_2_gradebook() over the original text.
+ * @param input Stream with the packed gradebook.
+ * @param output Stream the reports are written to.
+ * @return Number of students, or -1 if the input is not a valid packed gradebook.
+ */
+long u1_2_packed(FILE *input, FILE *output);
+
+#endif // ZSP_PACKED_GRADES_H
+
+/** End of packed_grades.h */
\ No newline at end of file
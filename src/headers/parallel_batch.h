@@ -0,0 +1,69 @@
+/**
+ * @file parallel_batch.h
+ * @brief Order-preserving parallel driver for the line-oriented batch modes.
+ * @details The input is cut into chunks of whole lines. Every chunk is parsed, priced and formatted
+ *          by a batch kernel on a ThreadPool worker into its own in-memory OutputBuffer, and the
+ *          finished chunks are written in input order. The output is therefore byte-for-byte the
+ *          same as that of the sequential driver, only produced on several cores.
+ *
+ *          Mapped input is handed to the workers in place; streamed input is copied chunk by chunk
+ *          out of the read buffer. At most a few chunks per worker are in flight, so memory use
+ *          stays bounded however long the input is.
+ *
+ *          The chunk driver itself, parallel_chunks(), is shared with other modes that split the input
+ *          the same way but combine partial results instead of concatenating output.
+ *
+ * @see parallel_batch.cpp for the implementation.
+ * @see batch.h for the kernels.
+ * @see thread_pool.h for the pool.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_PARALLEL_BATCH_H
+#define ZSP_PARALLEL_BATCH_H
+#include "batch.h"
+#include "buffered_io.h"
+#include <functional>
+#include <stdio.h>
+
+/**
+ * @brief Processes one chunk on a worker thread.
+ * @details Returns the rest of the chunk's work, which parallel_chunks() runs on the calling thread
+ *          in input order: e.g. writing the chunk's output or merging its partial result. That
+ *          function returns the number of records of the chunk, or -1 if the chunk was malformed.
+ */
+typedef std::function<std::function<long()>(InputReader &chunk)> ChunkProcessor;
+
+/**
+ * @brief Cuts the input into chunks of whole lines and processes them on several threads.
+ * @details At most a few chunks per worker are in flight. After a chunk reports -1, the chunks behind
+ *          it are not finished any more.
+ * @param input Stream with the records.
+ * @param threads Number of worker threads, at least 1.
+ * @param chunk_size Preferred number of input bytes per chunk.
+ * @param process Work on one chunk; called concurrently from the workers.
+ * @return Sum of the record counts of all chunks, or -1 if a chunk was malformed.
+ */
+long parallel_chunks(FILE *input, unsigned threads, size_t chunk_size, const ChunkProcessor &process);
+
+/**
+ * @brief Runs a batch kernel over chunks of the input on several threads.
+ *
+ * @details The kernel must handle records that each sit on a single line, which holds for the
+ *          u1_1, u1_2 and u1_3 batch formats but not for baskets.
+ *
+ * @param kernel Batch kernel, e.g. u1_1_receipts().
+ * @param input Stream with the records.
+ * @param output Stream the results are written to.
+ * @param threads Number of worker threads; 0 selects one per hardware thread, 1 runs the kernel
+ *                sequentially on the calling thread.
+ * @param chunk_size Preferred number of input bytes per chunk.
+ * @return Number of processed records, or -1 if the input contained a malformed record. Like in the
+ *         sequential driver, the results for the records before the malformed one are still written.
+ */
+long batch_parallel(BatchKernel kernel, FILE *input, FILE *output, unsigned threads, size_t chunk_size = 1 << 20);
+
+#endif // ZSP_PARALLEL_BATCH_H
+
+/** End of parallel_batch.h */
\ No newline at end of file
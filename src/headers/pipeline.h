@@ -0,0 +1,85 @@
+/**
+ * @file pipeline.h
+ * @brief Staged batch driver: reader, compute workers and writer joined by SPSC rings.
+ * @details batch_parallel() reads and writes on the calling thread, so reading stops whenever the
+ *          oldest chunk is written out. Here every stage has its own thread:
+ *
+ *              reader --> ring per worker --> worker --> ring per worker --> writer
+ *                 ^                                                          |
+ *                 +----------------------- free chunks <---------------------+
+ *
+ *          The reader cuts the input into chunks of whole lines and deals them round-robin to the
+ *          workers. Each worker runs the batch kernel on its chunks, and the writer collects the
+ *          chunks round-robin in the same order, so the output is that of the sequential driver
+ *          without any reordering buffer. Every ring has one producer and one consumer (see
+ *          spsc_ring.h).
+ *
+ *          A fixed pool of chunks circulates through the stages and comes back through the free
+ *          ring once written. When the writer or the workers fall behind, the reader runs out of
+ *          free chunks and waits, so memory stays bounded at about the pool size times the chunk
+ *          size.
+ *
+ * @see pipeline.cpp for the implementation.
+ * @see parallel_batch.h for the thread-pool driver.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_PIPELINE_H
+#define ZSP_PIPELINE_H
+#include "batch.h"
+#include <stdio.h>
+
+/** Chunks in circulation per worker. */
+const unsigned PIPELINE_CHUNKS_PER_WORKER = 4;
+
+/**
+ * @brief Work and waiting time of one stage.
+ */
+struct PipelineStage
+{
+    double busy_seconds;         ///< Time spent reading, computing or writing; summed over workers.
+    double waiting_seconds;      ///< Time spent waiting for a neighbouring stage.
+    unsigned long long chunks;   ///< Chunks handled.
+    unsigned long long bytes;    ///< Input bytes read, or output bytes computed or written.
+};
+
+/**
+ * @brief Statistics of one pipeline run.
+ */
+struct PipelineStats
+{
+    PipelineStage reader;  ///< Input stage.
+    PipelineStage compute; ///< All workers together.
+    PipelineStage writer;  ///< Output stage.
+    unsigned workers;      ///< Number of compute workers.
+    double seconds;        ///< Wall-clock time of the whole run.
+};
+
+/**
+ * @brief Runs a batch kernel as a three-stage pipeline.
+ *
+ * @details Like batch_parallel(), the kernel must handle records that each sit on a single line.
+ *
+ * @param kernel Batch kernel, e.g. u1_1_receipts().
+ * @param input Stream with the records.
+ * @param output Stream the results are written to.
+ * @param workers Number of compute workers; 0 selects one per hardware thread.
+ * @param stats Receives the statistics of the run; may be NULL.
+ * @param chunk_size Preferred number of input bytes per chunk.
+ * @return Number of processed records, or -1 if the input contained a malformed record. The
+ *         results for the records before the malformed one are still written.
+ */
+long batch_pipeline(BatchKernel kernel, FILE *input, FILE *output, unsigned workers, PipelineStats *stats = NULL,
+                    size_t chunk_size = 1 << 20);
+
+/**
+ * @brief Prints the statistics of a run, one line per stage with its throughput.
+ * @param stats Statistics from batch_pipeline().
+ * @param output Stream to print to, usually stderr.
+ */
+void print_pipeline_stats(const PipelineStats &stats, FILE *output);
+
+#endif // ZSP_PIPELINE_H
+
+/** End of pipeline.h */
\ No newline at end of file
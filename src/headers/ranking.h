@@ -0,0 +1,161 @@
+/**
+ * @file ranking.h
+ * @brief Streaming top-k and bottom-k ranking of students by their average grade.
+ * @details The ranking mode reads the --gradebook input and keeps, for the whole cohort and for
+ *          every grade class, the k best and the k worst students in bounded heaps. Each student
+ *          costs O(log k) and the memory does not grow with the cohort, so the registrar gets the
+ *          best and worst students in the same single pass that computes the averages.
+ *
+ *          Students are numbered by their line in the input, starting at 1. Averages are compared
+ *          exactly as fractions of the integer grade sum and count; equal averages are ordered by
+ *          the student number, the lower number first, in both the best and the worst list. The
+ *          order is therefore total and the result does not depend on the order in which partial
+ *          rankings are merged.
+ *
+ * @see ranking.cpp for the implementation.
+ * @see grade_class.h for the classes.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_RANKING_H
+#define ZSP_RANKING_H
+#include <stddef.h>
+#include <stdio.h>
+#include <vector>
+
+/**
+ * @brief Groups of students that are ranked separately.
+ * @details A student is ranked in RANK_ALL if their average is valid, and in the partition of every
+ *          class bit that is set, so a student with distinction is also ranked among those who passed.
+ */
+enum RankingPartition
+{
+    RANK_ALL,         ///< All students with a valid average.
+    RANK_DISTINCTION, ///< Students with GRADE_DISTINCTION.
+    RANK_PASSED,      ///< Students with GRADE_PASSED.
+    RANK_FAILED,      ///< Students with GRADE_FAILED.
+    RANKING_PARTITIONS
+};
+
+/** Number of students in each list when the ranking mode is run without a size. */
+const size_t RANKING_DEFAULT_SIZE = 10;
+
+/**
+ * @brief One ranked student.
+ */
+struct RankedStudent
+{
+    long long student; ///< Line of the student in the input, starting at 1.
+    int sum;           ///< Sum of the grades.
+    int count;         ///< Number of grades.
+};
+
+/**
+ * @class StudentRanking
+ * @brief Keeps the best and the worst students of every partition.
+ *
+ * @details Two rankings can be merged; the student numbers of the merged one may be shifted, so a
+ *          ranking of a slice of the input can number its students from 1 and be placed behind the
+ *          slices before it.
+ */
+class StudentRanking
+{
+  public:
+    /**
+     * @brief Creates an empty ranking.
+     * @param size Number of students kept in every list, k.
+     */
+    explicit StudentRanking(size_t size = RANKING_DEFAULT_SIZE);
+
+    /**
+     * @brief Offers one student to every list they belong to.
+     * @param student Student number.
+     * @param sum Sum of the grades.
+     * @param count Number of grades.
+     * @param grade_class Class byte from classify_grade_sums().
+     */
+    void add(long long student, int sum, int count, unsigned char grade_class);
+
+    /**
+     * @brief Offers a block of consecutive students.
+     * @param first_student Number of the first student of the block.
+     * @param sums Sums of the grades.
+     * @param counts Number of grades of every student.
+     * @param classes Class bytes.
+     * @param students Number of students.
+     */
+    void add(long long first_student, const int *sums, const int *counts, const unsigned char *classes,
+             size_t students);
+
+    /**
+     * @brief Offers every student kept by another ranking.
+     * @param other Ranking to merge in; must have the same size.
+     * @param student_offset Added to the student numbers of 'other'.
+     */
+    void merge(const StudentRanking &other, long long student_offset = 0);
+
+    /**
+     * @brief Returns the best students of a partition, best first.
+     * @param partition One of RankingPartition.
+     * @return At most size() students.
+     */
+    std::vector<RankedStudent> best(int partition) const;
+
+    /**
+     * @brief Returns the worst students of a partition, worst first.
+     * @param partition One of RankingPartition.
+     * @return At most size() students.
+     */
+    std::vector<RankedStudent> worst(int partition) const;
+
+    /**
+     * @brief Returns the number of students kept in every list.
+     * @return k.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the longest text format() can produce.
+     * @return Length in bytes.
+     */
+    size_t format_max_length() const;
+
+    /**
+     * @brief Writes both lists of every partition.
+     * @param p Write position with at least format_max_length() free bytes.
+     * @return Position after the text.
+     */
+    char *format(char *p) const;
+
+  private:
+    size_t limit;
+    std::vector<RankedStudent> best_heaps[RANKING_PARTITIONS];  ///< Max-heaps, the weakest kept on top.
+    std::vector<RankedStudent> worst_heaps[RANKING_PARTITIONS]; ///< Max-heaps, the strongest kept on top.
+};
+
+/**
+ * @brief Prints the best and the worst students of the input.
+ * @details The input has the format of u1_2_gradebook(): one student per line.
+ * @param input Stream with the records.
+ * @param output Stream the ranking is written to.
+ * @return Number of processed students, or -1 if the input contained a malformed record. Nothing is
+ *         written then.
+ */
+long u1_2_ranking(FILE *input, FILE *output);
+
+/**
+ * @brief Prints the best and the worst students of the input, ranked on several threads.
+ * @details The input is cut into chunks of whole lines; every chunk is ranked on its own and the
+ *          partial rankings are merged in input order.
+ * @param input Stream with the records.
+ * @param output Stream the ranking is written to.
+ * @param size Number of students in every list.
+ * @param threads Number of worker threads; 0 uses one per hardware thread.
+ * @return Same as the single-threaded version.
+ */
+long u1_2_ranking(FILE *input, FILE *output, size_t size, unsigned threads);
+
+#endif // ZSP_RANKING_H
+
+/** End of ranking.h */
\ No newline at end of file
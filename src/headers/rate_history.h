@@ -0,0 +1,145 @@
+/**
+ * @file rate_history.h
+ * @brief Historical exchange rates with as-of-time conversions.
+ * @details Reconciliations convert a transaction at the rate that was valid when it happened. The
+ *          RateHistory is built from rate-history files with lines `CODE time rate`, where the time
+ *          is in seconds since the Unix epoch and the rate to CZK is valid from that time until the
+ *          next point of the same currency.
+ *
+ *          Every currency keeps its points as two sorted arrays, times and rates, plus a copy of the
+ *          times in Eytzinger (breadth-first) order for searching: the first levels of the implicit
+ *          tree share a few cache lines, and the search loop has no unpredictable branch.
+ *
+ *          Batches sorted by time do not search at all: a RateHistory::Cursor remembers the
+ *          position of every currency and moves it forward like a merge, so a year of transactions
+ *          costs one pass over the records and one over the points. A record earlier than the one
+ *          before falls back to a search.
+ *
+ * @see rate_history.cpp for the implementation.
+ * @see rate_table.h for the currency slots shared with the rate table.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_RATE_HISTORY_H
+#define ZSP_RATE_HISTORY_H
+#include "buffered_io.h"
+#include "currency_code.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+/**
+ * @class RateHistory
+ * @brief Time series of the rates of every currency.
+ */
+class RateHistory
+{
+  public:
+    RateHistory();
+
+    /**
+     * @brief Adds one point; the history must be finalised before it is queried again.
+     * @param code Currency code.
+     * @param time Start of validity, seconds since the epoch.
+     * @param rate Rate to CZK.
+     * @return false if the code is not in the ISO 4217 list.
+     */
+    bool add(const CurrencyCode &code, long long time, double rate);
+
+    /**
+     * @brief Sorts the points added since the last call and rebuilds the search index.
+     * @details Of several points of a currency with the same time, the one added last is kept.
+     */
+    void finalize();
+
+    /**
+     * @brief Adds every point of a rate-history file and finalises the history.
+     * @param input Stream with `CODE time rate` lines, in any order.
+     * @return false if a line is malformed, its code is not in the ISO 4217 list or its rate is not
+     *         positive; the points before it are kept.
+     */
+    bool load(FILE *input);
+
+    /**
+     * @brief Looks up the rate valid at a time by searching the index.
+     * @param code Currency code.
+     * @param time Time of the conversion.
+     * @param rate Receives the rate.
+     * @param since Receives the time the rate became valid.
+     * @return false if the currency has no point at or before the time.
+     */
+    bool rate_at(const CurrencyCode &code, long long time, double &rate, long long &since) const;
+
+    /**
+     * @brief Returns the number of points of all currencies.
+     * @return Number of points.
+     */
+    size_t points() const;
+
+    /**
+     * @class Cursor
+     * @brief Sweeps through the history for records in ascending time order.
+     */
+    class Cursor
+    {
+      public:
+        /**
+         * @brief Creates a cursor positioned before every point.
+         * @param history Finalised history; must outlive the cursor and stay unchanged.
+         */
+        explicit Cursor(const RateHistory &history);
+
+        /**
+         * @brief Looks up the rate valid at a time, moving forward from the previous lookup.
+         * @details Gives the same result as RateHistory::rate_at() for any order of times; times
+         *          that do not decrease per currency are found by advancing, others by a search.
+         * @param code Currency code.
+         * @param time Time of the conversion.
+         * @param rate Receives the rate.
+         * @param since Receives the time the rate became valid.
+         * @return false if the currency has no point at or before the time.
+         */
+        bool rate_at(const CurrencyCode &code, long long time, double &rate, long long &since);
+
+      private:
+        const RateHistory &history;
+        std::vector<long long> positions; ///< Last found point of every series, or -1.
+    };
+
+  private:
+    /**
+     * @brief Points of one currency.
+     */
+    struct Series
+    {
+        std::vector<long long> times; ///< Start times, ascending.
+        std::vector<double> rates;    ///< Rate from each start time on.
+        std::vector<long long> tree;  ///< Times in Eytzinger order, 1-based.
+        std::vector<uint32_t> ranks;  ///< Position in 'times' of every tree node.
+        bool sorted;                  ///< Cleared when a point is added.
+    };
+
+    int series_of(const CurrencyCode &code) const;
+    static long long search(const Series &series, long long time);
+
+    std::vector<Series> series;
+    std::vector<int> slots; ///< Series of every RateTable slot, or -1.
+    size_t total;
+};
+
+/**
+ * @brief Converts every (currency, time, amount) record at the rate valid at its time.
+ * @details The text of a conversion is the one of u1_3() followed by `Kurz platný od: <time>`. The
+ *          records are looked up with a Cursor, so input sorted by time is handled as one sweep.
+ * @param history Finalised rate history.
+ * @param reader Source of the records.
+ * @param out Buffer the conversions are appended to.
+ * @return Number of processed records, or -1 if a record was malformed or its currency had no rate
+ *         at its time.
+ */
+long u1_3_history_conversions(const RateHistory &history, InputReader &reader, OutputBuffer &out);
+
+#endif // ZSP_RATE_HISTORY_H
+
+/** End of rate_history.h */
\ No newline at end of file
@@ -0,0 +1,203 @@
+/**
+ * @file rate_snapshot.h
+ * @brief Versioned rate snapshots with lock-free readers and hot reload from a rate file.
+ * @details Rates change several times a day, while conversions keep running. A RateSnapshot is an
+ *          immutable RateTable with a version number. RateSnapshots publishes a new snapshot by
+ *          swapping one atomic pointer, so converter threads keep reading the snapshot they hold
+ *          and pick up the new one with their next acquire, without ever taking a lock.
+ *
+ *          Old snapshots are reclaimed with hazard pointers: a reader announces the snapshot it is
+ *          about to use in a slot of its own, and a replaced snapshot is freed only once no slot
+ *          announces it. Readers only load and store atomics; the writer side is serialised by a
+ *          mutex, which readers never touch.
+ *
+ *          RateFileWatcher polls a rate file and publishes a new snapshot whenever the file has
+ *          changed and still loads, so a reload needs nothing but a local file.
+ *
+ * @see rate_snapshot.cpp for the implementation.
+ * @see rate_table.h for the table and the rate file format.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_RATE_SNAPSHOT_H
+#define ZSP_RATE_SNAPSHOT_H
+#include "rate_table.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** Largest number of readers that can hold a snapshot at the same time. */
+const size_t RATE_SNAPSHOT_READERS = 64;
+
+/**
+ * @brief Immutable rate table with its version.
+ */
+struct RateSnapshot
+{
+    RateTable rates;            ///< Rates of this version.
+    unsigned long long version; ///< Version, counted from 1 in publishing order.
+};
+
+/**
+ * @class RateSnapshots
+ * @brief Holds the current snapshot and reclaims the replaced ones.
+ */
+class RateSnapshots
+{
+  public:
+    RateSnapshots();
+
+    /**
+     * @brief Frees every snapshot; no Reader may be alive any more.
+     */
+    ~RateSnapshots();
+
+    /**
+     * @brief Makes a table the current snapshot.
+     * @details Snapshots replaced earlier are freed as soon as no reader holds them.
+     * @param rates Rates of the new snapshot.
+     * @return Version of the new snapshot.
+     */
+    unsigned long long publish(const RateTable &rates);
+
+    /**
+     * @brief Returns the version of the current snapshot.
+     * @return Version, or 0 if nothing has been published yet.
+     */
+    unsigned long long version() const;
+
+    /**
+     * @brief Returns the number of replaced snapshots that are not freed yet.
+     * @return Number of snapshots.
+     */
+    size_t retired() const;
+
+    /**
+     * @class Reader
+     * @brief Lock-free access of one thread to the current snapshot.
+     *
+     * @details A reader owns one hazard slot for its lifetime. The snapshot returned by acquire()
+     *          stays valid until the next acquire() or release() of the same reader.
+     */
+    class Reader
+    {
+      public:
+        /**
+         * @brief Claims a hazard slot, waiting while all RATE_SNAPSHOT_READERS slots are in use.
+         * @param snapshots Snapshots to read.
+         */
+        explicit Reader(RateSnapshots &snapshots);
+        ~Reader();
+
+        /**
+         * @brief Returns the current snapshot and protects it from reclamation.
+         * @return Snapshot, or NULL if nothing has been published yet.
+         */
+        const RateSnapshot *acquire();
+
+        /**
+         * @brief Gives up the snapshot returned by acquire().
+         */
+        void release();
+
+      private:
+        Reader(const Reader &);
+        Reader &operator=(const Reader &);
+
+        RateSnapshots &owner;
+        size_t slot;
+    };
+
+  private:
+    RateSnapshots(const RateSnapshots &);
+    RateSnapshots &operator=(const RateSnapshots &);
+
+    void reclaim();
+
+    std::atomic<const RateSnapshot *> current;
+    std::atomic<const RateSnapshot *> hazards[RATE_SNAPSHOT_READERS];
+    std::atomic<bool> claimed[RATE_SNAPSHOT_READERS];
+
+    mutable std::mutex writer; ///< Serialises publishers; never taken by readers.
+    std::vector<const RateSnapshot *> replaced;
+    unsigned long long versions;
+};
+
+/**
+ * @class RateFileWatcher
+ * @brief Publishes a new snapshot whenever a rate file changes.
+ *
+ * @details A change is detected from the device, inode, size and modification time of the file, so
+ *          both rewriting the file in place and renaming a new file over it are noticed. A file
+ *          that does not load, including an empty one, keeps the previous snapshot in place; it is
+ *          tried again once it changes once more. A file whose size or modification time changes
+ *          while it is read is not published and is read again on the next check.
+ */
+class RateFileWatcher
+{
+  public:
+    /**
+     * @brief Creates a watcher; nothing is loaded before the first check().
+     * @param path Path of the rate file.
+     * @param snapshots Snapshots to publish to.
+     */
+    RateFileWatcher(const char *path, RateSnapshots &snapshots);
+
+    /**
+     * @brief Stops the polling thread, if it runs.
+     */
+    ~RateFileWatcher();
+
+    /**
+     * @brief Reloads the file if it changed since the last check.
+     * @return true if a new snapshot was published.
+     */
+    bool check();
+
+    /**
+     * @brief Starts a thread that calls check() periodically.
+     * @param interval_ms Time between two checks in milliseconds.
+     */
+    void start(unsigned interval_ms);
+
+    /**
+     * @brief Stops the polling thread.
+     */
+    void stop();
+
+  private:
+    RateFileWatcher(const RateFileWatcher &);
+    RateFileWatcher &operator=(const RateFileWatcher &);
+
+    std::string path;
+    RateSnapshots &snapshots;
+    unsigned long long identity[5]; ///< Device, inode, size and modification time of the last check.
+    bool seen;                      ///< Set once identity holds a real file.
+
+    std::thread poller;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopping;
+};
+
+/**
+ * @brief Prints the conversion for every (currency, amount) record with the newest published rates.
+ * @details Every record acquires the current snapshot on its own, so a snapshot published while the
+ *          input is processed applies from the next record on. Each conversion has the text of
+ *          u1_3_quotes() followed by a line `Verze kurzů: <version>` naming the snapshot it used.
+ * @param snapshots Published rates.
+ * @param reader Source of the records.
+ * @param out Buffer the conversions are appended to.
+ * @return Number of processed records, or -1 if a record was malformed, its currency had no rate
+ *         or no snapshot was published.
+ */
+long u1_3_live_quotes(RateSnapshots &snapshots, InputReader &reader, OutputBuffer &out);
+
+#endif // ZSP_RATE_SNAPSHOT_H
+
+/** End of rate_snapshot.h */
\ No newline at end of file
@@ -0,0 +1,208 @@
+/**
+ * @file rate_table.h
+ * @brief Exchange-rate table keyed by ISO 4217 currency codes.
+ * @details u1_3() and the exchange batch mode take the rate with every record. The quote mode
+ *          instead loads all rates once from a rate file and then reads only `code amount` per
+ *          record, so neither the rate nor its text has to be sent and parsed again.
+ *
+ *          A three-letter code is packed into a 15-bit key, five bits per letter. The set of ISO
+ *          4217 codes is known, so the table uses a perfect hash for it: one multiplication and
+ *          shift maps every code of the list to its own slot of a 2048-slot table. The multiplier
+ *          was found by a search over the code list and rate_table.cpp checks at compile time that
+ *          no two codes share a slot. A lookup is therefore a single probe: compare the key stored
+ *          in the slot and read the rate next to it.
+ *
+ * @see rate_table.cpp for the implementation and the code list.
+ * @see batch.h for the exchange batch mode that takes the rate with every record.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_RATE_TABLE_H
+#define ZSP_RATE_TABLE_H
+#include "buffered_io.h"
+#include "currency_code.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/** Number of bits of a slot index. */
+const int RATE_HASH_BITS = 11;
+
+/** Number of slots in a RateTable. */
+const size_t RATE_TABLE_SLOTS = (size_t)1 << RATE_HASH_BITS;
+
+/** Multiplier of the perfect hash over the ISO 4217 codes. */
+const uint32_t RATE_HASH_MULTIPLIER = 0x63bc6b61u;
+
+/** Key of an empty slot; no three-letter code packs to it. */
+const uint16_t RATE_EMPTY_KEY = 0xffff;
+
+/**
+ * @brief Packs a three-letter code into its 15-bit key.
+ * @param code Three uppercase ASCII letters.
+ * @return Key.
+ */
+constexpr uint32_t currency_key(const char *code)
+{
+    return (uint32_t)(code[0] - 'A') << 10 | (uint32_t)(code[1] - 'A') << 5 | (uint32_t)(code[2] - 'A');
+}
+
+/**
+ * @brief Returns the slot of a key.
+ * @param key Key from currency_key().
+ * @return Slot index below RATE_TABLE_SLOTS.
+ */
+constexpr uint32_t currency_slot(uint32_t key)
+{
+    return (uint32_t)(key * RATE_HASH_MULTIPLIER) >> (32 - RATE_HASH_BITS);
+}
+
+/**
+ * @brief Checks a code and packs it into its key.
+ * @param code Code, not necessarily NUL-terminated.
+ * @param length Length of the code in bytes.
+ * @param key Receives the key.
+ * @return true if the code consists of exactly three uppercase ASCII letters.
+ */
+inline bool currency_key(const char *code, size_t length, uint32_t &key)
+{
+    if (length != 3 || (unsigned)(code[0] - 'A') >= 26 || (unsigned)(code[1] - 'A') >= 26 ||
+        (unsigned)(code[2] - 'A') >= 26)
+    {
+        return false;
+    }
+    key = currency_key(code);
+    return true;
+}
+
+/**
+ * @brief Unpacks a key into its three letters.
+ * @param key Key from currency_key().
+ * @param letters Receives three letters, not NUL-terminated.
+ */
+inline void currency_letters(uint32_t key, char *letters)
+{
+    letters[0] = (char)('A' + (key >> 10 & 31));
+    letters[1] = (char)('A' + (key >> 5 & 31));
+    letters[2] = (char)('A' + (key & 31));
+}
+
+/**
+ * @brief Tells whether a key belongs to a code of the ISO 4217 list.
+ * @param key Key from currency_key().
+ * @return true for an ISO 4217 code.
+ */
+bool is_iso_currency(uint32_t key);
+
+/**
+ * @class RateTable
+ * @brief Rates to CZK of the ISO 4217 currencies, one slot per code.
+ */
+class RateTable
+{
+  public:
+    RateTable();
+
+    /**
+     * @brief Sets the rate of a currency, replacing an earlier one.
+     * @param code Currency code, not necessarily NUL-terminated.
+     * @param length Length of the code in bytes.
+     * @param rate Rate of the currency to CZK.
+     * @return false if the code is not in the ISO 4217 list.
+     */
+    bool set(const char *code, size_t length, double rate);
+
+    /**
+     * @brief Looks up the rate of a currency with a single probe.
+     * @param code Currency code, not necessarily NUL-terminated.
+     * @param length Length of the code in bytes.
+     * @param rate Receives the rate.
+     * @return false if the table has no rate for the code.
+     */
+    bool find(const char *code, size_t length, double &rate) const
+    {
+        uint32_t key = 0;
+        if (!currency_key(code, length, key))
+        {
+            return false;
+        }
+        uint32_t slot = currency_slot(key);
+        rate = rates[slot];
+        return keys[slot] == key;
+    }
+
+    /**
+     * @brief Looks up the rate of a packed currency code with a single probe.
+     * @param code Code; interned codes are never ISO codes and have no rate.
+     * @param rate Receives the rate.
+     * @return false if the table has no rate for the code.
+     */
+    bool find(const CurrencyCode &code, double &rate) const
+    {
+        return code.tag == CURRENCY_INLINE && find(code.bytes, 3, rate);
+    }
+
+    /**
+     * @brief Returns the number of currencies with a rate.
+     * @return Number of currencies.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Lists the currencies with a rate.
+     * @param keys Receives size() keys in ascending, i.e. alphabetical, order.
+     * @param rates Receives the rate of every listed currency.
+     */
+    void list(uint32_t *keys, double *rates) const;
+
+    /**
+     * @brief Loads rates from a rate file.
+     * @details Every line holds a currency code and its rate to CZK, e.g. `EUR 24.35`. A later line
+     *          for the same code replaces the earlier rate.
+     * @param input Stream with the rate file.
+     * @return false if a line is malformed, its code is not in the ISO 4217 list or its rate is not
+     *         a positive number, or if the table is still empty afterwards; the rates before a bad
+     *         line are kept.
+     */
+    bool load(FILE *input);
+
+  private:
+    uint16_t keys[RATE_TABLE_SLOTS]; ///< Key of the code in every slot, or RATE_EMPTY_KEY.
+    double rates[RATE_TABLE_SLOTS];  ///< Rate of the code in every slot.
+    size_t count;
+};
+
+/**
+ * @brief Reads the currency code that starts a rate or quote record.
+ * @details The rate file, the quote records and the history files all start a record this way; the
+ *          caller reads the remaining fields with the reader.
+ * @param reader Source of the records.
+ * @param code Receives the code of a three-byte word.
+ * @param valid Set to false if the word is not a three-byte code; left unchanged otherwise.
+ * @return false if no word remained, so the records ended.
+ */
+bool next_currency_code(InputReader &reader, CurrencyCode &code, bool &valid);
+
+/**
+ * @brief Prints the conversion for every (currency, amount) record, taking the rates from a table.
+ * @details The text of a conversion is the same as u1_3() prints for the rate from the table.
+ * @param rates Rate table.
+ * @param reader Source of the records.
+ * @param out Buffer the conversions are appended to.
+ * @return Number of processed records, or -1 if a record was malformed or its currency has no rate.
+ */
+long u1_3_quotes(const RateTable &rates, InputReader &reader, OutputBuffer &out);
+
+/**
+ * @brief Stream version of the quote mode; see above.
+ * @param rates Rate table.
+ * @param input Stream with the records.
+ * @param output Stream the conversions are written to.
+ * @return Same as the kernel.
+ */
+long u1_3_quotes(const RateTable &rates, FILE *input, FILE *output);
+
+#endif // ZSP_RATE_TABLE_H
+
+/** End of rate_table.h */
\ No newline at end of file
@@ -0,0 +1,168 @@
+/**
+ * @file spsc_ring.h
+ * @brief Bounded lock-free ring buffer for one producer and one consumer thread.
+ * @details The producer only writes 'tail' and the consumer only writes 'head', each on its own
+ *          cache line, so a transfer costs one release store and no read-modify-write. Both sides
+ *          also keep a private copy of the other side's index and reload the shared one only when
+ *          the copy says the ring is full or empty.
+ *
+ *          The blocking push() and pop() wait by yielding and then by sleeping for growing
+ *          intervals, so a stage that waits for a slow neighbour does not keep a core busy.
+ *
+ * @see pipeline.h for the staged batch driver built on it.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_SPSC_RING_H
+#define ZSP_SPSC_RING_H
+#include <atomic>
+#include <chrono>
+#include <stddef.h>
+#include <thread>
+#include <vector>
+
+/** Assumed size of a cache line; the indices of the two sides are kept this far apart. */
+const size_t SPSC_CACHE_LINE = 64;
+
+/**
+ * @class SpscRing
+ * @brief Fixed-capacity FIFO between exactly one producer and one consumer thread.
+ * @tparam T Element type; copied in and out, so small values or pointers are the intended use.
+ */
+template <typename T>
+class SpscRing
+{
+  public:
+    /**
+     * @brief Creates an empty ring.
+     * @param capacity Minimum number of elements; rounded up to a power of two.
+     */
+    explicit SpscRing(size_t capacity) : head(0), cached_tail(0), tail(0), cached_head(0), closed(false)
+    {
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    /**
+     * @brief Appends an element if there is room; producer only.
+     * @return false if the ring is full.
+     */
+    bool try_push(const T &value)
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (position - cached_head > mask)
+        {
+            cached_head = head.load(std::memory_order_acquire);
+            if (position - cached_head > mask)
+            {
+                return false;
+            }
+        }
+        slots[position & mask] = value;
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest element if there is one; consumer only.
+     * @return false if the ring is empty.
+     */
+    bool try_pop(T &value)
+    {
+        size_t position = head.load(std::memory_order_relaxed);
+        if (position == cached_tail)
+        {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (position == cached_tail)
+            {
+                return false;
+            }
+        }
+        value = slots[position & mask];
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Appends an element, waiting while the ring is full; producer only.
+     */
+    void push(const T &value)
+    {
+        for (unsigned round = 0; !try_push(value); round++)
+        {
+            pause(round);
+        }
+    }
+
+    /**
+     * @brief Removes the oldest element, waiting while the ring is empty; consumer only.
+     * @return false once the ring is closed and every element has been taken.
+     */
+    bool pop(T &value)
+    {
+        for (unsigned round = 0; !try_pop(value); round++)
+        {
+            if (closed.load(std::memory_order_acquire))
+            {
+                // Elements pushed before close() are visible now.
+                return try_pop(value);
+            }
+            pause(round);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Marks the end of the stream; producer only, after its last push.
+     */
+    void close()
+    {
+        closed.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Returns the number of elements the ring holds when full.
+     * @return Capacity.
+     */
+    size_t capacity() const
+    {
+        return mask + 1;
+    }
+
+  private:
+    SpscRing(const SpscRing &);
+    SpscRing &operator=(const SpscRing &);
+
+    static void pause(unsigned round)
+    {
+        if (round < 64)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(round < 256 ? 20 : 200));
+        }
+    }
+
+    // Padding instead of alignas: over-aligned types need the aligned operator new of C++17.
+    std::atomic<size_t> head; ///< Next element to take; written by the consumer.
+    size_t cached_tail;       ///< Consumer's copy of 'tail'.
+    char consumer_padding[SPSC_CACHE_LINE - 2 * sizeof(size_t)];
+    std::atomic<size_t> tail; ///< Next free slot; written by the producer.
+    size_t cached_head;       ///< Producer's copy of 'head'.
+    char producer_padding[SPSC_CACHE_LINE - 2 * sizeof(size_t)];
+    std::atomic<bool> closed;
+    std::vector<T> slots;
+    size_t mask;
+};
+
+#endif // ZSP_SPSC_RING_H
+
+/** End of spsc_ring.h */
\ No newline at end of file
@@ -0,0 +1,93 @@
+/**
+ * @file thread_pool.h
+ * @brief Fixed-size work-stealing thread pool for the parallel batch modes.
+ * @details Every worker owns a double-ended task queue. A worker takes its own tasks from the back of
+ *          its queue, newest first, which keeps the data of a task it has just produced in its cache.
+ *          A worker whose queue runs dry steals the oldest task from the front of another worker's
+ *          queue, so uneven chunks (long receipts, slow lines) do not leave cores idle while one
+ *          queue is still full.
+ *
+ * @see thread_pool.cpp for the implementation.
+ * @see parallel_batch.h for the order-preserving batch driver built on the pool.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_THREAD_POOL_H
+#define ZSP_THREAD_POOL_H
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Runs submitted tasks on a fixed set of worker threads.
+ *
+ * @details Tasks submitted from outside the pool are spread over the worker queues round-robin;
+ *          tasks submitted from inside a task go to the queue of the worker running it. The pool
+ *          gives no ordering guarantee; callers that need ordered results collect them themselves.
+ */
+class ThreadPool
+{
+  public:
+    /**
+     * @brief Starts the worker threads.
+     * @param threads Number of workers; 0 selects default_threads().
+     */
+    explicit ThreadPool(unsigned threads);
+
+    /**
+     * @brief Runs all tasks that are still queued, then stops and joins the workers.
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Queues a task for execution.
+     * @param task Function to run on one of the workers.
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Returns the number of worker threads.
+     * @return Number of workers.
+     */
+    unsigned size() const;
+
+    /**
+     * @brief Returns the number of hardware threads, or 1 if it cannot be determined.
+     * @return Suggested number of workers.
+     */
+    static unsigned default_threads();
+
+  private:
+    ThreadPool(const ThreadPool &);
+    ThreadPool &operator=(const ThreadPool &);
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool pop(unsigned index, std::function<void()> &task);
+    bool steal(unsigned index, std::function<void()> &task);
+    void run(unsigned index);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<unsigned> next_queue;
+
+    std::mutex idle_mutex;
+    std::condition_variable idle;
+    long queued;   ///< Number of submitted tasks not yet taken by a worker; guarded by idle_mutex.
+    bool stopping; ///< Set by the destructor; guarded by idle_mutex.
+};
+
+#endif // ZSP_THREAD_POOL_H
+
+/** End of thread_pool.h */
\ No newline at end of file
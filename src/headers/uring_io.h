@@ -0,0 +1,161 @@
+/**
+ * @file uring_io.h
+ * @brief io_uring backend for the input and output of the line-oriented batch modes.
+ * @details The plain batch path reads and writes one block at a time, so the device never sees more
+ *          than one request of this process. batch_uring() keeps up to 'depth' reads and 'depth'
+ *          writes in flight at once from a single thread, with all data buffers registered with the
+ *          kernel up front so no request pays for pinning its pages.
+ *
+ *          The ring is driven through the raw system calls; liburing is not needed. Where io_uring
+ *          is missing or forbidden (old kernels, seccomp filters, exhausted locked memory) or a
+ *          stream has no descriptor, the driver falls back to the plain InputReader/OutputBuffer
+ *          path with the same output.
+ *
+ * @see uring_io.cpp for the implementation.
+ * @see parallel_batch.h and pipeline.h for the other drivers of the same kernels.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_URING_IO_H
+#define ZSP_URING_IO_H
+#include "batch.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <sys/uio.h>
+
+/** Number of reads and of writes in flight by default. */
+const unsigned URING_DEFAULT_DEPTH = 8;
+
+/** Size of every registered buffer by default. */
+const size_t URING_DEFAULT_BLOCK = 256 << 10;
+
+/**
+ * @class Uring
+ * @brief Minimal io_uring instance: one submission and one completion queue mapped into memory.
+ *
+ * @details Only the operations the batch driver needs are offered: reads and writes into
+ *          registered buffers. Every request carries a tag that comes back with its completion.
+ */
+class Uring
+{
+  public:
+    /**
+     * @brief Sets up a ring; check available() afterwards.
+     * @param depth Size of the submission queue.
+     */
+    explicit Uring(unsigned depth);
+    ~Uring();
+
+    /**
+     * @brief Tells whether the ring was set up.
+     * @return false if the kernel refused io_uring.
+     */
+    bool available() const;
+
+    /**
+     * @brief Tells whether the kernel accepts offset -1 for reads and writes (IORING_FEAT_RW_CUR_POS, Linux 5.6).
+     * @return false if streams cannot be addressed through this ring.
+     */
+    bool reads_at_current_position() const;
+
+    /**
+     * @brief Registers the buffers that read_fixed() and write_fixed() refer to by index.
+     * @param buffers Address and length of every buffer.
+     * @param count Number of buffers.
+     * @return false if the kernel refused, e.g. for lack of lockable memory.
+     */
+    bool register_buffers(const struct iovec *buffers, unsigned count);
+
+    /**
+     * @brief Queues a read into a registered buffer.
+     * @param fd Descriptor to read from.
+     * @param buffer Destination inside registered buffer 'index'.
+     * @param length Number of bytes.
+     * @param offset File offset, or -1 for the current position of a stream.
+     * @param index Index of the registered buffer.
+     * @param tag Value returned with the completion.
+     * @return false if the submission queue is full.
+     */
+    bool read_fixed(int fd, char *buffer, unsigned length, long long offset, unsigned index, unsigned long long tag);
+
+    /**
+     * @brief Queues a write from a registered buffer; see read_fixed().
+     */
+    bool write_fixed(int fd, const char *buffer, unsigned length, long long offset, unsigned index,
+                     unsigned long long tag);
+
+    /**
+     * @brief Submits the queued requests and waits for completions.
+     * @param wait Number of completions to wait for; 0 only submits.
+     * @return false if the kernel rejected the submission.
+     */
+    bool submit(unsigned wait);
+
+    /**
+     * @brief Takes the next completion, if any.
+     * @param tag Receives the tag of the request.
+     * @param result Receives the number of bytes transferred, or a negative errno.
+     * @return false if no completion is waiting.
+     */
+    bool next_completion(unsigned long long &tag, int &result);
+
+  private:
+    Uring(const Uring &);
+    Uring &operator=(const Uring &);
+
+    bool queue(unsigned char opcode, int fd, const char *buffer, unsigned length, long long offset, unsigned index,
+               unsigned long long tag);
+
+    int fd;
+    unsigned queued;   ///< Requests queued but not yet taken by the kernel.
+    unsigned features; ///< IORING_FEAT_* flags reported by io_uring_setup.
+
+    void *ring;                  ///< Mapping of the submission and completion queue rings.
+    size_t ring_size;            ///< Size of that mapping.
+    void *completion_ring;       ///< Separate completion ring mapping, or NULL if it is shared.
+    size_t completion_ring_size; ///< Size of the separate completion mapping.
+    struct io_uring_sqe *entries;
+    size_t entries_size;
+
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe *cqes;
+};
+
+/**
+ * @brief Tells whether this process may use io_uring.
+ * @return true if a ring could be set up; the answer is computed once.
+ */
+bool uring_supported();
+
+/**
+ * @brief Runs a batch kernel with io_uring input and output.
+ *
+ * @details The input is read block by block into registered buffers; regular files are read at
+ *          explicit offsets with 'depth' reads in flight, pipes one read at a time. The kernel runs
+ *          on whole lines as they arrive, so like batch_parallel() it needs records that each sit on
+ *          a single line. Its output is copied into registered buffers and written with up to
+ *          'depth' writes in flight, at explicit offsets if the output is a regular file.
+ *          Pipes and appended files need Uring::reads_at_current_position(); on older kernels they
+ *          use the plain stdio path instead, as does everything when io_uring is unavailable.
+ *
+ * @param kernel Batch kernel, e.g. u1_1_receipts().
+ * @param input Stream with the records; nothing may have been read from it through stdio.
+ * @param output Stream the results are written to.
+ * @param depth Number of reads and of writes in flight.
+ * @param block_size Size of every registered buffer.
+ * @return Number of processed records, or -1 if the input contained a malformed record or an I/O
+ *         request failed. The results for the records before the malformed one are still written.
+ */
+long batch_uring(BatchKernel kernel, FILE *input, FILE *output, unsigned depth = URING_DEFAULT_DEPTH,
+                 size_t block_size = URING_DEFAULT_BLOCK);
+
+#endif // ZSP_URING_IO_H
+
+/** End of uring_io.h */
\ No newline at end of file
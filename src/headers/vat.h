@@ -0,0 +1,164 @@
+/**
+ * @file vat.h
+ * @brief Integer fixed-point VAT pricing kernels.
+ * @details The original u1_1() multiplied the price by `1.2` in `double` and rounded by comparing the
+ *          fractional part with 0.5. The kernels declared here compute the same result with integer
+ *          arithmetic only: the VAT rate is expressed in basis points (1/100 of a percent), so the
+ *          gross price is `price * (10000 + rate) / 10000`, rounded half up for non-negative prices.
+ *
+ *          The results are bit-identical to the double-based formula over its whole defined range
+ *          (`|price| <= VAT_MAX_PRICE`). That includes its behaviour for negative prices, where the
+ *          fractional part is never >= 0.5 and the double formula therefore truncates towards zero.
+ *          Other rates use the same rounding rule, but exactly, so e.g. 50 Kč at 21 % is 60.5 and
+ *          rounds to 61 Kč even though `50 * 1.21` is slightly below 60.5 in binary floating point.
+ *
+ *          Every supported rate is a rate class (VatRate). Each class has its own kernel compiled
+ *          from a template with the rate as a compile-time parameter; a run-time dispatcher selects
+ *          among them, and baskets with mixed classes are priced by a table-driven kernel.
+ *
+ *          The array kernels have a scalar path and an AVX2 path that prices eight values per
+ *          instruction; the AVX2 path is chosen at run time when the CPU supports it.
+ *
+ * @see vat.cpp for the implementation.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#ifndef ZSP_VAT_H
+#define ZSP_VAT_H
+#include <stddef.h>
+
+/** VAT rate used by u1_1 in basis points (20 %). */
+const int VAT_BASIS_POINTS = 2000;
+
+/** Largest absolute price whose gross price at 20 % still fits into an int. */
+const int VAT_MAX_PRICE = 1789569705;
+
+/**
+ * @brief VAT rate classes an item can be priced with.
+ * @details The numeric values index the rate table and are stored as one byte per item in
+ *          mixed-rate arrays.
+ */
+enum VatRate
+{
+    VAT_RATE_20 = 0, ///< 20 %, the rate of the original assignment.
+    VAT_RATE_21,     ///< 21 %, standard rate.
+    VAT_RATE_12,     ///< 12 %, reduced rate.
+    VAT_RATE_0,      ///< 0 %, exempt goods.
+    VAT_RATE_COUNT
+};
+
+/**
+ * @brief Returns the rate of a class in whole percent, as printed on receipts.
+ * @param rate Rate class.
+ * @return The rate in percent.
+ */
+int vat_rate_percent(VatRate rate);
+
+/**
+ * @brief Returns the largest absolute price the kernels accept for a class.
+ * @param rate Rate class.
+ * @return The largest price whose gross price still fits into an int.
+ */
+int vat_rate_max_price(VatRate rate);
+
+/**
+ * @brief Looks up the rate class for a rate given in whole percent.
+ * @param percent Rate in percent, e.g. 21.
+ * @param rate Receives the class if it exists.
+ * @return true if the rate is in the table.
+ */
+bool vat_rate_from_percent(int percent, VatRate &rate);
+
+/**
+ * @brief Calculates the unit price including VAT.
+ * @param price Unit price without VAT, `|price| <= VAT_MAX_PRICE`.
+ * @return Unit price with VAT, rounded to whole crowns exactly as u1_1 always did.
+ */
+int vat_gross_price(int price);
+
+/**
+ * @brief Calculates the unit price including VAT for the given rate class.
+ * @param price Unit price without VAT, `|price| <= vat_rate_max_price(rate)`.
+ * @param rate Rate class.
+ * @return Unit price with VAT, rounded to whole crowns.
+ */
+int vat_gross_price(int price, VatRate rate);
+
+/**
+ * @brief Calculates gross prices at 20 % for a whole array using the fastest available path.
+ * @param prices Unit prices without VAT.
+ * @param gross Receives the unit prices with VAT; may alias 'prices'.
+ * @param count Number of prices.
+ */
+void vat_gross_prices(const int *prices, int *gross, size_t count);
+
+/**
+ * @brief Calculates gross prices for an array whose items all share one rate class.
+ * @details Dispatches to the kernel specialised for that class.
+ * @param prices Unit prices without VAT.
+ * @param rate Rate class of all items.
+ * @param gross Receives the unit prices with VAT; may alias 'prices'.
+ * @param count Number of prices.
+ */
+void vat_gross_prices(const int *prices, VatRate rate, int *gross, size_t count);
+
+/**
+ * @brief Calculates gross prices for an array of items with individual rate classes.
+ * @param prices Unit prices without VAT.
+ * @param rates Rate class of every item, one VatRate value per byte; any other byte is priced at
+ *              VAT_RATE_20, as vat_gross_price(int, VatRate) does, by every kernel.
+ * @param gross Receives the unit prices with VAT; may alias 'prices'.
+ * @param count Number of prices.
+ */
+void vat_gross_prices_mixed(const int *prices, const unsigned char *rates, int *gross, size_t count);
+
+/**
+ * @brief Portable scalar version of vat_gross_prices() at 20 %.
+ * @param prices Unit prices without VAT.
+ * @param gross Receives the unit prices with VAT; may alias 'prices'.
+ * @param count Number of prices.
+ */
+void vat_gross_prices_scalar(const int *prices, int *gross, size_t count);
+
+/**
+ * @brief AVX2 version of vat_gross_prices() at 20 %.
+ * @details Prices eight values at a time. Blocks containing a price too large for 32-bit
+ *          intermediates are handed to the scalar path.
+ * @pre vat_avx2_available() returns true.
+ * @param prices Unit prices without VAT.
+ * @param gross Receives the unit prices with VAT; may alias 'prices'.
+ * @param count Number of prices.
+ */
+void vat_gross_prices_avx2(const int *prices, int *gross, size_t count);
+
+/**
+ * @brief Portable scalar version of vat_gross_prices_mixed().
+ * @param prices Unit prices without VAT.
+ * @param rates Rate class of every item.
+ * @param gross Receives the unit prices with VAT; may alias 'prices'.
+ * @param count Number of prices.
+ */
+void vat_gross_prices_mixed_scalar(const int *prices, const unsigned char *rates, int *gross, size_t count);
+
+/**
+ * @brief AVX2 version of vat_gross_prices_mixed().
+ * @details Looks up the constants of each lane's rate class with a register permutation, so a mixed
+ *          block costs the same as a single-rate one.
+ * @pre vat_avx2_available() returns true.
+ * @param prices Unit prices without VAT.
+ * @param rates Rate class of every item.
+ * @param gross Receives the unit prices with VAT; may alias 'prices'.
+ * @param count Number of prices.
+ */
+void vat_gross_prices_mixed_avx2(const int *prices, const unsigned char *rates, int *gross, size_t count);
+
+/**
+ * @brief Tells whether the AVX2 kernels were compiled in and the CPU supports them.
+ * @return true if the `_avx2` kernels may be called.
+ */
+bool vat_avx2_available();
+
+#endif // ZSP_VAT_H
+
+/** End of vat.h */
\ No newline at end of file
@@ -0,0 +1,304 @@
+/**
+ * @file incremental_gradebook.cpp
+ * @brief Implementation of the incremental gradebook.
+ * @details Every edit is expressed as "remove one grade, add one grade", either of which may be
+ *          absent. Whether the result changed is decided on the integer totals: two averages are
+ *          equal exactly when sum1 * count2 == sum2 * count1, so no doubles are compared.
+ *
+ * @see incremental_gradebook.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "incremental_gradebook.h"
+#include "buffered_io.h"
+#include "format.h"
+#include "grade_class.h"
+#include "gradebook.h"
+#include "packed_grades.h"
+#include <limits.h>
+#include <string.h>
+
+namespace
+{
+/** Marks the missing half of an insertion or a deletion. */
+const int NO_GRADE = 0;
+
+/** Longest line printed for one edit. */
+const size_t MAX_RESULT_LENGTH = 160;
+
+inline bool grade_in_range(int grade)
+{
+    return grade >= 1 && grade <= INCREMENTAL_GRADE_VALUES;
+}
+
+/**
+ * @brief Adds one grade of a loaded student to their totals.
+ * @return false if the grade is out of range.
+ */
+inline bool count_grade(StudentTotals &totals, int grade)
+{
+    if (!grade_in_range(grade))
+    {
+        return false;
+    }
+    totals.grade_counts[grade - 1]++;
+    totals.sum += grade;
+    totals.count++;
+    return true;
+}
+
+/**
+ * @brief Compares a word from the input with a command name.
+ */
+template <size_t N>
+inline bool is_command(const char *word, size_t length, const char (&name)[N])
+{
+    return length == N - 1 && memcmp(word, name, N - 1) == 0;
+}
+
+/**
+ * @brief Writes the result line of a student.
+ * @param p Write position.
+ * @param id Student ID.
+ * @param totals Totals of the student, or NULL if the student has no grades left.
+ * @return Position after the line.
+ */
+char *format_result(char *p, int id, const StudentTotals *totals)
+{
+    unsigned char grade_class = totals ? totals->grade_class : (unsigned char)GRADE_INVALID;
+    GradeStatus status = grade_status_from_class(grade_class);
+    p = format_literal(p, "Student ");
+    p = format_long(p, id);
+    p = format_literal(p, ": ");
+    p = format_fixed(p, totals ? (double)totals->sum / totals->count : 0, 2);
+    p = format_literal(p, "\tProspěl s vyznamenáním: ");
+    p = status.distinction ? format_literal(p, "1:Ano") : format_literal(p, "0:Ne");
+    p = format_literal(p, "\tProspěl: ");
+    p = status.passed ? format_literal(p, "1:Ano") : format_literal(p, "0:Ne");
+    p = format_literal(p, "\tNeprospěl: ");
+    p = status.failed ? format_literal(p, "1:Ano\n") : format_literal(p, "0:Ne\n");
+    return p;
+}
+} // namespace
+
+IncrementalGradebook::IncrementalGradebook(size_t expected_students)
+{
+    index.reserve(expected_students);
+}
+
+EditResult IncrementalGradebook::insert(int id, int grade)
+{
+    return grade_in_range(grade) ? apply(id, NO_GRADE, grade) : EDIT_REJECTED;
+}
+
+EditResult IncrementalGradebook::remove(int id, int grade)
+{
+    return grade_in_range(grade) ? apply(id, grade, NO_GRADE) : EDIT_REJECTED;
+}
+
+EditResult IncrementalGradebook::update(int id, int old_grade, int new_grade)
+{
+    return grade_in_range(old_grade) && grade_in_range(new_grade) ? apply(id, old_grade, new_grade) : EDIT_REJECTED;
+}
+
+/**
+ * @brief Removes one grade and adds another in a single step.
+ * @param id Student ID.
+ * @param removed Grade to remove, or NO_GRADE.
+ * @param added Grade to add, or NO_GRADE.
+ * @return Outcome of the edit.
+ */
+EditResult IncrementalGradebook::apply(int id, int removed, int added)
+{
+    std::unordered_map<int, StudentTotals>::iterator found = index.find(id);
+    if (removed != NO_GRADE && (found == index.end() || found->second.grade_counts[removed - 1] == 0))
+    {
+        return EDIT_REJECTED;
+    }
+    if (found == index.end())
+    {
+        StudentTotals empty;
+        memset(&empty, 0, sizeof(empty));
+        empty.grade_class = GRADE_INVALID;
+        found = index.insert(std::make_pair(id, empty)).first;
+    }
+
+    StudentTotals &totals = found->second;
+    int old_sum = totals.sum;
+    int old_count = totals.count;
+    unsigned char old_class = totals.grade_class;
+    if (removed != NO_GRADE)
+    {
+        totals.grade_counts[removed - 1]--;
+        totals.sum -= removed;
+        totals.count--;
+    }
+    if (added != NO_GRADE)
+    {
+        totals.grade_counts[added - 1]++;
+        totals.sum += added;
+        totals.count++;
+    }
+    totals.grade_class = classify_grade_sum(totals.sum, grade_thresholds(totals.count));
+
+    bool same_average = (long long)old_sum * totals.count == (long long)totals.sum * old_count &&
+                        (old_count == 0) == (totals.count == 0);
+    bool unchanged = same_average && old_class == totals.grade_class;
+    if (totals.count == 0)
+    {
+        // Erasing frees 'totals', so everything it is needed for is computed above.
+        index.erase(found);
+    }
+    return unchanged ? EDIT_UNCHANGED : EDIT_CHANGED;
+}
+
+bool IncrementalGradebook::load(FILE *input)
+{
+    index.clear();
+    InputReader reader(input);
+    Gradebook block;
+    long long id = 0;
+    bool wellformed = true;
+    while (wellformed)
+    {
+        gradebook_clear(block);
+        wellformed = gradebook_read(reader, block, GRADEBOOK_BLOCK_STUDENTS);
+        size_t students = gradebook_students(block);
+        for (size_t student = 0; student < students && wellformed; student++)
+        {
+            StudentTotals totals;
+            memset(&totals, 0, sizeof(totals));
+            for (size_t i = block.offsets[student]; i < block.offsets[student + 1] && wellformed; i++)
+            {
+                wellformed = count_grade(totals, block.grades[i]);
+            }
+            wellformed = wellformed && ++id <= INT_MAX;
+            if (wellformed)
+            {
+                add((int)id, totals);
+            }
+        }
+        if (students < GRADEBOOK_BLOCK_STUDENTS)
+        {
+            break;
+        }
+    }
+    if (!wellformed || !reader.at_end())
+    {
+        index.clear();
+        return false;
+    }
+    return true;
+}
+
+bool IncrementalGradebook::load_packed(FILE *input)
+{
+    index.clear();
+    PackedGradebook packed;
+    if (!packed.open(input) || packed.students() > (size_t)INT_MAX)
+    {
+        return false;
+    }
+    index.reserve(packed.students());
+    for (size_t student = 0; student < packed.students(); student++)
+    {
+        StudentTotals totals;
+        memset(&totals, 0, sizeof(totals));
+        uint64_t first = packed.offset(student);
+        int count = packed.count(student);
+        for (int i = 0; i < count; i++)
+        {
+            if (!count_grade(totals, packed.grade(first + i)))
+            {
+                index.clear();
+                return false;
+            }
+        }
+        add((int)student + 1, totals);
+    }
+    return true;
+}
+
+/**
+ * @brief Enters a loaded student into the index.
+ * @param id Student ID.
+ * @param totals Totals of the student's grades; the class is computed here. A student without
+ *               grades is left out of the index.
+ */
+void IncrementalGradebook::add(int id, StudentTotals &totals)
+{
+    if (totals.count > 0)
+    {
+        totals.grade_class = classify_grade_sum(totals.sum, grade_thresholds(totals.count));
+        index[id] = totals;
+    }
+}
+
+const StudentTotals *IncrementalGradebook::find(int id) const
+{
+    std::unordered_map<int, StudentTotals>::const_iterator found = index.find(id);
+    return found == index.end() ? NULL : &found->second;
+}
+
+size_t IncrementalGradebook::students() const
+{
+    return index.size();
+}
+
+long u1_2_edits(FILE *input, FILE *output)
+{
+    IncrementalGradebook book;
+    return u1_2_edits(book, input, output);
+}
+
+long u1_2_edits(IncrementalGradebook &book, FILE *input, FILE *output)
+{
+    InputReader reader(input);
+    OutputBuffer out(output);
+
+    long edits = 0;
+    const char *command = NULL;
+    size_t length = 0;
+    while (reader.next_word(command, length))
+    {
+        int id = 0;
+        int grade = 0;
+        int new_grade = 0;
+        EditResult result;
+        if (is_command(command, length, "insert") && reader.next_int(id) && reader.next_int(grade))
+        {
+            result = book.insert(id, grade);
+        }
+        else if (is_command(command, length, "delete") && reader.next_int(id) && reader.next_int(grade))
+        {
+            result = book.remove(id, grade);
+        }
+        else if (is_command(command, length, "update") && reader.next_int(id) && reader.next_int(grade) &&
+                 reader.next_int(new_grade))
+        {
+            result = book.update(id, grade, new_grade);
+        }
+        else
+        {
+            return -1;
+        }
+
+        char *p = out.reserve(MAX_RESULT_LENGTH);
+        if (result == EDIT_CHANGED)
+        {
+            p = format_result(p, id, book.find(id));
+        }
+        else if (result == EDIT_REJECTED)
+        {
+            p = format_literal(p, "Student ");
+            p = format_long(p, id);
+            p = format_literal(p, ": neplatná oprava\n");
+        }
+        out.commit(p);
+        edits++;
+    }
+    return edits;
+}
+
+/** End of incremental_gradebook.cpp */
\ No newline at end of file
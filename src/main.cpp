@@ -19,7 +19,408 @@
  *       November 13, 2023 (Comment enhancements)
  */
 
+#include "basket.h"
+#include "batch.h"
+#include "cohort_stats.h"
+#include "cross_rates.h"
+#include "daemon.h"
+#include "external_group.h"
+#include "fixed_decimal.h"
 #include "functions.h"
+#include "gradebook.h"
+#include "incremental_gradebook.h"
+#include "packed_grades.h"
+#include "parallel_batch.h"
+#include "pipeline.h"
+#include "ranking.h"
+#include "rate_history.h"
+#include "rate_snapshot.h"
+#include "rate_table.h"
+#include "uring_io.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/**
+ * @brief Runs one of the batch modes.
+ * @details Reads the records from the given file, or from the standard input when no file is given,
+ *          and writes the results to the standard output.
+ *
+ * @param batch Batch driver to run.
+ * @param path Path to the input file, or NULL for the standard input.
+ * @return 0 on success, 1 if the input could not be opened or contained a malformed record.
+ */
+static int run_batch(const std::function<long(FILE *, FILE *)> &batch, const char *path)
+{
+    FILE *input = path ? fopen(path, "rb") : stdin;
+    if (!input)
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 1;
+    }
+
+    long records = batch(input, stdout);
+
+    if (input != stdin)
+    {
+        fclose(input);
+    }
+    if (records < 0)
+    {
+        fprintf(stderr, "Malformed input record\n");
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Runs the grouping mode over any number of event files.
+ * @details Every argument except `--memory MB` is an input file; without any, the events are read
+ *          from the standard input. The reports are written to the standard output.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments; argv[1] is the mode option.
+ * @return 0 on success, 1 if an input could not be opened, contained a malformed event or the
+ *         temporary files failed.
+ */
+static int run_group(int argc, char *argv[])
+{
+    size_t memory = GROUP_DEFAULT_MEMORY;
+    std::vector<FILE *> inputs;
+    int status = 0;
+    for (int i = 2; i < argc && status == 0; i++)
+    {
+        if (strcmp(argv[i], "--memory") == 0 && i + 1 < argc)
+        {
+            memory = (size_t)strtoul(argv[++i], NULL, 10) << 20;
+        }
+        else if (FILE *input = fopen(argv[i], "rb"))
+        {
+            inputs.push_back(input);
+        }
+        else
+        {
+            fprintf(stderr, "Cannot open %s\n", argv[i]);
+            status = 1;
+        }
+    }
+    if (inputs.empty() && status == 0)
+    {
+        inputs.push_back(stdin);
+    }
+
+    long students = status == 0 ? u1_2_group(inputs.data(), inputs.size(), stdout, memory) : 0;
+    if (students == GROUP_SPILL_FAILED)
+    {
+        fprintf(stderr, "Cannot write temporary files\n");
+        status = 1;
+    }
+    else if (students < 0)
+    {
+        fprintf(stderr, "Malformed input record\n");
+        status = 1;
+    }
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        if (inputs[i] != stdin)
+        {
+            fclose(inputs[i]);
+        }
+    }
+    return status;
+}
+
+/**
+ * @brief Runs the quote mode or the cross conversion mode.
+ * @details `--rates FILE` names the rate file, which is loaded once before any record is read; any
+ *          other argument is the input file. Without one, the records are read from the standard
+ *          input. With `--watch MS` the rate file is polled every MS milliseconds while the records
+ *          are converted and a changed file is published as a new snapshot. Quotes name the snapshot
+ *          version they used; cross conversions update the matrix before each block of records.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments; argv[1] is the mode option.
+ * @return 0 on success, 1 if the rate file is missing or invalid, or run_batch() fails.
+ */
+static int run_quotes(int argc, char *argv[])
+{
+    const char *rates_path = NULL;
+    const char *path = NULL;
+    long watch = -1;
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--rates") == 0 && i + 1 < argc)
+        {
+            rates_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--watch") == 0 && i + 1 < argc)
+        {
+            watch = strtol(argv[++i], NULL, 10);
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    if (!rates_path)
+    {
+        fprintf(stderr, "No rate file given\n");
+        return 1;
+    }
+    if (watch >= 0)
+    {
+        RateSnapshots snapshots;
+        RateFileWatcher watcher(rates_path, snapshots);
+        if (!watcher.check())
+        {
+            fprintf(stderr, "Cannot load rate file %s\n", rates_path);
+            return 1;
+        }
+        watcher.start((unsigned)watch);
+        if (strcmp(argv[1], "--cross") == 0)
+        {
+            std::unique_ptr<CrossRateMatrix> matrix(new CrossRateMatrix);
+            CrossRateMatrix &cross = *matrix;
+            return run_batch(
+                [&snapshots, &cross](FILE *input, FILE *output) {
+                    InputReader reader(input);
+                    OutputBuffer out(output);
+                    return u1_3_live_cross_conversions(snapshots, cross, reader, out);
+                },
+                path);
+        }
+        return run_batch(
+            [&snapshots](FILE *input, FILE *output) {
+                InputReader reader(input);
+                OutputBuffer out(output);
+                return u1_3_live_quotes(snapshots, reader, out);
+            },
+            path);
+    }
+
+    FILE *rates_file = fopen(rates_path, "rb");
+    if (!rates_file)
+    {
+        fprintf(stderr, "Cannot open rate file %s\n", rates_path);
+        return 1;
+    }
+    std::unique_ptr<RateTable> rates(new RateTable);
+    bool loaded = rates->load(rates_file);
+    fclose(rates_file);
+    if (!loaded)
+    {
+        fprintf(stderr, "Malformed rate file %s\n", rates_path);
+        return 1;
+    }
+
+    if (strcmp(argv[1], "--cross") == 0)
+    {
+        std::unique_ptr<CrossRateMatrix> matrix(new CrossRateMatrix);
+        matrix->build(*rates);
+        const CrossRateMatrix &cross = *matrix;
+        return run_batch(
+            [&cross](FILE *input, FILE *output) {
+                InputReader reader(input);
+                OutputBuffer out(output);
+                return u1_3_cross_conversions(cross, reader, out);
+            },
+            path);
+    }
+
+    const RateTable &table = *rates;
+    return run_batch([&table](FILE *input, FILE *output) { return u1_3_quotes(table, input, output); }, path);
+}
+
+/**
+ * @brief Runs the as-of conversion mode.
+ * @details `--history FILE` names a rate-history file and may be repeated; all files are loaded
+ *          into one history before any record is read. Any other argument is the input file.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments; argv[1] is the mode option.
+ * @return 0 on success, 1 if a history file is missing or invalid, or run_batch() fails.
+ */
+static int run_asof(int argc, char *argv[])
+{
+    std::unique_ptr<RateHistory> history(new RateHistory);
+    const char *path = NULL;
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--history") == 0 && i + 1 < argc)
+        {
+            FILE *history_file = fopen(argv[++i], "rb");
+            bool loaded = history_file && history->load(history_file);
+            if (history_file)
+            {
+                fclose(history_file);
+            }
+            if (!loaded)
+            {
+                fprintf(stderr, "Cannot load rate history %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    const RateHistory &rates = *history;
+    return run_batch(
+        [&rates](FILE *input, FILE *output) {
+            InputReader reader(input);
+            OutputBuffer out(output);
+            return u1_3_history_conversions(rates, reader, out);
+        },
+        path);
+}
+
+/**
+ * @brief Runs the edit mode.
+ * @details `--gradebook BOOK` or `--packed BOOK` loads an existing text or bit-packed gradebook
+ *          before the edits are applied, so only the corrections are read; the n-th student of the
+ *          book has the ID n. Without either the edits start from an empty book. Any other argument
+ *          is the input file with the edits.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments; argv[1] is the mode option.
+ * @return 0 on success, 1 if the book is missing or invalid, or run_batch() fails.
+ */
+static int run_edits(int argc, char *argv[])
+{
+    std::unique_ptr<IncrementalGradebook> book(new IncrementalGradebook);
+    const char *path = NULL;
+    for (int i = 2; i < argc; i++)
+    {
+        bool packed = strcmp(argv[i], "--packed") == 0;
+        if ((packed || strcmp(argv[i], "--gradebook") == 0) && i + 1 < argc)
+        {
+            FILE *book_file = fopen(argv[++i], "rb");
+            bool loaded = book_file && (packed ? book->load_packed(book_file) : book->load(book_file));
+            if (book_file)
+            {
+                fclose(book_file);
+            }
+            if (!loaded)
+            {
+                fprintf(stderr, "Cannot load gradebook %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    IncrementalGradebook &edited = *book;
+    return run_batch([&edited](FILE *input, FILE *output) { return u1_2_edits(edited, input, output); }, path);
+}
+
+/** Server stopped by SIGINT and SIGTERM in the --serve mode. */
+static DaemonServer *serving = NULL;
+
+/**
+ * @brief Stops the --serve loop; DaemonServer::stop() only writes to an eventfd.
+ * @param signal_number Number of the received signal.
+ */
+static void stop_serving(int signal_number)
+{
+    (void)signal_number;
+    if (serving)
+    {
+        serving->stop();
+    }
+}
+
+/**
+ * @brief Runs the request server on the socket given after the option until SIGINT or SIGTERM.
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments; argv[1] is the mode option.
+ * @return 0 after a clean stop, 1 if the socket could not be created.
+ */
+static int run_serve(int argc, char *argv[])
+{
+    DaemonServer server;
+    if (argc < 3 || !server.listen(argv[2]))
+    {
+        fprintf(stderr, "Cannot listen on %s\n", argc < 3 ? "(no socket given)" : argv[2]);
+        return 1;
+    }
+
+    serving = &server;
+    signal(SIGINT, stop_serving);
+    signal(SIGTERM, stop_serving);
+    bool stopped = server.run();
+    serving = NULL;
+    return stopped ? 0 : 1;
+}
+
+/**
+ * @brief Sends the records of a batch input to a running server and prints the responses.
+ * @details `--client SOCKET MODE [file]` with MODE one of --batch, --grades and --exchange. The
+ *          median and the 99th percentile of the round-trip times are reported on stderr.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments; argv[1] is the mode option.
+ * @return 0 on success, 1 if the server is unreachable, the mode is unknown or run_batch() fails.
+ */
+static int run_client(int argc, char *argv[])
+{
+    const struct
+    {
+        const char *option;
+        DaemonTask task;
+    } CLIENT_MODES[] = {
+        {"--batch", DAEMON_RECEIPT},
+        {"--grades", DAEMON_GRADES},
+        {"--exchange", DAEMON_CONVERSION},
+    };
+
+    if (argc < 4)
+    {
+        fprintf(stderr, "Usage: --client SOCKET --batch|--grades|--exchange [file]\n");
+        return 1;
+    }
+    DaemonClient client;
+    if (!client.connect(argv[2]))
+    {
+        fprintf(stderr, "Cannot connect to %s\n", argv[2]);
+        return 1;
+    }
+    for (const auto &mode : CLIENT_MODES)
+    {
+        if (strcmp(argv[3], mode.option) != 0)
+        {
+            continue;
+        }
+
+        DaemonTask task = mode.task;
+        std::vector<double> latencies;
+        int result = run_batch(
+            [&client, task, &latencies](FILE *input, FILE *output) {
+                InputReader reader(input);
+                OutputBuffer out(output);
+                return daemon_replay(client, task, reader, out, latencies);
+            },
+            argc > 4 ? argv[4] : NULL);
+        if (!latencies.empty())
+        {
+            std::sort(latencies.begin(), latencies.end());
+            fprintf(stderr, "Requests: %zu\tp50: %.1f us\tp99: %.1f us\n", latencies.size(),
+                    latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100]);
+        }
+        return result;
+    }
+    fprintf(stderr, "Unknown client mode %s\n", argv[3]);
+    return 1;
+}
 
 /**
  * @brief Main function of the application.
@@ -34,12 +435,187 @@
  *          - u1_2: Processing of student grades.
  *          - u1_3: Conversion of currency to Czech Koruna (CZK).
  *
+ *          Batch modes read the file given after the option, or the standard input:
+ *          - `my_program --batch [file]`: a receipt for every (count, price) record, see batch.h.
+ *          - `my_program --baskets [file]`: a receipt for every multi-line basket, see basket.h.
+ *          - `my_program --grades [file]`: a grade report for every five-grade record, see batch.h.
+ *          - `my_program --gradebook [file]`: a grade report for every student with any number of
+ *            grades, see gradebook.h.
+ *          - `my_program --exchange [file]`: a conversion for every (currency, rate, amount) record.
+ *          - `my_program --fixed-exchange [file]`: the --exchange conversions computed exactly in
+ *            fixed-point decimal, see fixed_decimal.h.
+ *          - `my_program --quotes --rates RATES [file]`: a conversion for every (currency, amount)
+ *            record with the rate looked up in the rate file loaded at startup, see rate_table.h.
+ *            `--watch MS` reloads the rate file whenever it changes, see rate_snapshot.h.
+ *          - `my_program --cross --rates RATES [file]`: converts every (source, target, amount)
+ *            record between two currencies with one cross rate, see cross_rates.h. `--watch MS`
+ *            updates the changed rows and columns of the matrix whenever the rate file changes.
+ *          - `my_program --asof --history HISTORY... [file]`: converts every (currency, time, amount)
+ *            record at the rate valid at its time, see rate_history.h.
+ *
+ *          - `my_program --statistics [file]`: one summary of all students in the --gradebook
+ *            format, see cohort_stats.h.
+ *          - `my_program --ranking [file]`: the best and the worst students of the cohort and of every
+ *            grade class, see ranking.h.
+ *          - `my_program --edits [--gradebook|--packed BOOK] [file]`: applies single-grade edits to
+ *            an existing gradebook and prints every changed result, see incremental_gradebook.h.
+ *          - `my_program --pack [file]`: converts a --gradebook text file into the bit-packed binary
+ *            format, see packed_grades.h.
+ *          - `my_program --packed [file]`: the --gradebook reports of a bit-packed file.
+ *          - `my_program --group [--memory MB] [files...]`: groups unsorted `student subject grade`
+ *            events from any number of files by student and prints a report per student, sorting
+ *            out of core within the memory limit, see external_group.h.
+ *
+ *          - `my_program --serve SOCKET`: answers receipt, grade and conversion requests on a Unix
+ *            domain socket until SIGINT or SIGTERM, see daemon.h.
+ *          - `my_program --client SOCKET --batch|--grades|--exchange [file]`: sends every record of
+ *            the batch input to a --serve process and prints the responses.
+ *
+ *          `--threads N` after the mode option spreads the per-record modes except --baskets over N
+ *          worker threads (0 for one per hardware thread); the output stays in input order.
+ *          `--pipeline N` runs the same modes as a pipeline of a reader thread, N compute workers and
+ *          a writer thread, and prints the throughput of every stage to stderr, see pipeline.h.
+ *          `--uring` reads the input and writes the output of the same modes through io_uring with
+ *          several requests in flight; without kernel support it quietly uses stdio, see uring_io.h.
+ *          --ranking also takes `--threads N` and ranks chunks of the input in parallel.
+ *          `--every N` makes --statistics print a running summary after every N students.
+ *          `--top N` sets the number of students in every --ranking list (10 by default).
+ *
  * @note Primarily used for testing and demonstrating the integrated functionality of the individual tasks.
  *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
  * @return Returns 0 upon successful completion of the program.
  */
-int main()
+int main(int argc, char *argv[])
 {
+    const struct
+    {
+        const char *option;
+        long (*batch)(FILE *, FILE *);
+        BatchKernel kernel;
+        long (*periodic)(FILE *, FILE *, long);
+        long (*ranked)(FILE *, FILE *, size_t, unsigned);
+    } BATCH_MODES[] = {
+        {"--batch", u1_1_batch, u1_1_receipts, NULL, NULL},
+        {"--baskets", u1_1_baskets, NULL, NULL, NULL},
+        {"--grades", u1_2_batch, u1_2_reports, NULL, NULL},
+        {"--gradebook", u1_2_gradebook, u1_2_gradebook_reports, NULL, NULL},
+        {"--statistics", u1_2_statistics, NULL, u1_2_statistics, NULL},
+        {"--ranking", u1_2_ranking, NULL, NULL, u1_2_ranking},
+        {"--pack", u1_2_pack, NULL, NULL, NULL},
+        {"--packed", u1_2_packed, NULL, NULL, NULL},
+        {"--exchange", u1_3_batch, u1_3_conversions, NULL, NULL},
+        {"--fixed-exchange", u1_3_fixed_batch, u1_3_fixed_conversions, NULL, NULL},
+    };
+
+    if (argc > 1 && strcmp(argv[1], "--group") == 0)
+    {
+        return run_group(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--serve") == 0)
+    {
+        return run_serve(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--client") == 0)
+    {
+        return run_client(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--asof") == 0)
+    {
+        return run_asof(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--edits") == 0)
+    {
+        return run_edits(argc, argv);
+    }
+    if (argc > 1 && (strcmp(argv[1], "--quotes") == 0 || strcmp(argv[1], "--cross") == 0))
+    {
+        return run_quotes(argc, argv);
+    }
+    if (argc > 1)
+    {
+        for (const auto &mode : BATCH_MODES)
+        {
+            if (strcmp(argv[1], mode.option) == 0)
+            {
+                unsigned threads = 1;
+                bool pipelined = false;
+                bool uring = false;
+                long interval = 0;
+                size_t top = RANKING_DEFAULT_SIZE;
+                const char *path = NULL;
+                for (int i = 2; i < argc; i++)
+                {
+                    if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+                    {
+                        threads = (unsigned)strtoul(argv[++i], NULL, 10);
+                    }
+                    else if (strcmp(argv[i], "--pipeline") == 0 && i + 1 < argc)
+                    {
+                        threads = (unsigned)strtoul(argv[++i], NULL, 10);
+                        pipelined = true;
+                    }
+                    else if (strcmp(argv[i], "--uring") == 0)
+                    {
+                        uring = true;
+                    }
+                    else if (strcmp(argv[i], "--every") == 0 && i + 1 < argc)
+                    {
+                        interval = strtol(argv[++i], NULL, 10);
+                    }
+                    else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc)
+                    {
+                        top = (size_t)strtoul(argv[++i], NULL, 10);
+                    }
+                    else
+                    {
+                        path = argv[i];
+                    }
+                }
+
+                std::function<long(FILE *, FILE *)> batch = mode.batch;
+                if (mode.kernel && threads != 1)
+                {
+                    BatchKernel kernel = mode.kernel;
+                    batch = [kernel, threads](FILE *input, FILE *output) {
+                        return batch_parallel(kernel, input, output, threads);
+                    };
+                }
+                if (mode.kernel && pipelined)
+                {
+                    BatchKernel kernel = mode.kernel;
+                    batch = [kernel, threads](FILE *input, FILE *output) {
+                        PipelineStats stats;
+                        long records = batch_pipeline(kernel, input, output, threads, &stats);
+                        print_pipeline_stats(stats, stderr);
+                        return records;
+                    };
+                }
+                if (mode.kernel && uring)
+                {
+                    BatchKernel kernel = mode.kernel;
+                    batch = [kernel](FILE *input, FILE *output) { return batch_uring(kernel, input, output); };
+                }
+                if (mode.periodic && interval > 0)
+                {
+                    long (*periodic)(FILE *, FILE *, long) = mode.periodic;
+                    batch = [periodic, interval](FILE *input, FILE *output) {
+                        return periodic(input, output, interval);
+                    };
+                }
+                if (mode.ranked)
+                {
+                    long (*ranked)(FILE *, FILE *, size_t, unsigned) = mode.ranked;
+                    batch = [ranked, top, threads](FILE *input, FILE *output) {
+                        return ranked(input, output, top, threads);
+                    };
+                }
+                return run_batch(batch, path);
+            }
+        }
+    }
+
     printf("Evgenii Shiliaev\nshilia01\n29.10.2023\n");
     u1_1(); // Task 01 - Price Calculation with VAT
     u1_2(); // Task 02 - Student Grade Processing
@@ -0,0 +1,379 @@
+/**
+ * @file packed_grades.cpp
+ * @brief Implementation of the bit-packed gradebook format.
+ * @details Bit b of every grade in a word is selected by one of three masks with every third bit
+ *          set. The sum of the grades in a word is therefore
+ *
+ *              popcount(w & LOW) + 2 * popcount(w & MIDDLE) + 4 * popcount(w & HIGH)
+ *
+ *          and the grades of a student that starts or ends inside a word are selected by clearing
+ *          the other fields first. On CPUs with the POPCNT instruction the loop is compiled for it.
+ *
+ * @see packed_grades.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "packed_grades.h"
+#include "buffered_io.h"
+#include "format.h"
+#include "grade_class.h"
+#include "gradebook.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <vector>
+
+namespace
+{
+const char MAGIC[8] = {'Z', 'S', 'P', 'G', 'R', 'A', 'D', 'E'};
+
+/** Lowest bit of every grade field. */
+const uint64_t LOW_BITS = 0x1249249249249249ULL;
+
+/** Bits of all PACKED_GRADES_PER_WORD fields. */
+const uint64_t FIELD_BITS = (1ULL << (PACKED_GRADE_BITS * PACKED_GRADES_PER_WORD)) - 1;
+
+/** Number of students reported together. */
+const size_t BLOCK_STUDENTS = 4096;
+
+/**
+ * @brief Returns the mask of the grade fields [first, last) of a word.
+ */
+inline uint64_t field_mask(unsigned first, unsigned last)
+{
+    return (FIELD_BITS >> (PACKED_GRADE_BITS * (PACKED_GRADES_PER_WORD - last))) &
+           ~((1ULL << (PACKED_GRADE_BITS * first)) - 1);
+}
+
+/**
+ * @brief Sums the grades of the range [begin, end) of the packed words.
+ * @details Always inlined, so that the population counts compile to POPCNT inside sums_native().
+ */
+#if defined(__GNUC__)
+__attribute__((always_inline))
+#endif
+inline int sum_range(const uint64_t *words, uint64_t begin, uint64_t end)
+{
+    if (begin == end)
+    {
+        return 0;
+    }
+    uint64_t first_word = begin / PACKED_GRADES_PER_WORD;
+    uint64_t last_word = (end - 1) / PACKED_GRADES_PER_WORD;
+    unsigned first_field = (unsigned)(begin % PACKED_GRADES_PER_WORD);
+    unsigned last_field = (unsigned)((end - 1) % PACKED_GRADES_PER_WORD) + 1;
+
+    int sum = 0;
+    for (uint64_t word = first_word; word <= last_word; word++)
+    {
+        uint64_t w = words[word] & field_mask(word == first_word ? first_field : 0,
+                                              word == last_word ? last_field : PACKED_GRADES_PER_WORD);
+        sum += __builtin_popcountll(w & LOW_BITS) + 2 * __builtin_popcountll(w & LOW_BITS << 1) +
+               4 * __builtin_popcountll(w & LOW_BITS << 2);
+    }
+    return sum;
+}
+
+void sums_generic(const uint64_t *words, const unsigned char *counts, uint64_t offset, size_t students, int *sums)
+{
+    for (size_t i = 0; i < students; i++)
+    {
+        sums[i] = sum_range(words, offset, offset + counts[i]);
+        offset += counts[i];
+    }
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+__attribute__((target("popcnt"))) void sums_native(const uint64_t *words, const unsigned char *counts, uint64_t offset,
+                                                   size_t students, int *sums)
+{
+    for (size_t i = 0; i < students; i++)
+    {
+        sums[i] = sum_range(words, offset, offset + counts[i]);
+        offset += counts[i];
+    }
+}
+
+bool popcnt_available()
+{
+    return __builtin_cpu_supports("popcnt");
+}
+#else
+void sums_native(const uint64_t *words, const unsigned char *counts, uint64_t offset, size_t students, int *sums)
+{
+    sums_generic(words, counts, offset, students, sums);
+}
+
+bool popcnt_available()
+{
+    return false;
+}
+#endif
+} // namespace
+
+PackedGradebook::PackedGradebook()
+    : data(NULL), size(0), mapped(false), header(NULL), words(NULL), counts(NULL), checkpoints(NULL)
+{
+}
+
+PackedGradebook::~PackedGradebook()
+{
+    close();
+}
+
+void PackedGradebook::close()
+{
+    if (mapped)
+    {
+        munmap((void *)data, size);
+    }
+    else
+    {
+        free((void *)data);
+    }
+    data = NULL;
+    size = 0;
+    mapped = false;
+    header = NULL;
+}
+
+bool PackedGradebook::open(FILE *input)
+{
+    close();
+
+    struct stat info;
+    if (ftello(input) == 0 && fstat(fileno(input), &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+    {
+        void *map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fileno(input), 0);
+        if (map != MAP_FAILED)
+        {
+            madvise(map, (size_t)info.st_size, MADV_WILLNEED);
+            data = (const unsigned char *)map;
+            size = (size_t)info.st_size;
+            mapped = true;
+        }
+    }
+    if (!mapped)
+    {
+        size_t capacity = 1 << 16;
+        unsigned char *buffer = (unsigned char *)malloc(capacity);
+        size_t read = 0;
+        while ((read = fread(buffer + size, 1, capacity - size, input)) > 0)
+        {
+            size += read;
+            if (size == capacity)
+            {
+                capacity *= 2;
+                buffer = (unsigned char *)realloc(buffer, capacity);
+            }
+        }
+        data = buffer;
+    }
+
+    if (size < sizeof(PackedGradesHeader))
+    {
+        return false;
+    }
+    header = (const PackedGradesHeader *)data;
+    if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != PACKED_GRADES_VERSION ||
+        header->bits_per_grade != PACKED_GRADE_BITS || header->grades > UINT32_MAX || header->students > UINT32_MAX)
+    {
+        header = NULL;
+        return false;
+    }
+    uint64_t word_count = (header->grades + PACKED_GRADES_PER_WORD - 1) / PACKED_GRADES_PER_WORD;
+    uint64_t count_bytes = (header->students + 3) & ~3ULL;
+    uint64_t checkpoint_count = header->students / PACKED_CHECKPOINT_STUDENTS + 1;
+    if (size != sizeof(PackedGradesHeader) + word_count * sizeof(uint64_t) + count_bytes +
+                    checkpoint_count * sizeof(uint32_t))
+    {
+        header = NULL;
+        return false;
+    }
+
+    words = (const uint64_t *)(data + sizeof(PackedGradesHeader));
+    counts = (const unsigned char *)(words + word_count);
+    checkpoints = (const uint32_t *)(counts + count_bytes);
+
+    // One pass over the counts proves every checkpoint, so the accessors can trust the index.
+    uint64_t total = 0;
+    for (uint64_t i = 0; i < header->students; i++)
+    {
+        if (i % PACKED_CHECKPOINT_STUDENTS == 0 && checkpoints[i / PACKED_CHECKPOINT_STUDENTS] != total)
+        {
+            header = NULL;
+            return false;
+        }
+        total += counts[i];
+    }
+    if (total != header->grades || (header->students % PACKED_CHECKPOINT_STUDENTS == 0 &&
+                                    checkpoints[checkpoint_count - 1] != total))
+    {
+        header = NULL;
+        return false;
+    }
+    return true;
+}
+
+size_t PackedGradebook::students() const
+{
+    return header ? (size_t)header->students : 0;
+}
+
+int PackedGradebook::count(size_t student) const
+{
+    return counts[student];
+}
+
+uint64_t PackedGradebook::offset(size_t student) const
+{
+    size_t checkpoint = student / PACKED_CHECKPOINT_STUDENTS;
+    uint64_t offset = checkpoints[checkpoint];
+    for (size_t i = checkpoint * PACKED_CHECKPOINT_STUDENTS; i < student; i++)
+    {
+        offset += counts[i];
+    }
+    return offset;
+}
+
+int PackedGradebook::grade(uint64_t position) const
+{
+    uint64_t word = words[position / PACKED_GRADES_PER_WORD];
+    return (int)(word >> (PACKED_GRADE_BITS * (position % PACKED_GRADES_PER_WORD))) & PACKED_MAX_GRADE;
+}
+
+void PackedGradebook::sums(size_t first, size_t students, int *sums, int *counts) const
+{
+    static const bool use_popcnt = popcnt_available();
+    if (use_popcnt)
+    {
+        sums_native(words, this->counts + first, offset(first), students, sums);
+    }
+    else
+    {
+        sums_generic(words, this->counts + first, offset(first), students, sums);
+    }
+    for (size_t i = 0; i < students; i++)
+    {
+        counts[i] = this->counts[first + i];
+    }
+}
+
+long u1_2_pack(FILE *input, FILE *output)
+{
+    InputReader reader(input);
+    Gradebook book;
+    std::vector<uint64_t> words;
+    std::vector<unsigned char> counts;
+    std::vector<uint32_t> checkpoints;
+    uint64_t grades = 0;
+
+    for (;;)
+    {
+        gradebook_clear(book);
+        if (!gradebook_read(reader, book, GRADEBOOK_BLOCK_STUDENTS))
+        {
+            return -1;
+        }
+
+        for (size_t s = 0; s < gradebook_students(book); s++)
+        {
+            size_t count = book.offsets[s + 1] - book.offsets[s];
+            if (count > (size_t)PACKED_MAX_COUNT || grades + count > UINT32_MAX)
+            {
+                return -1;
+            }
+            if (counts.size() % PACKED_CHECKPOINT_STUDENTS == 0)
+            {
+                checkpoints.push_back((uint32_t)grades);
+            }
+            counts.push_back((unsigned char)count);
+
+            for (size_t i = book.offsets[s]; i < book.offsets[s + 1]; i++, grades++)
+            {
+                unsigned field = (unsigned)(grades % PACKED_GRADES_PER_WORD);
+                if (book.grades[i] > PACKED_MAX_GRADE)
+                {
+                    return -1;
+                }
+                if (field == 0)
+                {
+                    words.push_back(0);
+                }
+                words.back() |= (uint64_t)book.grades[i] << (PACKED_GRADE_BITS * field);
+            }
+        }
+
+        if (gradebook_students(book) < GRADEBOOK_BLOCK_STUDENTS)
+        {
+            break;
+        }
+    }
+    if (!reader.at_end())
+    {
+        return -1;
+    }
+
+    PackedGradesHeader header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = PACKED_GRADES_VERSION;
+    header.bits_per_grade = PACKED_GRADE_BITS;
+    header.students = counts.size();
+    header.grades = grades;
+    if (counts.size() % PACKED_CHECKPOINT_STUDENTS == 0)
+    {
+        checkpoints.push_back((uint32_t)grades);
+    }
+    counts.resize((counts.size() + 3) & ~(size_t)3, 0);
+
+    OutputBuffer out(output);
+    out.write((const char *)&header, sizeof(header));
+    out.write((const char *)words.data(), words.size() * sizeof(uint64_t));
+    out.write((const char *)counts.data(), counts.size());
+    out.write((const char *)checkpoints.data(), checkpoints.size() * sizeof(uint32_t));
+    return (long)header.students;
+}
+
+long u1_2_packed(FILE *input, FILE *output)
+{
+    PackedGradebook book;
+    if (!book.open(input))
+    {
+        return -1;
+    }
+
+    OutputBuffer out(output);
+    std::vector<int> sums(BLOCK_STUDENTS);
+    std::vector<int> counts(BLOCK_STUDENTS);
+    std::vector<double> averages(BLOCK_STUDENTS);
+    std::vector<unsigned char> classes(BLOCK_STUDENTS);
+    std::vector<unsigned char> grades;
+
+    size_t students = book.students();
+    for (size_t first = 0; first < students; first += BLOCK_STUDENTS)
+    {
+        size_t block = students - first < BLOCK_STUDENTS ? students - first : BLOCK_STUDENTS;
+        book.sums(first, block, sums.data(), counts.data());
+        gradebook_averages(sums.data(), counts.data(), averages.data(), block);
+        classify_grade_sums(sums.data(), counts.data(), classes.data(), block);
+
+        uint64_t position = book.offset(first);
+        for (size_t i = 0; i < block; i++)
+        {
+            // The grades are unpacked only to be printed.
+            grades.resize((size_t)counts[i]);
+            for (size_t g = 0; g < grades.size(); g++, position++)
+            {
+                grades[g] = (unsigned char)book.grade(position);
+            }
+            char *p = out.reserve(format_grade_report_max_length(grades.size()));
+            out.commit(format_grade_report(p, grades.data(), grades.size(), averages[i],
+                                           grade_status_from_class(classes[i])));
+        }
+    }
+    return (long)students;
+}
+
+/** End of packed_grades.cpp */
\ No newline at end of file
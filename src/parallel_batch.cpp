@@ -0,0 +1,140 @@
+/**
+ * @file parallel_batch.cpp
+ * @brief Implementation of the order-preserving parallel batch driver.
+ * @details The calling thread cuts the input into chunks, submits one task per chunk and keeps the
+ *          chunks in a FIFO window. Once the window is full it waits for the oldest chunk, finishes
+ *          it, e.g. writes its output, and only then reads the next one, so the output device and
+ *          the workers stay busy at the same time while results still leave in input order.
+ *
+ * @see parallel_batch.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "parallel_batch.h"
+#include "thread_pool.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+/** Number of chunks in flight per worker; enough to keep every worker busy while output is written. */
+const unsigned CHUNKS_PER_THREAD = 4;
+
+/**
+ * @brief One slice of the input together with what is left to do for it on the calling thread.
+ */
+struct Chunk
+{
+    std::vector<char> copy;       ///< Private copy of streamed input; empty for mapped input.
+    const char *data;             ///< First byte of the slice.
+    size_t size;                  ///< Length of the slice.
+    std::function<long()> finish; ///< Returned by the ChunkProcessor.
+    bool done;                    ///< Set by the worker once finish is final.
+};
+} // namespace
+
+long parallel_chunks(FILE *input, unsigned threads, size_t chunk_size, const ChunkProcessor &process)
+{
+    InputReader reader(input, 2 * chunk_size);
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::deque<std::unique_ptr<Chunk>> window;
+    long records = 0;
+    bool malformed = false;
+
+    // Declared last so that it is destroyed, and its workers joined, before anything they touch.
+    ThreadPool pool(threads);
+
+    auto finish_oldest = [&]() {
+        std::unique_ptr<Chunk> chunk = std::move(window.front());
+        window.pop_front();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [&chunk] { return chunk->done; });
+        }
+        if (malformed)
+        {
+            return;
+        }
+        long chunk_records = chunk->finish();
+        if (chunk_records < 0)
+        {
+            malformed = true;
+        }
+        else
+        {
+            records += chunk_records;
+        }
+    };
+
+    const char *data = NULL;
+    size_t size = 0;
+    while (!malformed && reader.next_chunk(data, size, chunk_size))
+    {
+        Chunk *chunk = new Chunk;
+        if (reader.is_mapped())
+        {
+            chunk->data = data;
+        }
+        else
+        {
+            chunk->copy.assign(data, data + size);
+            chunk->data = &chunk->copy[0];
+        }
+        chunk->size = size;
+        chunk->done = false;
+        window.push_back(std::unique_ptr<Chunk>(chunk));
+
+        pool.submit([chunk, &process, &mutex, &finished] {
+            InputReader chunk_reader(chunk->data, chunk->size);
+            std::function<long()> finish = process(chunk_reader);
+            std::lock_guard<std::mutex> lock(mutex);
+            chunk->finish.swap(finish);
+            chunk->done = true;
+            finished.notify_all();
+        });
+
+        if (window.size() >= CHUNKS_PER_THREAD * pool.size())
+        {
+            finish_oldest();
+        }
+    }
+    while (!window.empty())
+    {
+        finish_oldest();
+    }
+
+    return malformed ? -1 : records;
+}
+
+long batch_parallel(BatchKernel kernel, FILE *input, FILE *output, unsigned threads, size_t chunk_size)
+{
+    if (threads == 0)
+    {
+        threads = ThreadPool::default_threads();
+    }
+    if (threads == 1)
+    {
+        InputReader reader(input);
+        OutputBuffer out(output);
+        return kernel(reader, out);
+    }
+
+    long records = parallel_chunks(input, threads, chunk_size, [kernel, output](InputReader &reader) {
+        std::shared_ptr<OutputBuffer> out(new OutputBuffer);
+        long chunk_records = kernel(reader, *out);
+        return std::function<long()>([out, chunk_records, output] {
+            fwrite(out->data(), 1, out->size(), output);
+            return chunk_records;
+        });
+    });
+    fflush(output);
+    return records;
+}
+
+/** End of parallel_batch.cpp */
\ No newline at end of file
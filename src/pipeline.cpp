@@ -0,0 +1,225 @@
+/**
+ * @file pipeline.cpp
+ * @brief Implementation of the staged batch driver.
+ * @details The calling thread is the reader; the workers and the writer run on their own threads.
+ *          Chunk n goes to worker n modulo the number of workers, and the writer takes chunk n from
+ *          the output ring of the same worker. The end of the input travels the same way: the
+ *          reader closes the input rings, each worker closes its output ring once drained, and the
+ *          writer stops at the first closed ring it is due to read from.
+ *
+ *          After a malformed record the writer stops writing but keeps returning chunks to the free
+ *          ring, so a reader waiting for a free chunk always wakes up and sees the flag.
+ *
+ * @see pipeline.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "pipeline.h"
+#include "spsc_ring.h"
+#include "thread_pool.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief One slice of the input together with the results computed for it.
+ */
+struct Chunk
+{
+    std::vector<char> copy; ///< Private copy of streamed input; unused for mapped input.
+    const char *data;       ///< First byte of the slice.
+    size_t size;            ///< Length of the slice.
+    OutputBuffer out;       ///< Formatted results.
+    long records;           ///< Result of the kernel.
+};
+
+/**
+ * @brief Returns the seconds elapsed since 'start' and moves 'start' to now.
+ */
+double lap(Clock::time_point &start)
+{
+    Clock::time_point now = Clock::now();
+    double seconds = std::chrono::duration<double>(now - start).count();
+    start = now;
+    return seconds;
+}
+
+/**
+ * @brief Adds the statistics of one worker to the compute stage.
+ */
+void add_stage(PipelineStage &total, const PipelineStage &part)
+{
+    total.busy_seconds += part.busy_seconds;
+    total.waiting_seconds += part.waiting_seconds;
+    total.chunks += part.chunks;
+    total.bytes += part.bytes;
+}
+
+/**
+ * @brief Prints one stage of print_pipeline_stats().
+ */
+void print_stage(FILE *output, const char *name, const PipelineStage &stage, const char *direction)
+{
+    double megabytes = (double)stage.bytes / (1 << 20);
+    fprintf(output, "%-8s %8llu chunks %10.1f MiB %-3s busy %7.3f s (%8.1f MiB/s) waiting %7.3f s\n", name,
+            stage.chunks, megabytes, direction, stage.busy_seconds,
+            stage.busy_seconds > 0 ? megabytes / stage.busy_seconds : 0.0, stage.waiting_seconds);
+}
+} // namespace
+
+long batch_pipeline(BatchKernel kernel, FILE *input, FILE *output, unsigned workers, PipelineStats *stats,
+                    size_t chunk_size)
+{
+    Clock::time_point started = Clock::now();
+    if (workers == 0)
+    {
+        workers = ThreadPool::default_threads();
+    }
+
+    std::vector<std::unique_ptr<Chunk>> pool(workers * PIPELINE_CHUNKS_PER_WORKER);
+    SpscRing<Chunk *> free_chunks(pool.size());
+    for (std::unique_ptr<Chunk> &chunk : pool)
+    {
+        chunk.reset(new Chunk);
+        free_chunks.push(chunk.get());
+    }
+    std::vector<std::unique_ptr<SpscRing<Chunk *>>> inputs;
+    std::vector<std::unique_ptr<SpscRing<Chunk *>>> outputs;
+    for (unsigned w = 0; w < workers; w++)
+    {
+        inputs.push_back(std::unique_ptr<SpscRing<Chunk *>>(new SpscRing<Chunk *>(PIPELINE_CHUNKS_PER_WORKER)));
+        outputs.push_back(std::unique_ptr<SpscRing<Chunk *>>(new SpscRing<Chunk *>(PIPELINE_CHUNKS_PER_WORKER)));
+    }
+
+    PipelineStage reader_stage = PipelineStage();
+    PipelineStage writer_stage = PipelineStage();
+    std::vector<PipelineStage> worker_stages(workers, PipelineStage());
+    std::atomic<bool> malformed(false);
+    long records = 0;
+
+    std::vector<std::thread> threads;
+    for (unsigned w = 0; w < workers; w++)
+    {
+        threads.push_back(std::thread([&, w] {
+            PipelineStage &stage = worker_stages[w];
+            Clock::time_point mark = Clock::now();
+            Chunk *chunk = NULL;
+            while (inputs[w]->pop(chunk))
+            {
+                stage.waiting_seconds += lap(mark);
+                InputReader chunk_reader(chunk->data, chunk->size);
+                chunk->records = kernel(chunk_reader, chunk->out);
+                stage.chunks++;
+                stage.bytes += chunk->out.size();
+                stage.busy_seconds += lap(mark);
+                outputs[w]->push(chunk);
+                stage.waiting_seconds += lap(mark);
+            }
+            stage.waiting_seconds += lap(mark);
+            outputs[w]->close();
+        }));
+    }
+
+    threads.push_back(std::thread([&] {
+        Clock::time_point mark = Clock::now();
+        Chunk *chunk = NULL;
+        for (unsigned long long n = 0; outputs[n % workers]->pop(chunk); n++)
+        {
+            writer_stage.waiting_seconds += lap(mark);
+            if (!malformed.load(std::memory_order_relaxed))
+            {
+                fwrite(chunk->out.data(), 1, chunk->out.size(), output);
+                writer_stage.bytes += chunk->out.size();
+                if (chunk->records < 0)
+                {
+                    malformed.store(true, std::memory_order_relaxed);
+                }
+                else
+                {
+                    records += chunk->records;
+                }
+            }
+            chunk->out.clear();
+            writer_stage.chunks++;
+            writer_stage.busy_seconds += lap(mark);
+            free_chunks.push(chunk);
+        }
+        fflush(output);
+        writer_stage.busy_seconds += lap(mark);
+    }));
+
+    // The calling thread is the reader.
+    {
+        InputReader reader(input, 2 * chunk_size);
+        Clock::time_point mark = Clock::now();
+        const char *data = NULL;
+        size_t size = 0;
+        for (unsigned long long n = 0; !malformed.load(std::memory_order_relaxed); n++)
+        {
+            Chunk *chunk = NULL;
+            free_chunks.pop(chunk);
+            reader_stage.waiting_seconds += lap(mark);
+            if (malformed.load(std::memory_order_relaxed) || !reader.next_chunk(data, size, chunk_size))
+            {
+                break;
+            }
+            if (reader.is_mapped())
+            {
+                chunk->data = data;
+            }
+            else
+            {
+                chunk->copy.assign(data, data + size);
+                chunk->data = &chunk->copy[0];
+            }
+            chunk->size = size;
+            reader_stage.chunks++;
+            reader_stage.bytes += size;
+            reader_stage.busy_seconds += lap(mark);
+            inputs[n % workers]->push(chunk);
+            reader_stage.waiting_seconds += lap(mark);
+        }
+        for (unsigned w = 0; w < workers; w++)
+        {
+            inputs[w]->close();
+        }
+        reader_stage.busy_seconds += lap(mark);
+
+        // Mapped chunks point into the reader, which must outlive the stages.
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    if (stats)
+    {
+        stats->reader = reader_stage;
+        stats->writer = writer_stage;
+        stats->compute = PipelineStage();
+        for (const PipelineStage &stage : worker_stages)
+        {
+            add_stage(stats->compute, stage);
+        }
+        stats->workers = workers;
+        stats->seconds = std::chrono::duration<double>(Clock::now() - started).count();
+    }
+    return malformed.load() ? -1 : records;
+}
+
+void print_pipeline_stats(const PipelineStats &stats, FILE *output)
+{
+    print_stage(output, "reader", stats.reader, "in");
+    print_stage(output, "compute", stats.compute, "out");
+    print_stage(output, "writer", stats.writer, "out");
+    fprintf(output, "%u workers, %.3f s wall clock\n", stats.workers, stats.seconds);
+}
+
+/** End of pipeline.cpp */
\ No newline at end of file
@@ -0,0 +1,286 @@
+/**
+ * @file ranking.cpp
+ * @brief Implementation of the streaming student ranking.
+ * @details Every list is a binary heap of at most k students ordered so that the student who would
+ *          leave the list first sits on top. A new student replaces the top only if they rank
+ *          before it, which keeps the cost per student at O(log k). The heaps are sorted only when
+ *          the lists are printed.
+ *
+ * @see ranking.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "ranking.h"
+#include "buffered_io.h"
+#include "format.h"
+#include "grade_class.h"
+#include "gradebook.h"
+#include "parallel_batch.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string.h>
+
+namespace
+{
+/** Upper bound of a list header or of one listed student. */
+const size_t MAX_LINE_LENGTH = 96;
+
+/** Size of the input slices ranked by one task. */
+const size_t CHUNK_SIZE = 1 << 20;
+
+/** Headers of the partitions, in RankingPartition order. */
+const char *const PARTITION_NAMES[RANKING_PARTITIONS] = {"Všichni studenti", "Prospěl s vyznamenáním", "Prospěl",
+                                                         "Neprospěl"};
+
+/** Partition of every class bit, in GradeClassBits order. */
+const int CLASS_PARTITIONS[3][2] = {
+    {GRADE_DISTINCTION, RANK_DISTINCTION}, {GRADE_PASSED, RANK_PASSED}, {GRADE_FAILED, RANK_FAILED}};
+
+/**
+ * @brief Compares the averages of two students exactly.
+ * @return Negative, zero or positive as the average of 'a' is lower, equal or higher.
+ */
+inline long long compare_averages(const RankedStudent &a, const RankedStudent &b)
+{
+    return (long long)a.sum * b.count - (long long)b.sum * a.count;
+}
+
+/**
+ * @brief Order of the best list: lower average first, then lower student number.
+ */
+bool ranks_better(const RankedStudent &a, const RankedStudent &b)
+{
+    long long order = compare_averages(a, b);
+    return order != 0 ? order < 0 : a.student < b.student;
+}
+
+/**
+ * @brief Order of the worst list: higher average first, then lower student number.
+ */
+bool ranks_worse(const RankedStudent &a, const RankedStudent &b)
+{
+    long long order = compare_averages(a, b);
+    return order != 0 ? order > 0 : a.student < b.student;
+}
+
+/**
+ * @brief Offers a student to a bounded heap ordered by 'precedes'.
+ */
+template <typename Compare>
+void offer(std::vector<RankedStudent> &heap, size_t limit, const RankedStudent &student, Compare precedes)
+{
+    if (heap.size() < limit)
+    {
+        heap.push_back(student);
+        std::push_heap(heap.begin(), heap.end(), precedes);
+    }
+    else if (limit > 0 && precedes(student, heap.front()))
+    {
+        std::pop_heap(heap.begin(), heap.end(), precedes);
+        heap.back() = student;
+        std::push_heap(heap.begin(), heap.end(), precedes);
+    }
+}
+
+/**
+ * @brief Returns the contents of a heap in list order.
+ */
+template <typename Compare>
+std::vector<RankedStudent> sorted(const std::vector<RankedStudent> &heap, Compare precedes)
+{
+    std::vector<RankedStudent> list(heap);
+    std::sort(list.begin(), list.end(), precedes);
+    return list;
+}
+
+/**
+ * @brief Writes one list with its header.
+ */
+char *format_list(char *p, const char *name, const char *kind, const std::vector<RankedStudent> &list)
+{
+    size_t length = strlen(name);
+    memcpy(p, name, length);
+    p = format_literal(p + length, " (");
+    length = strlen(kind);
+    memcpy(p, kind, length);
+    p = format_literal(p + length, "):\n");
+    for (size_t i = 0; i < list.size(); i++)
+    {
+        p = format_long(p, (long long)i + 1);
+        p = format_literal(p, ". Student ");
+        p = format_long(p, list[i].student);
+        p = format_literal(p, ": ");
+        p = format_fixed(p, (double)list[i].sum / list[i].count, 2);
+        *p++ = '\n';
+    }
+    return p;
+}
+
+/**
+ * @brief Ranks every student the reader yields, numbering them from 1.
+ * @return Number of students, or -1 if a malformed record was found.
+ */
+long rank_students(InputReader &reader, StudentRanking &ranking)
+{
+    Gradebook book;
+    std::vector<int> sums(GRADEBOOK_BLOCK_STUDENTS);
+    std::vector<int> counts(GRADEBOOK_BLOCK_STUDENTS);
+    std::vector<unsigned char> classes(GRADEBOOK_BLOCK_STUDENTS);
+
+    long students = 0;
+    bool wellformed = true;
+    for (;;)
+    {
+        gradebook_clear(book);
+        wellformed = gradebook_read(reader, book, GRADEBOOK_BLOCK_STUDENTS);
+        size_t block = gradebook_students(book);
+        gradebook_sums(book, sums.data());
+        gradebook_counts(book, counts.data());
+        classify_grade_sums(sums.data(), counts.data(), classes.data(), block);
+        ranking.add(students + 1, sums.data(), counts.data(), classes.data(), block);
+        students += (long)block;
+        if (!wellformed || block < GRADEBOOK_BLOCK_STUDENTS)
+        {
+            break;
+        }
+    }
+    return wellformed && reader.at_end() ? students : -1;
+}
+
+/**
+ * @brief Writes the ranking to the output stream.
+ */
+void write_ranking(const StudentRanking &ranking, FILE *output)
+{
+    OutputBuffer out(output);
+    out.commit(ranking.format(out.reserve(ranking.format_max_length())));
+}
+} // namespace
+
+StudentRanking::StudentRanking(size_t size) : limit(size)
+{
+}
+
+void StudentRanking::add(long long student, int sum, int count, unsigned char grade_class)
+{
+    if (grade_class & GRADE_INVALID)
+    {
+        return;
+    }
+    RankedStudent ranked = {student, sum, count};
+    offer(best_heaps[RANK_ALL], limit, ranked, ranks_better);
+    offer(worst_heaps[RANK_ALL], limit, ranked, ranks_worse);
+    for (const auto &partition : CLASS_PARTITIONS)
+    {
+        if (grade_class & partition[0])
+        {
+            offer(best_heaps[partition[1]], limit, ranked, ranks_better);
+            offer(worst_heaps[partition[1]], limit, ranked, ranks_worse);
+        }
+    }
+}
+
+void StudentRanking::add(long long first_student, const int *sums, const int *counts, const unsigned char *classes,
+                         size_t students)
+{
+    for (size_t i = 0; i < students; i++)
+    {
+        add(first_student + (long long)i, sums[i], counts[i], classes[i]);
+    }
+}
+
+void StudentRanking::merge(const StudentRanking &other, long long student_offset)
+{
+    for (int partition = 0; partition < RANKING_PARTITIONS; partition++)
+    {
+        for (RankedStudent ranked : other.best_heaps[partition])
+        {
+            ranked.student += student_offset;
+            offer(best_heaps[partition], limit, ranked, ranks_better);
+        }
+        for (RankedStudent ranked : other.worst_heaps[partition])
+        {
+            ranked.student += student_offset;
+            offer(worst_heaps[partition], limit, ranked, ranks_worse);
+        }
+    }
+}
+
+std::vector<RankedStudent> StudentRanking::best(int partition) const
+{
+    return sorted(best_heaps[partition], ranks_better);
+}
+
+std::vector<RankedStudent> StudentRanking::worst(int partition) const
+{
+    return sorted(worst_heaps[partition], ranks_worse);
+}
+
+size_t StudentRanking::size() const
+{
+    return limit;
+}
+
+size_t StudentRanking::format_max_length() const
+{
+    return 2 * RANKING_PARTITIONS * MAX_LINE_LENGTH * (limit + 1);
+}
+
+char *StudentRanking::format(char *p) const
+{
+    for (int partition = 0; partition < RANKING_PARTITIONS; partition++)
+    {
+        p = format_list(p, PARTITION_NAMES[partition], "nejlepší", best(partition));
+        p = format_list(p, PARTITION_NAMES[partition], "nejhorší", worst(partition));
+    }
+    return p;
+}
+
+long u1_2_ranking(FILE *input, FILE *output)
+{
+    return u1_2_ranking(input, output, RANKING_DEFAULT_SIZE, 1);
+}
+
+long u1_2_ranking(FILE *input, FILE *output, size_t size, unsigned threads)
+{
+    if (threads == 0)
+    {
+        threads = ThreadPool::default_threads();
+    }
+    StudentRanking ranking(size);
+    if (threads == 1)
+    {
+        InputReader reader(input);
+        long students = rank_students(reader, ranking);
+        if (students >= 0)
+        {
+            write_ranking(ranking, output);
+        }
+        return students;
+    }
+
+    long merged = 0;
+    long students = parallel_chunks(input, threads, CHUNK_SIZE, [size, &ranking, &merged](InputReader &reader) {
+        std::shared_ptr<StudentRanking> part(new StudentRanking(size));
+        long chunk_students = rank_students(reader, *part);
+        return std::function<long()>([part, chunk_students, &ranking, &merged] {
+            if (chunk_students >= 0)
+            {
+                ranking.merge(*part, merged);
+                merged += chunk_students;
+            }
+            return chunk_students;
+        });
+    });
+    if (students < 0)
+    {
+        return -1;
+    }
+    write_ranking(ranking, output);
+    return students;
+}
+
+/** End of ranking.cpp */
\ No newline at end of file
@@ -0,0 +1,254 @@
+/**
+ * @file rate_history.cpp
+ * @brief Implementation of the rate history, its Eytzinger index and the sweeping cursor.
+ * @details The Eytzinger search walks down the implicit tree, always to the right while the node
+ *          is not later than the wanted time. When it falls off the tree, the trailing one bits of
+ *          the node number encode the final right turns; shifting them out, and one more bit, gives
+ *          the node of the first point later than the time, whose rank is one past the answer.
+ *
+ * @see rate_history.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "rate_history.h"
+#include "format.h"
+#include "functions.h"
+#include "rate_table.h"
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+/** Number of points the cursor steps forward before it searches instead. */
+const long long MAX_CURSOR_STEPS = 8;
+
+/** Upper bound of the validity line after a conversion. */
+const size_t MAX_SINCE_LENGTH = 48;
+
+/**
+ * @brief Copies sorted times into Eytzinger order, remembering the rank of every node.
+ * @return Rank of the next time to place.
+ */
+size_t fill_tree(const std::vector<long long> &times, std::vector<long long> &tree, std::vector<uint32_t> &ranks,
+                 size_t rank, size_t node)
+{
+    if (node < tree.size())
+    {
+        rank = fill_tree(times, tree, ranks, rank, 2 * node);
+        tree[node] = times[rank];
+        ranks[node] = (uint32_t)rank;
+        rank = fill_tree(times, tree, ranks, rank + 1, 2 * node + 1);
+    }
+    return rank;
+}
+} // namespace
+
+RateHistory::RateHistory() : slots(RATE_TABLE_SLOTS, -1), total(0)
+{
+}
+
+int RateHistory::series_of(const CurrencyCode &code) const
+{
+    uint32_t key = 0;
+    if (code.tag != CURRENCY_INLINE || !currency_key(code.bytes, 3, key) || !is_iso_currency(key))
+    {
+        return -1;
+    }
+    return slots[currency_slot(key)];
+}
+
+bool RateHistory::add(const CurrencyCode &code, long long time, double rate)
+{
+    uint32_t key = 0;
+    if (code.tag != CURRENCY_INLINE || !currency_key(code.bytes, 3, key) || !is_iso_currency(key))
+    {
+        return false;
+    }
+    int &index = slots[currency_slot(key)];
+    if (index < 0)
+    {
+        index = (int)series.size();
+        series.push_back(Series());
+    }
+    Series &points = series[index];
+    points.times.push_back(time);
+    points.rates.push_back(rate);
+    points.sorted = false;
+    return true;
+}
+
+void RateHistory::finalize()
+{
+    total = 0;
+    for (Series &points : series)
+    {
+        if (!points.sorted)
+        {
+            std::vector<std::pair<long long, double>> merged(points.times.size());
+            for (size_t i = 0; i < merged.size(); i++)
+            {
+                merged[i] = std::make_pair(points.times[i], points.rates[i]);
+            }
+            std::stable_sort(merged.begin(), merged.end(),
+                             [](const std::pair<long long, double> &a, const std::pair<long long, double> &b) {
+                                 return a.first < b.first;
+                             });
+
+            // Of equal times the last added point wins.
+            points.times.clear();
+            points.rates.clear();
+            for (size_t i = 0; i < merged.size(); i++)
+            {
+                if (i + 1 < merged.size() && merged[i + 1].first == merged[i].first)
+                {
+                    continue;
+                }
+                points.times.push_back(merged[i].first);
+                points.rates.push_back(merged[i].second);
+            }
+
+            points.tree.assign(points.times.size() + 1, 0);
+            points.ranks.assign(points.times.size() + 1, 0);
+            fill_tree(points.times, points.tree, points.ranks, 0, 1);
+            points.sorted = true;
+        }
+        total += points.times.size();
+    }
+}
+
+bool RateHistory::load(FILE *input)
+{
+    InputReader reader(input);
+    CurrencyCode code;
+    bool wellformed = true;
+    while (wellformed && next_currency_code(reader, code, wellformed))
+    {
+        long long time = 0;
+        double rate = 0;
+        wellformed = wellformed && reader.next_long(time) && reader.next_double(rate) && rate > 0 &&
+                     add(code, time, rate);
+    }
+    finalize();
+    return wellformed && reader.at_end();
+}
+
+/**
+ * @brief Returns the position of the last point not later than the time, or -1.
+ */
+long long RateHistory::search(const Series &points, long long time)
+{
+    size_t count = points.times.size();
+    size_t node = 1;
+    while (node <= count)
+    {
+        node = 2 * node + (size_t)(points.tree[node] <= time);
+    }
+    while (node & 1)
+    {
+        node >>= 1;
+    }
+    node >>= 1;
+    size_t upper = node ? points.ranks[node] : count;
+    return (long long)upper - 1;
+}
+
+bool RateHistory::rate_at(const CurrencyCode &code, long long time, double &rate, long long &since) const
+{
+    int index = series_of(code);
+    if (index < 0)
+    {
+        return false;
+    }
+    const Series &points = series[index];
+    long long position = search(points, time);
+    if (position < 0)
+    {
+        return false;
+    }
+    rate = points.rates[position];
+    since = points.times[position];
+    return true;
+}
+
+size_t RateHistory::points() const
+{
+    return total;
+}
+
+RateHistory::Cursor::Cursor(const RateHistory &history) : history(history), positions(history.series.size(), -1)
+{
+}
+
+bool RateHistory::Cursor::rate_at(const CurrencyCode &code, long long time, double &rate, long long &since)
+{
+    int index = history.series_of(code);
+    if (index < 0)
+    {
+        return false;
+    }
+    const Series &points = history.series[index];
+    const long long count = (long long)points.times.size();
+    long long &position = positions[index];
+
+    if (position >= 0 && points.times[position] <= time)
+    {
+        // Merge step: move forward while the next point is still valid at this time.
+        long long steps = 0;
+        while (position + 1 < count && points.times[position + 1] <= time && steps < MAX_CURSOR_STEPS)
+        {
+            position++;
+            steps++;
+        }
+        if (position + 1 < count && points.times[position + 1] <= time)
+        {
+            position = search(points, time);
+        }
+    }
+    else
+    {
+        position = search(points, time);
+    }
+
+    if (position < 0)
+    {
+        return false;
+    }
+    rate = points.rates[position];
+    since = points.times[position];
+    return true;
+}
+
+long u1_3_history_conversions(const RateHistory &history, InputReader &reader, OutputBuffer &out)
+{
+    const size_t MAX_CONVERSION_LENGTH = format_conversion_max_length(3) + MAX_SINCE_LENGTH;
+    RateHistory::Cursor cursor(history);
+
+    long records = 0;
+    CurrencyCode currency;
+    bool valid = true;
+    while (next_currency_code(reader, currency, valid))
+    {
+        long long time = 0;
+        int count = 0;
+        double rate = 0;
+        long long since = 0;
+        if (!valid || !reader.next_long(time) || !reader.next_int(count) ||
+            !cursor.rate_at(currency, time, rate, since))
+        {
+            return -1;
+        }
+
+        char *p = out.reserve(MAX_CONVERSION_LENGTH);
+        p = format_u1_3_conversion(p, currency.bytes, 3, rate, count, round_half_up(rate * count));
+        p = format_literal(p, "Kurz platný od: ");
+        p = format_long(p, since);
+        *p++ = '\n';
+        out.commit(p);
+        records++;
+    }
+
+    return reader.at_end() ? records : -1;
+}
+
+/** End of rate_history.cpp */
\ No newline at end of file
@@ -0,0 +1,297 @@
+/**
+ * @file rate_snapshot.cpp
+ * @brief Implementation of the rate snapshots, their hazard-pointer reclamation and the watcher.
+ * @details A reader stores the snapshot it wants into its hazard slot and then checks that the
+ *          snapshot is still current; the publisher swaps the pointer first and then scans the
+ *          slots. Both sides use sequentially consistent operations, so either the reader sees the
+ *          new pointer and retries, or the publisher sees the hazard and keeps the old snapshot for
+ *          a later scan. Replaced snapshots are scanned on every publish.
+ *
+ * @see rate_snapshot.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "rate_snapshot.h"
+#include "format.h"
+#include "functions.h"
+#include <chrono>
+#include <sys/stat.h>
+
+namespace
+{
+/** Upper bound of the version line after a conversion. */
+const size_t MAX_VERSION_LENGTH = 48;
+
+/**
+ * @brief Extracts what RateFileWatcher compares: device, inode, size and modification time.
+ */
+void file_identity(const struct stat &status, unsigned long long identity[5])
+{
+    identity[0] = (unsigned long long)status.st_dev;
+    identity[1] = (unsigned long long)status.st_ino;
+    identity[2] = (unsigned long long)status.st_size;
+    identity[3] = (unsigned long long)status.st_mtim.tv_sec;
+    identity[4] = (unsigned long long)status.st_mtim.tv_nsec;
+}
+
+bool same_identity(const unsigned long long a[5], const unsigned long long b[5])
+{
+    for (int i = 0; i < 5; i++)
+    {
+        if (a[i] != b[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+RateSnapshots::RateSnapshots() : current(NULL), versions(0)
+{
+    for (size_t i = 0; i < RATE_SNAPSHOT_READERS; i++)
+    {
+        hazards[i].store(NULL);
+        claimed[i].store(false);
+    }
+}
+
+RateSnapshots::~RateSnapshots()
+{
+    delete current.load();
+    for (size_t i = 0; i < replaced.size(); i++)
+    {
+        delete replaced[i];
+    }
+}
+
+unsigned long long RateSnapshots::publish(const RateTable &rates)
+{
+    RateSnapshot *snapshot = new RateSnapshot;
+    snapshot->rates = rates;
+
+    std::lock_guard<std::mutex> lock(writer);
+    snapshot->version = ++versions;
+    const RateSnapshot *previous = current.exchange(snapshot);
+    if (previous)
+    {
+        replaced.push_back(previous);
+    }
+    reclaim();
+    return snapshot->version;
+}
+
+/**
+ * @brief Frees the replaced snapshots that no hazard slot announces; the writer lock is held.
+ */
+void RateSnapshots::reclaim()
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < replaced.size(); i++)
+    {
+        bool hazardous = false;
+        for (size_t slot = 0; slot < RATE_SNAPSHOT_READERS && !hazardous; slot++)
+        {
+            hazardous = hazards[slot].load() == replaced[i];
+        }
+        if (hazardous)
+        {
+            replaced[kept++] = replaced[i];
+        }
+        else
+        {
+            delete replaced[i];
+        }
+    }
+    replaced.resize(kept);
+}
+
+unsigned long long RateSnapshots::version() const
+{
+    const RateSnapshot *snapshot = current.load();
+    return snapshot ? snapshot->version : 0;
+}
+
+size_t RateSnapshots::retired() const
+{
+    std::lock_guard<std::mutex> lock(writer);
+    return replaced.size();
+}
+
+RateSnapshots::Reader::Reader(RateSnapshots &snapshots) : owner(snapshots), slot(0)
+{
+    for (;;)
+    {
+        bool expected = false;
+        if (owner.claimed[slot].compare_exchange_strong(expected, true, std::memory_order_acquire))
+        {
+            return;
+        }
+        if (++slot == RATE_SNAPSHOT_READERS)
+        {
+            slot = 0;
+            std::this_thread::yield();
+        }
+    }
+}
+
+RateSnapshots::Reader::~Reader()
+{
+    release();
+    owner.claimed[slot].store(false, std::memory_order_release);
+}
+
+const RateSnapshot *RateSnapshots::Reader::acquire()
+{
+    std::atomic<const RateSnapshot *> &hazard = owner.hazards[slot];
+    const RateSnapshot *snapshot = owner.current.load();
+    for (;;)
+    {
+        hazard.store(snapshot);
+        const RateSnapshot *again = owner.current.load();
+        if (again == snapshot)
+        {
+            return snapshot;
+        }
+        snapshot = again;
+    }
+}
+
+void RateSnapshots::Reader::release()
+{
+    owner.hazards[slot].store(NULL, std::memory_order_release);
+}
+
+RateFileWatcher::RateFileWatcher(const char *path, RateSnapshots &snapshots)
+    : path(path), snapshots(snapshots), seen(false), stopping(false)
+{
+    for (int i = 0; i < 5; i++)
+    {
+        identity[i] = 0;
+    }
+}
+
+RateFileWatcher::~RateFileWatcher()
+{
+    stop();
+}
+
+bool RateFileWatcher::check()
+{
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0)
+    {
+        return false;
+    }
+    unsigned long long now[5];
+    file_identity(status, now);
+    bool changed = !seen || !same_identity(now, identity);
+    for (int i = 0; i < 5; i++)
+    {
+        identity[i] = now[i];
+    }
+    seen = true;
+    if (!changed)
+    {
+        return false;
+    }
+
+    FILE *input = fopen(path.c_str(), "rb");
+    if (!input)
+    {
+        return false;
+    }
+    std::unique_ptr<RateTable> rates(new RateTable);
+    unsigned long long before[5];
+    unsigned long long after[5];
+    bool settled = fstat(fileno(input), &status) == 0;
+    file_identity(status, before);
+    bool loaded = rates->load(input);
+    settled = settled && fstat(fileno(input), &status) == 0;
+    file_identity(status, after);
+    fclose(input);
+
+    if (!settled || !same_identity(now, before) || !same_identity(before, after))
+    {
+        // The file is being written; whatever was read may be partial, so try again on the next check.
+        seen = false;
+        return false;
+    }
+    if (!loaded)
+    {
+        return false;
+    }
+    snapshots.publish(*rates);
+    return true;
+}
+
+void RateFileWatcher::start(unsigned interval_ms)
+{
+    stop();
+    poller = std::thread([this, interval_ms] {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping)
+        {
+            lock.unlock();
+            check();
+            lock.lock();
+            wakeup.wait_for(lock, std::chrono::milliseconds(interval_ms), [this] { return stopping; });
+        }
+    });
+}
+
+void RateFileWatcher::stop()
+{
+    if (!poller.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    poller.join();
+    stopping = false;
+}
+
+long u1_3_live_quotes(RateSnapshots &snapshots, InputReader &reader, OutputBuffer &out)
+{
+    const size_t MAX_CONVERSION_LENGTH = format_conversion_max_length(3) + MAX_VERSION_LENGTH;
+    RateSnapshots::Reader rates(snapshots);
+
+    long records = 0;
+    CurrencyCode currency;
+    bool valid = true;
+    while (next_currency_code(reader, currency, valid))
+    {
+        if (!valid)
+        {
+            return -1;
+        }
+        const RateSnapshot *snapshot = rates.acquire();
+        double rate = 0;
+        bool found = snapshot && snapshot->rates.find(currency, rate);
+        unsigned long long version = snapshot ? snapshot->version : 0;
+        rates.release();
+
+        int count = 0;
+        if (!found || !reader.next_int(count))
+        {
+            return -1;
+        }
+
+        char *p = out.reserve(MAX_CONVERSION_LENGTH);
+        p = format_u1_3_conversion(p, currency.bytes, 3, rate, count, round_half_up(rate * count));
+        p = format_literal(p, "Verze kurzů: ");
+        p = format_long(p, (long long)version);
+        *p++ = '\n';
+        out.commit(p);
+        records++;
+    }
+
+    return reader.at_end() ? records : -1;
+}
+
+/** End of rate_snapshot.cpp */
\ No newline at end of file
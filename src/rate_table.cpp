@@ -0,0 +1,197 @@
+/**
+ * @file rate_table.cpp
+ * @brief Implementation of the ISO 4217 rate table and the quote mode.
+ * @details The code list below is the whole key set of the perfect hash. The static_assert walks
+ *          all pairs of codes at compile time, so a code added to the list that collides with
+ *          another one stops the build instead of silently sharing a slot.
+ *
+ * @see rate_table.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "rate_table.h"
+#include "format.h"
+#include "functions.h"
+#include <algorithm>
+#include <math.h>
+
+namespace
+{
+/** Active ISO 4217 currency codes, including the fund and precious-metal codes. */
+constexpr char ISO_4217_CODES[][4] = {
+    "AED", "AFN", "ALL", "AMD", "ANG", "AOA", "ARS", "AUD", "AWG", "AZN", "BAM", "BBD", "BDT", "BGN", "BHD", "BIF",
+    "BMD", "BND", "BOB", "BOV", "BRL", "BSD", "BTN", "BWP", "BYN", "BZD", "CAD", "CDF", "CHE", "CHF", "CHW", "CLF",
+    "CLP", "CNY", "COP", "COU", "CRC", "CUC", "CUP", "CVE", "CZK", "DJF", "DKK", "DOP", "DZD", "EGP", "ERN", "ETB",
+    "EUR", "FJD", "FKP", "GBP", "GEL", "GHS", "GIP", "GMD", "GNF", "GTQ", "GYD", "HKD", "HNL", "HTG", "HUF", "IDR",
+    "ILS", "INR", "IQD", "IRR", "ISK", "JMD", "JOD", "JPY", "KES", "KGS", "KHR", "KMF", "KPW", "KRW", "KWD", "KYD",
+    "KZT", "LAK", "LBP", "LKR", "LRD", "LSL", "LYD", "MAD", "MDL", "MGA", "MKD", "MMK", "MNT", "MOP", "MRU", "MUR",
+    "MVR", "MWK", "MXN", "MXV", "MYR", "MZN", "NAD", "NGN", "NIO", "NOK", "NPR", "NZD", "OMR", "PAB", "PEN", "PGK",
+    "PHP", "PKR", "PLN", "PYG", "QAR", "RON", "RSD", "RUB", "RWF", "SAR", "SBD", "SCR", "SDG", "SEK", "SGD", "SHP",
+    "SLE", "SLL", "SOS", "SRD", "SSP", "STN", "SVC", "SYP", "SZL", "THB", "TJS", "TMT", "TND", "TOP", "TRY", "TTD",
+    "TWD", "TZS", "UAH", "UGX", "USD", "USN", "UYI", "UYU", "UYW", "UZS", "VED", "VES", "VND", "VUV", "WST", "XAF",
+    "XAG", "XAU", "XBA", "XBB", "XBC", "XBD", "XCD", "XCG", "XDR", "XOF", "XPD", "XPF", "XPT", "XSU", "XTS", "XUA",
+    "XXX", "YER", "ZAR", "ZMW", "ZWG", "ZWL"};
+
+/** Number of codes in the list. */
+constexpr size_t ISO_4217_COUNT = sizeof(ISO_4217_CODES) / sizeof(ISO_4217_CODES[0]);
+
+/**
+ * @brief Tells whether code 'i' shares its slot with any code from 'j' on.
+ */
+constexpr bool collides(size_t i, size_t j)
+{
+    return j < ISO_4217_COUNT && (currency_slot(currency_key(ISO_4217_CODES[i])) ==
+                                      currency_slot(currency_key(ISO_4217_CODES[j])) ||
+                                  collides(i, j + 1));
+}
+
+/**
+ * @brief Tells whether the codes from 'i' on all have slots of their own.
+ */
+constexpr bool collision_free(size_t i)
+{
+    return i >= ISO_4217_COUNT || (!collides(i, i + 1) && collision_free(i + 1));
+}
+
+static_assert(collision_free(0), "RATE_HASH_MULTIPLIER is not a perfect hash of the ISO 4217 codes");
+
+/**
+ * @brief Slot table holding the key of the ISO code assigned to every slot.
+ */
+struct IsoSlots
+{
+    uint16_t keys[RATE_TABLE_SLOTS];
+
+    IsoSlots()
+    {
+        for (size_t i = 0; i < RATE_TABLE_SLOTS; i++)
+        {
+            keys[i] = RATE_EMPTY_KEY;
+        }
+        for (size_t i = 0; i < ISO_4217_COUNT; i++)
+        {
+            uint32_t key = currency_key(ISO_4217_CODES[i]);
+            keys[currency_slot(key)] = (uint16_t)key;
+        }
+    }
+};
+
+const IsoSlots ISO_SLOTS;
+} // namespace
+
+bool is_iso_currency(uint32_t key)
+{
+    return ISO_SLOTS.keys[currency_slot(key)] == key;
+}
+
+RateTable::RateTable() : count(0)
+{
+    for (size_t i = 0; i < RATE_TABLE_SLOTS; i++)
+    {
+        keys[i] = RATE_EMPTY_KEY;
+        rates[i] = 0;
+    }
+}
+
+bool RateTable::set(const char *code, size_t length, double rate)
+{
+    uint32_t key = 0;
+    if (!currency_key(code, length, key) || !is_iso_currency(key))
+    {
+        return false;
+    }
+    uint32_t slot = currency_slot(key);
+    if (keys[slot] == RATE_EMPTY_KEY)
+    {
+        count++;
+    }
+    keys[slot] = (uint16_t)key;
+    rates[slot] = rate;
+    return true;
+}
+
+size_t RateTable::size() const
+{
+    return count;
+}
+
+void RateTable::list(uint32_t *listed_keys, double *listed_rates) const
+{
+    size_t listed = 0;
+    for (size_t slot = 0; slot < RATE_TABLE_SLOTS; slot++)
+    {
+        if (keys[slot] != RATE_EMPTY_KEY)
+        {
+            listed_keys[listed++] = keys[slot];
+        }
+    }
+    std::sort(listed_keys, listed_keys + listed);
+    for (size_t i = 0; i < listed; i++)
+    {
+        listed_rates[i] = rates[currency_slot(listed_keys[i])];
+    }
+}
+
+bool next_currency_code(InputReader &reader, CurrencyCode &code, bool &valid)
+{
+    const char *word = NULL;
+    size_t length = 0;
+    if (!reader.next_word(word, length))
+    {
+        return false;
+    }
+    // Packing copies the code, which a refill of streamed input may move.
+    valid = currency_code_pack(word, length, code) && valid;
+    return true;
+}
+
+bool RateTable::load(FILE *input)
+{
+    InputReader reader(input);
+    CurrencyCode currency;
+    bool valid = true;
+    while (next_currency_code(reader, currency, valid))
+    {
+        double rate = 0;
+        if (!valid || !reader.next_double(rate) || !(rate > 0) || isinf(rate) || !set(currency.bytes, 3, rate))
+        {
+            return false;
+        }
+    }
+    // An empty file is rejected too: it is what a rate file looks like while it is rewritten in place.
+    return reader.at_end() && size() > 0;
+}
+
+long u1_3_quotes(const RateTable &rates, InputReader &reader, OutputBuffer &out)
+{
+    const size_t MAX_CONVERSION_LENGTH = format_conversion_max_length(3);
+
+    long records = 0;
+    CurrencyCode currency;
+    bool valid = true;
+    while (next_currency_code(reader, currency, valid))
+    {
+        double rate = 0;
+        int count = 0;
+        if (!valid || !rates.find(currency, rate) || !reader.next_int(count))
+        {
+            return -1;
+        }
+
+        char *p = out.reserve(MAX_CONVERSION_LENGTH);
+        out.commit(format_u1_3_conversion(p, currency.bytes, 3, rate, count, round_half_up(rate * count)));
+        records++;
+    }
+
+    return reader.at_end() ? records : -1;
+}
+
+long u1_3_quotes(const RateTable &rates, FILE *input, FILE *output)
+{
+    InputReader reader(input);
+    OutputBuffer out(output);
+    return u1_3_quotes(rates, reader, out);
+}
+
+/** End of rate_table.cpp */
\ No newline at end of file
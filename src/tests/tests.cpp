@@ -12,12 +12,52 @@
  *       November 13, 2023 (Comment enhancements)
  */
 
+#include "arena.h"
+#include "basket.h"
+#include "batch.h"
+#include "buffered_io.h"
+#include "cohort_stats.h"
+#include "compute.h"
+#include "cross_rates.h"
+#include "currency_code.h"
+#include "daemon.h"
+#include "external_group.h"
+#include "fixed_decimal.h"
+#include "format.h"
 #include "functions.h"
+#include "grade_class.h"
+#include "gradebook.h"
+#include "incremental_gradebook.h"
+#include "packed_grades.h"
+#include "parallel_batch.h"
+#include "pipeline.h"
+#include "ranking.h"
+#include "rate_history.h"
+#include "rate_snapshot.h"
+#include "rate_table.h"
+#include "spsc_ring.h"
+#include "thread_pool.h"
+#include "uring_io.h"
+#include "vat.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
 #include <gtest/gtest.h>
 #include <sstream>
 #include <streambuf>
 #include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 
 /**
  * @class StdinStreamBuffer
@@ -634,6 +674,2664 @@ TEST(U1_3Tests, TestZeroCurrencyRate)
     ASSERT_EQ(expectedOutput, actualOutput);
 }
 
+// Tests for u1_1_batch
+/**
+ * @brief Runs a batch driver over the given input and captures everything it writes.
+ *
+ * @param input The string used as the batch input stream.
+ * @param output A reference to a string where the produced output will be stored.
+ * @param batchToTest Pointer to the batch driver that will be tested.
+ * @return The value returned by the batch driver.
+ */
+long runBatchWithInput(const std::string &input, std::string &output, long (*batchToTest)(FILE *, FILE *))
+{
+    FILE *in = tmpfile();
+    FILE *out = tmpfile();
+    fwrite(input.c_str(), sizeof(char), input.length(), in);
+    rewind(in);
+
+    long result = batchToTest(in, out);
+
+    fflush(out);
+    output.assign((size_t)ftell(out), '\0');
+    rewind(out);
+    if (!output.empty())
+    {
+        size_t read = fread(&output[0], sizeof(char), output.size(), out);
+        output.resize(read);
+    }
+
+    fclose(in);
+    fclose(out);
+    return result;
+}
+
+/**
+ * @brief Tests that the batch mode prints the same receipts as repeated u1_1 calls.
+ */
+TEST(U1_1BatchTests, MatchesSingleRecordOutput)
+{
+    const char *records[] = {"5 100", "1 1", "3 7", "47 31", "101 43", "0 100"};
+    std::string input;
+    std::string expectedOutput;
+    for (const char *record : records)
+    {
+        std::string single;
+        runTestWithInputForFunction(record, single, u1_1);
+        expectedOutput += single;
+        input += std::string(record) + "\n";
+    }
+
+    std::string actualOutput;
+    ASSERT_EQ(6, runBatchWithInput(input, actualOutput, u1_1_batch));
+    ASSERT_EQ(expectedOutput, actualOutput);
+}
+
+/**
+ * @brief Tests the batch mode on input that spans several read buffers.
+ */
+TEST(U1_1BatchTests, LargeInput)
+{
+    std::string input;
+    for (int i = 0; i < 100000; i++)
+    {
+        input += std::to_string(i % 97) + " " + std::to_string(i % 1013) + "\n";
+    }
+
+    std::string actualOutput;
+    ASSERT_EQ(100000, runBatchWithInput(input, actualOutput, u1_1_batch));
+
+    std::string expectedTail;
+    runTestWithInputForFunction(std::to_string(99999 % 97) + " " + std::to_string(99999 % 1013), expectedTail, u1_1);
+    ASSERT_EQ(expectedTail, actualOutput.substr(actualOutput.size() - expectedTail.size()));
+}
+
+/**
+ * @brief Tests the batch mode with empty input and with a malformed record.
+ */
+TEST(U1_1BatchTests, EmptyAndMalformedInput)
+{
+    std::string actualOutput;
+    ASSERT_EQ(0, runBatchWithInput("  \n", actualOutput, u1_1_batch));
+    ASSERT_EQ("", actualOutput);
+
+    ASSERT_EQ(-1, runBatchWithInput("1 100\n2 x\n", actualOutput, u1_1_batch));
+    ASSERT_EQ("Účtenka\nCena bez DPH/ks 100 Kč\tCena s DPH/ks 120 Kč\nPočet kusů: 1\tCena bez DPH 100 Kč\tCena s "
+              "DPH (20 %) 120 Kč\n",
+              actualOutput);
+}
+
+// Tests for the VAT kernels
+/**
+ * @brief Reference implementation of the original double-based VAT rounding from u1_1.
+ */
+int legacyPriceWithVat(int price)
+{
+    const double VAT = 1.2;
+    if (price * VAT - (int)(price * VAT) >= 0.5)
+    {
+        return (int)(price * VAT) + 1;
+    }
+    return (int)(price * VAT);
+}
+
+/**
+ * @brief Tests that the fixed-point kernel matches the double formula on small and border prices.
+ */
+TEST(VatTests, MatchesLegacyRounding)
+{
+    for (int price = -100000; price <= 100000; price++)
+    {
+        ASSERT_EQ(legacyPriceWithVat(price), vat_gross_price(price)) << "price " << price;
+    }
+    const int borders[] = {VAT_MAX_PRICE, -VAT_MAX_PRICE, VAT_MAX_PRICE - 1, 1073741821, 1073741822, -1073741822};
+    for (int price : borders)
+    {
+        ASSERT_EQ(legacyPriceWithVat(price), vat_gross_price(price)) << "price " << price;
+    }
+}
+
+/**
+ * @brief Tests that the scalar and AVX2 array kernels agree with the single-price kernel.
+ */
+TEST(VatTests, ArrayKernelsAgree)
+{
+    std::vector<int> prices;
+    unsigned seed = 12345;
+    for (int i = 0; i < 10003; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        int magnitude = (int)(seed % (i % 50 == 0 ? (unsigned)VAT_MAX_PRICE : 100000u));
+        prices.push_back(i % 3 == 0 ? -magnitude : magnitude);
+    }
+
+    std::vector<int> scalar(prices.size());
+    std::vector<int> vector(prices.size());
+    std::vector<int> dispatched(prices.size());
+    vat_gross_prices_scalar(&prices[0], &scalar[0], prices.size());
+    vat_gross_prices(&prices[0], &dispatched[0], prices.size());
+    if (vat_avx2_available())
+    {
+        vat_gross_prices_avx2(&prices[0], &vector[0], prices.size());
+    }
+    else
+    {
+        vector = scalar;
+    }
+
+    for (size_t i = 0; i < prices.size(); i++)
+    {
+        ASSERT_EQ(legacyPriceWithVat(prices[i]), scalar[i]) << "price " << prices[i];
+        ASSERT_EQ(scalar[i], vector[i]) << "price " << prices[i];
+        ASSERT_EQ(scalar[i], dispatched[i]) << "price " << prices[i];
+    }
+}
+
+/**
+ * @brief Tests the rate classes against exact rational rounding.
+ */
+TEST(VatTests, RateClassesRoundExactly)
+{
+    const int percents[] = {20, 21, 12, 0};
+    for (int percent : percents)
+    {
+        VatRate rate = VAT_RATE_20;
+        ASSERT_TRUE(vat_rate_from_percent(percent, rate));
+        ASSERT_EQ(percent, vat_rate_percent(rate));
+        for (long long price = 0; price <= 200000; price++)
+        {
+            long long exact = (price * (100 + percent) * 2 + 100) / 200; // Half up in integers
+            ASSERT_EQ(exact, vat_gross_price((int)price, rate)) << percent << " % of " << price;
+        }
+    }
+    ASSERT_EQ(61, vat_gross_price(50, VAT_RATE_21)); // 60.5 exactly, not the 60.4999... of 50 * 1.21
+    ASSERT_EQ(vat_rate_max_price(VAT_RATE_20), VAT_MAX_PRICE);
+
+    VatRate rate = VAT_RATE_20;
+    ASSERT_FALSE(vat_rate_from_percent(15, rate));
+}
+
+/**
+ * @brief Tests that the mixed-rate kernels agree with the specialised single-rate kernels.
+ */
+TEST(VatTests, MixedKernelsAgree)
+{
+    std::vector<int> prices;
+    std::vector<unsigned char> rates;
+    unsigned seed = 777;
+    for (int i = 0; i < 5003; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        VatRate rate = (VatRate)((seed >> 16) % VAT_RATE_COUNT);
+        int magnitude = (int)(seed % (i % 40 == 0 ? (unsigned)vat_rate_max_price(rate) : 1000000u));
+        prices.push_back(i % 5 == 0 ? -magnitude : magnitude);
+        rates.push_back((unsigned char)rate);
+    }
+
+    std::vector<int> scalar(prices.size());
+    std::vector<int> vector(prices.size());
+    vat_gross_prices_mixed_scalar(&prices[0], &rates[0], &scalar[0], prices.size());
+    vat_gross_prices_mixed(&prices[0], &rates[0], &vector[0], prices.size());
+    if (vat_avx2_available())
+    {
+        vat_gross_prices_mixed_avx2(&prices[0], &rates[0], &vector[0], prices.size());
+    }
+
+    for (size_t i = 0; i < prices.size(); i++)
+    {
+        int expected = vat_gross_price(prices[i], (VatRate)rates[i]);
+        ASSERT_EQ(expected, scalar[i]) << "price " << prices[i];
+        ASSERT_EQ(expected, vector[i]) << "price " << prices[i];
+
+        std::vector<int> single(1);
+        vat_gross_prices(&prices[i], (VatRate)rates[i], &single[0], 1);
+        ASSERT_EQ(expected, single[0]);
+    }
+}
+
+/**
+ * @brief Tests that every mixed-rate kernel prices an unknown rate class like the default rate.
+ */
+TEST(VatTests, MixedKernelsAgreeOnUnknownClasses)
+{
+    // Bytes that alias valid classes in their low three bits, then ones that do not, then a valid one.
+    const unsigned char unknown[] = {8, 9, 10, 11, 8, 9, 10, 11, 4, 7, 200, 255, 1};
+    const size_t count = sizeof(unknown) / sizeof(unknown[0]);
+    std::vector<int> prices(count, 100);
+    prices[4] = -37;
+    std::vector<int> scalar(count);
+    std::vector<int> vector(count);
+    vat_gross_prices_mixed_scalar(&prices[0], unknown, &scalar[0], count);
+    vat_gross_prices_mixed(&prices[0], unknown, &vector[0], count);
+    ASSERT_EQ(scalar, vector);
+    if (vat_avx2_available())
+    {
+        vat_gross_prices_mixed_avx2(&prices[0], unknown, &vector[0], count);
+        ASSERT_EQ(scalar, vector);
+    }
+    for (size_t i = 0; i + 1 < count; i++)
+    {
+        ASSERT_EQ(vat_gross_price(prices[i]), scalar[i]) << "class " << (int)unknown[i];
+    }
+    ASSERT_EQ(121, scalar[count - 1]);
+}
+
+/**
+ * @brief Tests batch receipts with per-record VAT rates.
+ */
+TEST(U1_1BatchTests, PerRecordRates)
+{
+    std::string actualOutput;
+    ASSERT_EQ(3, runBatchWithInput("2 50 21\n5 100\n1 100 0\n", actualOutput, u1_1_batch));
+    ASSERT_EQ("Účtenka\nCena bez DPH/ks 50 Kč\tCena s DPH/ks 61 Kč\nPočet kusů: 2\tCena bez DPH 100 Kč\tCena s DPH "
+              "(21 %) 122 Kč\n"
+              "Účtenka\nCena bez DPH/ks 100 Kč\tCena s DPH/ks 120 Kč\nPočet kusů: 5\tCena bez DPH 500 Kč\tCena s DPH "
+              "(20 %) 600 Kč\n"
+              "Účtenka\nCena bez DPH/ks 100 Kč\tCena s DPH/ks 100 Kč\nPočet kusů: 1\tCena bez DPH 100 Kč\tCena s DPH "
+              "(0 %) 100 Kč\n",
+              actualOutput);
+
+    ASSERT_EQ(-1, runBatchWithInput("2 50 15\n", actualOutput, u1_1_batch));
+}
+
+// Tests for the arena and basket receipts
+/**
+ * @brief Tests alignment, growth and reuse of the arena.
+ */
+TEST(ArenaTests, AllocateAndReset)
+{
+    Arena arena(256);
+    char *small = arena.allocate_array<char>(3);
+    double *aligned = arena.allocate_array<double>(4);
+    ASSERT_NE(nullptr, small);
+    ASSERT_EQ(0u, (uintptr_t)aligned % alignof(double));
+
+    arena.allocate(1000); // Does not fit into the first block
+    size_t grown = arena.capacity();
+    ASSERT_GT(grown, 256u);
+    ASSERT_GE(arena.used(), 1000u);
+
+    arena.reset();
+    ASSERT_EQ(0u, arena.used());
+    ASSERT_EQ(grown, arena.capacity());
+
+    // After the reset everything fits into the single consolidated block.
+    arena.allocate_array<char>(3);
+    arena.allocate_array<double>(4);
+    arena.allocate(1000);
+    ASSERT_EQ(grown, arena.capacity());
+}
+
+/**
+ * @brief Tests the receipt of a mixed-rate basket.
+ */
+TEST(BasketTests, MixedRateReceipt)
+{
+    Arena arena;
+    Basket basket = basket_allocate(arena, 3);
+    const int counts[] = {2, 1, 3};
+    const int prices[] = {100, 50, 10};
+    const VatRate rates[] = {VAT_RATE_21, VAT_RATE_12, VAT_RATE_21};
+    for (int i = 0; i < 3; i++)
+    {
+        basket.counts[i] = counts[i];
+        basket.prices[i] = prices[i];
+        basket.rates[i] = (unsigned char)rates[i];
+    }
+
+    BasketReceipt receipt;
+    basket_price(basket, arena, receipt);
+
+    std::string expectedOutput = "Účtenka\n"
+                                 "Cena bez DPH/ks 100 Kč\tCena s DPH/ks 121 Kč\n"
+                                 "Počet kusů: 2\tCena bez DPH 200 Kč\tCena s DPH (21 %) 242 Kč\n"
+                                 "Cena bez DPH/ks 50 Kč\tCena s DPH/ks 56 Kč\n"
+                                 "Počet kusů: 1\tCena bez DPH 50 Kč\tCena s DPH (12 %) 56 Kč\n"
+                                 "Cena bez DPH/ks 10 Kč\tCena s DPH/ks 12 Kč\n"
+                                 "Počet kusů: 3\tCena bez DPH 30 Kč\tCena s DPH (21 %) 36 Kč\n"
+                                 "DPH 21 %: Cena bez DPH 230 Kč\tCena s DPH 278 Kč\n"
+                                 "DPH 12 %: Cena bez DPH 50 Kč\tCena s DPH 56 Kč\n"
+                                 "Celkem bez DPH 280 Kč\tCelkem s DPH 334 Kč\n";
+    ASSERT_EQ(expectedOutput, std::string(receipt.text, receipt.length));
+    ASSERT_EQ(280, receipt.total_net);
+    ASSERT_EQ(334, receipt.total_gross);
+    ASSERT_EQ(278, receipt.gross[VAT_RATE_21]);
+    ASSERT_EQ(0, receipt.gross[VAT_RATE_20]);
+}
+
+/**
+ * @brief Tests the basket batch mode, including an empty basket and a malformed one.
+ */
+TEST(BasketTests, BatchMode)
+{
+    std::string actualOutput;
+    ASSERT_EQ(2, runBatchWithInput("1\n5 100\n0\n", actualOutput, u1_1_baskets));
+    ASSERT_EQ("Účtenka\nCena bez DPH/ks 100 Kč\tCena s DPH/ks 120 Kč\nPočet kusů: 5\tCena bez DPH 500 Kč\tCena s DPH "
+              "(20 %) 600 Kč\nDPH 20 %: Cena bez DPH 500 Kč\tCena s DPH 600 Kč\nCelkem bez DPH 500 Kč\tCelkem s DPH "
+              "600 Kč\n"
+              "Účtenka\nCelkem bez DPH 0 Kč\tCelkem s DPH 0 Kč\n",
+              actualOutput);
+
+    ASSERT_EQ(-1, runBatchWithInput("2\n5 100\n", actualOutput, u1_1_baskets));
+}
+
+// Tests for the input layer and the u1_2/u1_3 batch modes
+/**
+ * @brief Tests that the grade batch mode prints the same reports as repeated u1_2 calls.
+ */
+TEST(U1_2BatchTests, MatchesSingleRecordOutput)
+{
+    const char *records[] = {"1 1 1 1 1", "1 2 1 2 1", "5 5 5 5 5", "3 4 4 4 4", "4 4 4 4 5", "0 0 0 0 0"};
+    std::string input;
+    std::string expectedOutput;
+    for (const char *record : records)
+    {
+        std::string single;
+        runTestWithInputForFunction(record, single, u1_2);
+        expectedOutput += single;
+        input += std::string(record) + "\n";
+    }
+
+    std::string actualOutput;
+    ASSERT_EQ(6, runBatchWithInput(input, actualOutput, u1_2_batch));
+    ASSERT_EQ(expectedOutput, actualOutput);
+    ASSERT_EQ(-1, runBatchWithInput("1 2 3\n", actualOutput, u1_2_batch));
+}
+
+/**
+ * @brief Tests that the exchange batch mode prints the same conversions as repeated u1_3 calls.
+ */
+TEST(U1_3BatchTests, MatchesSingleRecordOutput)
+{
+    const char *records[] = {"GBP 24.9 5", "EUR 26.3 3", "USD 21.8 7", "GBP 24.1 4", "JPY 0.2 0",
+                             "JPY 0 5",    "XAU 1e3 2",  "ABC .5 3",   "LONGNAME -2.5 3"};
+    std::string input;
+    std::string expectedOutput;
+    for (const char *record : records)
+    {
+        std::string single;
+        runTestWithInputForFunction(record, single, u1_3);
+        expectedOutput += single;
+        input += std::string(record) + "\n";
+    }
+
+    std::string actualOutput;
+    ASSERT_EQ(9, runBatchWithInput(input, actualOutput, u1_3_batch));
+    ASSERT_EQ(expectedOutput, actualOutput);
+}
+
+/**
+ * @brief Tests that mapped and streamed input parse the same decimals exactly like strtod.
+ */
+TEST(InputReaderTests, DecimalsMatchStrtod)
+{
+    std::string input;
+    std::vector<std::string> tokens;
+    unsigned seed = 99;
+    for (int i = 0; i < 20000; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        std::string token = std::to_string(seed % 100000) + "." + std::to_string((seed >> 8) % 1000);
+        if (i % 7 == 0)
+        {
+            token = "-" + token;
+        }
+        if (i % 101 == 0)
+        {
+            token = "1.5e" + std::to_string(i % 30) + " 12345678901234567890.5 0.000000000000000000000001";
+            // Mantissas that wrap to 0 modulo 2^64, and leading zeros that are not significant.
+            token += " 18446744073709551616 184467440737.09551616 0000000000000000000000012.5";
+        }
+        tokens.push_back(token);
+        input += token + (i % 3 ? " " : "\n");
+    }
+
+    FILE *mapped = tmpfile();
+    fwrite(input.c_str(), 1, input.size(), mapped);
+    rewind(mapped);
+    FILE *streamed = fmemopen(&input[0], input.size(), "r");
+
+    InputReader mappedReader(mapped);
+    InputReader streamedReader(streamed, 4096);
+    ASSERT_TRUE(mappedReader.is_mapped());
+    ASSERT_FALSE(streamedReader.is_mapped());
+
+    std::string all = input;
+    const char *p = all.c_str();
+    char *end = NULL;
+    for (double expected = strtod(p, &end); end != p; p = end, expected = strtod(p, &end))
+    {
+        double fromMapped = 0;
+        double fromStreamed = 0;
+        ASSERT_TRUE(mappedReader.next_double(fromMapped));
+        ASSERT_TRUE(streamedReader.next_double(fromStreamed));
+        ASSERT_EQ(expected, fromMapped);
+        ASSERT_EQ(expected, fromStreamed);
+    }
+    ASSERT_TRUE(mappedReader.at_end());
+    ASSERT_TRUE(streamedReader.at_end());
+
+    fclose(mapped);
+    fclose(streamed);
+}
+
+/**
+ * @brief Tests words and integers from a streamed input with a tiny buffer.
+ */
+TEST(InputReaderTests, WordsAndIntegersAcrossRefills)
+{
+    std::string input;
+    for (int i = 0; i < 1000; i++)
+    {
+        input += "CUR" + std::to_string(i) + " " + std::to_string(i - 500) + "\n";
+    }
+    FILE *streamed = fmemopen(&input[0], input.size(), "r");
+    InputReader reader(streamed, 64);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        const char *word = NULL;
+        size_t length = 0;
+        int value = 0;
+        ASSERT_TRUE(reader.next_word(word, length));
+        ASSERT_EQ("CUR" + std::to_string(i), std::string(word, length));
+        ASSERT_TRUE(reader.next_int(value));
+        ASSERT_EQ(i - 500, value);
+    }
+    ASSERT_TRUE(reader.at_end());
+    fclose(streamed);
+}
+
+/**
+ * @brief Tests that the pool runs every task, including tasks submitted from within tasks.
+ */
+TEST(ThreadPoolTests, RunsEveryTask)
+{
+    std::atomic<int> counter(0);
+    {
+        ThreadPool pool(4);
+        ASSERT_EQ(4u, pool.size());
+        for (int i = 0; i < 1000; i++)
+        {
+            pool.submit([&pool, &counter] {
+                counter++;
+                pool.submit([&counter] { counter++; });
+            });
+        }
+    }
+    ASSERT_EQ(2000, counter.load());
+}
+
+/**
+ * @brief Runs a batch kernel through the parallel driver over an in-memory stream.
+ *
+ * @param input The string used as the batch input stream.
+ * @param output A reference to a string where the produced output will be stored.
+ * @param kernel Batch kernel to run.
+ * @param mapped Whether the input is given as a mappable file instead of a stream.
+ * @return The value returned by the parallel driver.
+ */
+long runParallelBatchWithInput(const std::string &input, std::string &output, BatchKernel kernel, bool mapped)
+{
+    std::string copy = input;
+    FILE *in = mapped ? tmpfile() : fmemopen(&copy[0], copy.size(), "r");
+    if (mapped)
+    {
+        fwrite(input.c_str(), sizeof(char), input.length(), in);
+        rewind(in);
+    }
+    char *buffer = NULL;
+    size_t size = 0;
+    FILE *out = open_memstream(&buffer, &size);
+
+    long result = batch_parallel(kernel, in, out, 3, 1000);
+
+    fclose(out);
+    output.assign(buffer, size);
+    free(buffer);
+    fclose(in);
+    return result;
+}
+
+/**
+ * @brief Tests that the parallel driver reproduces the sequential output in input order.
+ */
+TEST(ParallelBatchTests, MatchesSequentialOutput)
+{
+    std::string receipts;
+    std::string grades;
+    std::string exchange;
+    unsigned seed = 3;
+    for (int i = 0; i < 5000; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        receipts += std::to_string(seed % 100) + " " + std::to_string((seed >> 8) % 100000) +
+                    (i % 3 ? "\n" : " 12\n");
+        grades += std::to_string(1 + seed % 5) + " 2 3 " + std::to_string(1 + (seed >> 4) % 5) + " 1\n";
+        exchange += "EUR " + std::to_string(20 + seed % 10) + ".5 " + std::to_string((seed >> 8) % 1000) + "\n";
+    }
+
+    const struct
+    {
+        const std::string &input;
+        long (*batch)(FILE *, FILE *);
+        BatchKernel kernel;
+    } cases[] = {
+        {receipts, u1_1_batch, u1_1_receipts},
+        {grades, u1_2_batch, u1_2_reports},
+        {exchange, u1_3_batch, u1_3_conversions},
+    };
+    for (const auto &test : cases)
+    {
+        std::string expectedOutput;
+        ASSERT_EQ(5000, runBatchWithInput(test.input, expectedOutput, test.batch));
+        for (bool mapped : {true, false})
+        {
+            std::string actualOutput;
+            ASSERT_EQ(5000, runParallelBatchWithInput(test.input, actualOutput, test.kernel, mapped));
+            ASSERT_EQ(expectedOutput, actualOutput);
+        }
+    }
+}
+
+/**
+ * @brief Tests that the parallel driver stops after the chunk with a malformed record.
+ */
+TEST(ParallelBatchTests, StopsAtMalformedRecord)
+{
+    std::string input;
+    for (int i = 0; i < 2000; i++)
+    {
+        input += i == 1500 ? "7 x\n" : std::to_string(i) + " 100\n";
+    }
+
+    std::string expectedOutput;
+    ASSERT_EQ(-1, runBatchWithInput(input, expectedOutput, u1_1_batch));
+    for (bool mapped : {true, false})
+    {
+        std::string actualOutput;
+        ASSERT_EQ(-1, runParallelBatchWithInput(input, actualOutput, u1_1_receipts, mapped));
+        ASSERT_EQ(expectedOutput, actualOutput);
+    }
+}
+
+/**
+ * @brief Tests integer formatting against printf, including the extremes.
+ */
+TEST(FormatTests, IntegersMatchPrintf)
+{
+    std::vector<long long> values = {0, 1, -1, 9, 10, 99, 100, 999, 1000, 9999, 10000, 2147483647, -2147483647 - 1,
+                                     9223372036854775807LL, -9223372036854775807LL - 1};
+    unsigned seed = 5;
+    for (int i = 0; i < 10000; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        values.push_back((long long)seed * (seed >> 3) * (i % 2 ? 1 : -1) >> (seed % 40));
+    }
+    for (long long value : values)
+    {
+        char expected[32];
+        char actual[32];
+        snprintf(expected, sizeof(expected), "%lld", value);
+        *format_long(actual, value) = '\0';
+        ASSERT_STREQ(expected, actual);
+    }
+}
+
+/**
+ * @brief Tests one- and two-decimal formatting against printf, including exact and near ties.
+ */
+TEST(FormatTests, FixedMatchesPrintf)
+{
+    std::vector<double> values = {0.0,    -0.0,    0.05,   0.15,  0.25,     0.125,     0.375, 2.675, 1.005, -0.04,
+                                  -0.005, 1e15,    4.5e14, 9e15,  1e300,    -1e300,    1e-300, HUGE_VAL,
+                                  -HUGE_VAL, NAN,  21.45,  1.85,  123.4550, 0.9999999, 99.995};
+    unsigned seed = 11;
+    for (int i = 0; i < 200000; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        double value = (double)(seed % 2000000) / (i % 2 ? 1000 : 40) - 10000;
+        values.push_back(value);
+        values.push_back(nextafter(value, 0));
+        values.push_back(value * 3 / 7);
+    }
+    for (double value : values)
+    {
+        for (int decimals = 1; decimals <= 2; decimals++)
+        {
+            char expected[FORMAT_FIXED_MAX_LENGTH];
+            char actual[FORMAT_FIXED_MAX_LENGTH];
+            snprintf(expected, sizeof(expected), decimals == 1 ? "%.1f" : "%.2f", value);
+            *format_fixed(actual, value, decimals) = '\0';
+            ASSERT_STREQ(expected, actual) << value;
+        }
+    }
+}
+
+/**
+ * @brief Tests that the task formatters produce the same bytes as the former printf calls.
+ */
+TEST(FormatTests, TaskOutputMatchesPrintf)
+{
+    char expected[1024];
+    char actual[1024];
+
+    snprintf(expected, sizeof(expected),
+             "Účtenka\nCena bez DPH/ks %d Kč\tCena s DPH/ks %d Kč\nPočet kusů: %d\tCena bez DPH %d Kč\tCena s DPH "
+             "(%d %%) %d Kč\n",
+             -7, 2147483646, 1, -7, 12, 2147483646);
+    *format_u1_1_receipt(actual, 1, -7, 2147483646, 12) = '\0';
+    ASSERT_STREQ(expected, actual);
+
+    const int grades[5] = {1, 2, 1, 1, 2};
+    GradeStatus status = grade_status(1.4);
+    snprintf(expected, sizeof(expected),
+             "Známky: 1\t2\t1\t1\t2\n%.2f\nProspěl s vyznamenáním: 1:Ano\nProspěl: 1:Ano\nNeprospěl: 0:Ne\n", 1.4);
+    *format_u1_2_report(actual, grades, 1.4, status) = '\0';
+    ASSERT_STREQ(expected, actual);
+
+    snprintf(expected, sizeof(expected),
+             "1 %s = %.1f Kč\nNákup: %d %s\nCelkem: %d x %.1f = %.1f Kč Zaokrouhleno: %d Kč\n", "GBP", 28.65, -3, "GBP",
+             -3, 28.65, -3 * 28.65, round_half_up(-3 * 28.65));
+    *format_u1_3_conversion(actual, "GBP!", 3, 28.65, -3, round_half_up(-3 * 28.65)) = '\0';
+    ASSERT_STREQ(expected, actual);
+}
+
+/**
+ * @brief Tests that receipt items and receipts with every field at its longest fit their length bounds.
+ */
+TEST(FormatTests, ItemsStayWithinTheirBound)
+{
+    // Every field at its longest, so an arena or buffer sized by the bound is never overrun.
+    char item[2 * FORMAT_ITEM_MAX_LENGTH];
+    char *end = format_receipt_item(item, INT_MIN, INT_MIN, INT_MIN, LLONG_MIN, LLONG_MIN, INT_MIN);
+    size_t length = (size_t)(end - item);
+    ASSERT_EQ(178u, length);
+    ASSERT_LE(length, FORMAT_ITEM_MAX_LENGTH);
+
+    char receipt[2 * FORMAT_RECEIPT_MAX_LENGTH];
+    length = (size_t)(format_u1_1_receipt(receipt, 1, INT_MIN, INT_MIN, INT_MIN) - receipt);
+    ASSERT_LE(length, FORMAT_RECEIPT_MAX_LENGTH);
+}
+
+/**
+ * @brief Tests the vector sums against the scalar reference for rows of many lengths.
+ */
+TEST(GradebookTests, SumsMatchScalar)
+{
+    Gradebook book;
+    unsigned seed = 17;
+    for (int i = 0; i < 5000; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        size_t count = (seed >> 4) % 40;
+        for (size_t j = 0; j < count; j++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            book.grades.push_back((unsigned char)(seed >> 16));
+        }
+        book.offsets.push_back(book.grades.size());
+    }
+
+    std::vector<int> expected(gradebook_students(book));
+    std::vector<int> actual(gradebook_students(book));
+    gradebook_sums_scalar(book, expected.data());
+    gradebook_sums(book, actual.data());
+    ASSERT_EQ(expected, actual);
+
+    std::vector<int> counts(gradebook_students(book));
+    std::vector<double> averages(gradebook_students(book));
+    gradebook_counts(book, counts.data());
+    gradebook_averages(actual.data(), counts.data(), averages.data(), averages.size());
+    for (size_t i = 0; i < averages.size(); i++)
+    {
+        size_t count = book.offsets[i + 1] - book.offsets[i];
+        ASSERT_EQ(count, (size_t)counts[i]);
+        ASSERT_EQ(count ? (double)expected[i] / count : 0, averages[i]);
+    }
+}
+
+/**
+ * @brief Tests that five-grade students get the same reports as from u1_2.
+ */
+TEST(GradebookTests, MatchesU1_2Reports)
+{
+    std::string input;
+    std::string expectedOutput;
+    for (int i = 0; i < 3125; i++)
+    {
+        std::string record;
+        for (int j = 0, code = i; j < 5; j++, code /= 5)
+        {
+            record += std::to_string(1 + code % 5) + (j < 4 ? " " : "");
+        }
+        std::string single;
+        runTestWithInputForFunction(record, single, u1_2);
+        expectedOutput += single;
+        input += record + "\n";
+    }
+
+    std::string actualOutput;
+    ASSERT_EQ(3125, runBatchWithInput(input, actualOutput, u1_2_gradebook));
+    ASSERT_EQ(expectedOutput, actualOutput);
+}
+
+/**
+ * @brief Tests students with different numbers of grades and malformed records.
+ */
+TEST(GradebookTests, VariableGradeCounts)
+{
+    std::string expectedOutput = "Známky: 1\t2\t1\n1.33\nProspěl s vyznamenáním: 1:Ano\nProspěl: 1:Ano\nNeprospěl: 0:Ne\n"
+                                 "Známky: 5\t5\t4\t5\t5\t4\t5\t5\t4\t5\t5\t4\n4.67\nProspěl s vyznamenáním: 0:Ne\n"
+                                 "Prospěl: 0:Ne\nNeprospěl: 1:Ano\n";
+    std::string actualOutput;
+    ASSERT_EQ(2, runBatchWithInput("1 2 1\n5 5 4 5 5 4 5 5 4 5 5 4\n", actualOutput, u1_2_gradebook));
+    ASSERT_EQ(expectedOutput, actualOutput);
+
+    ASSERT_EQ(-1, runBatchWithInput("1 2 1\n3 x\n", actualOutput, u1_2_gradebook));
+    ASSERT_EQ(-1, runBatchWithInput("1 2 256\n", actualOutput, u1_2_gradebook));
+    ASSERT_EQ(0, runBatchWithInput("", actualOutput, u1_2_gradebook));
+}
+
+/**
+ * @brief Tests that a bad token in the middle of a line rejects the whole student.
+ */
+TEST(GradebookTests, RejectsLineWithBadToken)
+{
+    std::string expectedOutput;
+    ASSERT_EQ(1, runBatchWithInput("1 2 1\n", expectedOutput, u1_2_gradebook));
+    std::string actualOutput;
+    ASSERT_EQ(-1, runBatchWithInput("1 2 1\n1 2 x 3\n4 4\n", actualOutput, u1_2_gradebook));
+    ASSERT_EQ(expectedOutput, actualOutput);
+
+    Gradebook book;
+    InputReader reader("5 5\n1 2 x 3\n", 12);
+    ASSERT_FALSE(gradebook_read(reader, book, 10));
+    ASSERT_EQ(1u, gradebook_students(book));
+    ASSERT_EQ(2u, book.grades.size());
+}
+
+/**
+ * @brief Tests that the integer classification agrees with grade_status() for every sum near the borders.
+ */
+TEST(GradeClassTests, MatchesGradeStatus)
+{
+    for (int count = 1; count <= 64; count++)
+    {
+        GradeThresholds thresholds = grade_thresholds(count);
+        for (int sum = -count; sum <= 6 * count; sum++)
+        {
+            GradeStatus expected = grade_status((double)sum / count);
+            unsigned char grade_class = classify_grade_sum(sum, thresholds);
+            GradeStatus actual = grade_status_from_class(grade_class);
+            ASSERT_EQ(expected.distinction, actual.distinction) << sum << "/" << count;
+            ASSERT_EQ(expected.passed, actual.passed) << sum << "/" << count;
+            ASSERT_EQ(expected.failed, actual.failed) << sum << "/" << count;
+            ASSERT_EQ(!expected.passed && !expected.failed, (grade_class & GRADE_INVALID) != 0);
+        }
+    }
+
+    // The borders of U1_2Tests.JustPassed (4 4 4 4 4) and U1_2Tests.JustFailed (4 4 4 4 5).
+    ASSERT_EQ(GRADE_PASSED, classify_grade_sum(20, U1_2_THRESHOLDS));
+    ASSERT_EQ(GRADE_FAILED, classify_grade_sum(21, U1_2_THRESHOLDS));
+    ASSERT_EQ(GRADE_DISTINCTION | GRADE_PASSED, classify_grade_sum(7, U1_2_THRESHOLDS));
+    ASSERT_EQ(GRADE_PASSED, classify_grade_sum(8, U1_2_THRESHOLDS));
+    ASSERT_EQ(GRADE_INVALID, classify_grade_sum(0, grade_thresholds(0)));
+}
+
+/**
+ * @brief Tests that the array kernels agree with the single-sum classification.
+ */
+TEST(GradeClassTests, ArrayKernelsAgree)
+{
+    const size_t students = 10007;
+    std::vector<int> sums(students);
+    std::vector<int> counts(students);
+    unsigned seed = 23;
+    for (size_t i = 0; i < students; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        counts[i] = (int)((seed >> 8) % 14);
+        sums[i] = (int)((seed >> 16) % (6 * counts[i] + 3)) - 1;
+    }
+
+    std::vector<unsigned char> expected(students);
+    std::vector<unsigned char> scalar(students);
+    std::vector<unsigned char> dispatched(students);
+    std::vector<unsigned char> fixed(students);
+    for (size_t i = 0; i < students; i++)
+    {
+        expected[i] = classify_grade_sum(sums[i], grade_thresholds(counts[i]));
+    }
+    classify_grade_sums_scalar(sums.data(), counts.data(), scalar.data(), students);
+    classify_grade_sums(sums.data(), counts.data(), dispatched.data(), students);
+    ASSERT_EQ(expected, scalar);
+    ASSERT_EQ(expected, dispatched);
+    if (__builtin_cpu_supports("avx2"))
+    {
+        std::vector<unsigned char> avx2(students);
+        classify_grade_sums_avx2(sums.data(), counts.data(), avx2.data(), students);
+        ASSERT_EQ(expected, avx2);
+    }
+
+    classify_grade_sums(sums.data(), 5, fixed.data(), students);
+    for (size_t i = 0; i < students; i++)
+    {
+        ASSERT_EQ(classify_grade_sum(sums[i], U1_2_THRESHOLDS), fixed[i]);
+    }
+}
+
+/**
+ * @brief Tests the summary of a small cohort against hand-computed values.
+ */
+TEST(CohortStatsTests, SummaryOfSmallCohort)
+{
+    std::string input = "1 1 2\n4 4 4 4 4\n4 4 4 4 5\n3\n9 9\n2 2 2 2\n";
+    std::string expectedOutput = "Studentů: 6\nPrůměr: 2.91\n"
+                                 "Prospěl s vyznamenáním: 1 (16.67 %)\nProspěl: 4 (66.67 %)\n"
+                                 "Neprospěl: 1 (16.67 %)\nNeplatný průměr: 1 (16.67 %)\n"
+                                 "Percentil 50: 3.00\nPercentil 90: 4.20\nPercentil 99: 4.20\nHistogram:\n"
+                                 "1.00-1.49: 1\n1.50-1.99: 0\n2.00-2.49: 1\n2.50-2.99: 0\n3.00-3.49: 1\n"
+                                 "3.50-3.99: 0\n4.00-4.49: 2\n4.50-5.00: 0\n";
+    std::string actualOutput;
+    ASSERT_EQ(6, runBatchWithInput(input, actualOutput, u1_2_statistics));
+    ASSERT_EQ(expectedOutput, actualOutput);
+}
+
+/**
+ * @brief Tests that merged partial statistics equal statistics over the whole cohort.
+ */
+TEST(CohortStatsTests, MergeMatchesSingleAccumulator)
+{
+    CohortStats whole;
+    CohortStats first;
+    CohortStats second;
+    unsigned seed = 31;
+    for (int i = 0; i < 10000; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        int count = 1 + (int)((seed >> 8) % 12);
+        int sum = count + (int)((seed >> 16) % (4 * count + 1));
+        unsigned char grade_class = classify_grade_sum(sum, grade_thresholds(count));
+        whole.add(sum, count, grade_class);
+        (i % 3 ? first : second).add(sum, count, grade_class);
+    }
+    first.merge(second);
+
+    char expected[COHORT_STATS_MAX_LENGTH];
+    char actual[COHORT_STATS_MAX_LENGTH];
+    *whole.format(expected) = '\0';
+    *first.format(actual) = '\0';
+    ASSERT_STREQ(expected, actual);
+    ASSERT_EQ(10000, first.students());
+    ASSERT_EQ(whole.count(GRADE_FAILED), first.count(GRADE_FAILED));
+    ASSERT_LE(whole.percentile(0.5), whole.percentile(0.9));
+}
+
+/**
+ * @brief Tests that an average on a tie goes into the bucket of its printed text.
+ */
+TEST(CohortStatsTests, BucketsFollowPrintedRounding)
+{
+    const int sums[] = {9, 11, 13, 15};
+    for (size_t i = 0; i < sizeof(sums) / sizeof(sums[0]); i++)
+    {
+        CohortStats stats;
+        stats.add(sums[i], 8, classify_grade_sum(sums[i], grade_thresholds(8)));
+
+        char printed[FORMAT_FIXED_MAX_LENGTH];
+        char bucket[FORMAT_FIXED_MAX_LENGTH];
+        *format_fixed(printed, sums[i] / 8.0, 2) = '\0';
+        *format_fixed(bucket, stats.percentile(0.5), 2) = '\0';
+        ASSERT_STREQ(printed, bucket);
+    }
+    ASSERT_EQ(112u, round_fixed(1.125, 2));
+    ASSERT_EQ(138u, round_fixed(-1.375, 2));
+}
+
+/**
+ * @brief Tests that running summaries are printed after every interval and once at the end.
+ */
+TEST(CohortStatsTests, PeriodicSummaries)
+{
+    std::string input;
+    for (int i = 0; i < 10000; i++)
+    {
+        input += std::to_string(1 + i % 5) + " " + std::to_string(1 + i % 3) + "\n";
+    }
+
+    const struct
+    {
+        long interval;
+        int summaries;
+    } cases[] = {{0, 1}, {2500, 4}, {3000, 4}, {10000, 1}, {20000, 1}};
+    for (const auto &test : cases)
+    {
+        FILE *in = fmemopen(&input[0], input.size(), "r");
+        char *buffer = NULL;
+        size_t size = 0;
+        FILE *out = open_memstream(&buffer, &size);
+        ASSERT_EQ(10000, u1_2_statistics(in, out, test.interval));
+        fclose(out);
+        std::string output(buffer, size);
+        free(buffer);
+        fclose(in);
+
+        int summaries = 0;
+        for (size_t at = output.find("Studentů: "); at != std::string::npos; at = output.find("Studentů: ", at + 1))
+        {
+            summaries++;
+        }
+        ASSERT_EQ(test.summaries, summaries) << test.interval;
+        ASSERT_NE(std::string::npos, output.rfind("Studentů: 10000\n"));
+    }
+}
+
+/**
+ * @brief Tests that edits update the totals and report only changed results.
+ */
+TEST(IncrementalGradebookTests, EditsReportChangedResults)
+{
+    std::string input = "insert 7 1\ninsert 7 2\ninsert 9 4\nupdate 7 2 2\ninsert 9 4\nupdate 9 4 5\n"
+                        "delete 7 3\ninsert 7 6\ndelete 9 4\ndelete 9 5\n";
+    std::string expectedOutput =
+        "Student 7: 1.00\tProspěl s vyznamenáním: 1:Ano\tProspěl: 1:Ano\tNeprospěl: 0:Ne\n"
+        "Student 7: 1.50\tProspěl s vyznamenáním: 1:Ano\tProspěl: 1:Ano\tNeprospěl: 0:Ne\n"
+        "Student 9: 4.00\tProspěl s vyznamenáním: 0:Ne\tProspěl: 1:Ano\tNeprospěl: 0:Ne\n"
+        "Student 9: 4.50\tProspěl s vyznamenáním: 0:Ne\tProspěl: 0:Ne\tNeprospěl: 1:Ano\n"
+        "Student 7: neplatná oprava\nStudent 7: neplatná oprava\n"
+        "Student 9: 5.00\tProspěl s vyznamenáním: 0:Ne\tProspěl: 0:Ne\tNeprospěl: 1:Ano\n"
+        "Student 9: 0.00\tProspěl s vyznamenáním: 0:Ne\tProspěl: 0:Ne\tNeprospěl: 0:Ne\n";
+    std::string actualOutput;
+    ASSERT_EQ(10, runBatchWithInput(input, actualOutput, u1_2_edits));
+    ASSERT_EQ(expectedOutput, actualOutput);
+
+    ASSERT_EQ(-1, runBatchWithInput("insert 1 2\nrename 1 2\n", actualOutput, u1_2_edits));
+}
+
+/**
+ * @brief Tests deleting the only grade of a student, which removes the student.
+ */
+TEST(IncrementalGradebookTests, DeletingOnlyGradeRemovesStudent)
+{
+    IncrementalGradebook book;
+    ASSERT_EQ(EDIT_CHANGED, book.insert(3, 2));
+    ASSERT_EQ(EDIT_CHANGED, book.insert(4, 1));
+    ASSERT_EQ(EDIT_CHANGED, book.remove(3, 2));
+    ASSERT_EQ(NULL, book.find(3));
+    ASSERT_EQ(1u, book.students());
+    ASSERT_EQ(EDIT_REJECTED, book.remove(3, 2));
+
+    ASSERT_EQ(EDIT_CHANGED, book.insert(3, 5));
+    ASSERT_EQ(5, book.find(3)->sum);
+}
+
+/**
+ * @brief Tests edits against a book loaded from a text and from a packed gradebook file.
+ */
+TEST(IncrementalGradebookTests, EditsApplyToLoadedBook)
+{
+    std::string text;
+    for (int student = 1; student <= 5000; student++)
+    {
+        text += student == 2 ? "4 4 5\n"
+                             : std::to_string(1 + student % 5) + " " + std::to_string(1 + student % 3) + "\n";
+    }
+    FILE *in = fmemopen(&text[0], text.size(), "r");
+    IncrementalGradebook book;
+    ASSERT_TRUE(book.load(in));
+    fclose(in);
+    ASSERT_EQ(5000u, book.students());
+    ASSERT_EQ(13, book.find(2)->sum);
+    ASSERT_EQ(1 + 5000 % 5 + 1 + 5000 % 3, book.find(5000)->sum);
+
+    FILE *packed = tmpfile();
+    in = fmemopen(&text[0], text.size(), "r");
+    ASSERT_EQ(5000, u1_2_pack(in, packed));
+    fclose(in);
+    rewind(packed);
+    IncrementalGradebook unpacked;
+    ASSERT_TRUE(unpacked.load_packed(packed));
+    fclose(packed);
+    ASSERT_EQ(book.students(), unpacked.students());
+    for (int id = 1; id <= 5000; id++)
+    {
+        ASSERT_EQ(book.find(id)->sum, unpacked.find(id)->sum);
+        ASSERT_EQ(book.find(id)->grade_class, unpacked.find(id)->grade_class);
+    }
+
+    std::string edits = "update 2 5 4\n";
+    FILE *edit_input = fmemopen(&edits[0], edits.size(), "r");
+    char *result = NULL;
+    size_t result_size = 0;
+    FILE *output = open_memstream(&result, &result_size);
+    ASSERT_EQ(1, u1_2_edits(book, edit_input, output));
+    fclose(edit_input);
+    fclose(output);
+    ASSERT_EQ("Student 2: 4.00\tProspěl s vyznamenáním: 0:Ne\tProspěl: 1:Ano\tNeprospěl: 0:Ne\n", std::string(result));
+    free(result);
+
+    std::string bad = "1 2\n1 7\n";
+    in = fmemopen(&bad[0], bad.size(), "r");
+    ASSERT_FALSE(book.load(in));
+    fclose(in);
+    ASSERT_EQ(0u, book.students());
+}
+
+/**
+ * @brief Tests the running totals against a full recomputation after random edits.
+ */
+TEST(IncrementalGradebookTests, TotalsMatchRecomputation)
+{
+    IncrementalGradebook book(100);
+    std::vector<std::vector<int>> grades(100);
+    unsigned seed = 41;
+    for (int i = 0; i < 20000; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        int id = (int)((seed >> 8) % 100);
+        int grade = 1 + (int)((seed >> 16) % 5);
+        std::vector<int> &own = grades[id];
+        if (seed % 3 == 0 && !own.empty())
+        {
+            int old_grade = own[(seed >> 4) % own.size()];
+            ASSERT_NE(EDIT_REJECTED, book.update(id, old_grade, grade));
+            own.erase(std::find(own.begin(), own.end(), old_grade));
+            own.push_back(grade);
+        }
+        else if (seed % 3 == 1 && !own.empty())
+        {
+            int old_grade = own[(seed >> 4) % own.size()];
+            ASSERT_NE(EDIT_REJECTED, book.remove(id, old_grade));
+            own.erase(std::find(own.begin(), own.end(), old_grade));
+        }
+        else
+        {
+            ASSERT_NE(EDIT_REJECTED, book.insert(id, grade));
+            own.push_back(grade);
+        }
+
+        const StudentTotals *totals = book.find(id);
+        if (own.empty())
+        {
+            ASSERT_TRUE(totals == NULL);
+            continue;
+        }
+        int sum = 0;
+        for (int g : own)
+        {
+            sum += g;
+        }
+        ASSERT_EQ(sum, totals->sum);
+        ASSERT_EQ((int)own.size(), totals->count);
+        GradeStatus expected = grade_status((double)sum / own.size());
+        GradeStatus actual = grade_status_from_class(totals->grade_class);
+        ASSERT_EQ(expected.distinction, actual.distinction);
+        ASSERT_EQ(expected.passed, actual.passed);
+        ASSERT_EQ(expected.failed, actual.failed);
+    }
+    ASSERT_EQ(EDIT_REJECTED, book.insert(1, 0));
+    ASSERT_EQ(EDIT_REJECTED, book.remove(1000, 3));
+}
+
+/**
+ * @brief Tests that a packed gradebook gives the same sums and reports as the text it came from.
+ */
+TEST(PackedGradesTests, RoundTripMatchesGradebook)
+{
+    std::string input;
+    unsigned seed = 43;
+    for (int i = 0; i < 3000; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        int count = 1 + (int)((seed >> 8) % 45);
+        for (int j = 0; j < count; j++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            input += std::to_string((seed >> 16) % 8) + (j + 1 < count ? " " : "\n");
+        }
+    }
+
+    std::string packed;
+    ASSERT_EQ(3000, runBatchWithInput(input, packed, u1_2_pack));
+    std::string expectedOutput;
+    std::string actualOutput;
+    ASSERT_EQ(3000, runBatchWithInput(input, expectedOutput, u1_2_gradebook));
+    ASSERT_EQ(3000, runBatchWithInput(packed, actualOutput, u1_2_packed));
+    ASSERT_EQ(expectedOutput, actualOutput);
+
+    FILE *in = tmpfile();
+    fwrite(packed.data(), 1, packed.size(), in);
+    rewind(in);
+    PackedGradebook book;
+    ASSERT_TRUE(book.open(in));
+    fclose(in);
+
+    FILE *text = fmemopen(&input[0], input.size(), "r");
+    InputReader reader(text);
+    Gradebook columns;
+    ASSERT_TRUE(gradebook_read(reader, columns, 3000));
+    fclose(text);
+    std::vector<int> expected(3000);
+    std::vector<int> sums(3000);
+    std::vector<int> counts(3000);
+    gradebook_sums_scalar(columns, expected.data());
+    book.sums(0, 3000, sums.data(), counts.data());
+    ASSERT_EQ(expected, sums);
+    for (size_t first : {1u, 63u, 64u, 65u, 2999u})
+    {
+        book.sums(first, 1, sums.data(), counts.data());
+        ASSERT_EQ(expected[first], sums[0]);
+        ASSERT_EQ((uint64_t)columns.offsets[first], book.offset(first));
+    }
+}
+
+/**
+ * @brief Tests that students the format cannot hold and damaged files are rejected.
+ */
+TEST(PackedGradesTests, RejectsInvalidInput)
+{
+    std::string output;
+    ASSERT_EQ(-1, runBatchWithInput("1 2 8\n", output, u1_2_pack));
+    ASSERT_TRUE(output.empty());
+    std::string tooMany;
+    for (int i = 0; i < 256; i++)
+    {
+        tooMany += "3 ";
+    }
+    ASSERT_EQ(-1, runBatchWithInput(tooMany + "\n", output, u1_2_pack));
+
+    std::string packed;
+    ASSERT_EQ(2, runBatchWithInput("1 2 3\n4 5\n", packed, u1_2_pack));
+    ASSERT_EQ(2, runBatchWithInput(packed, output, u1_2_packed));
+    ASSERT_EQ(-1, runBatchWithInput(packed.substr(0, packed.size() - 1), output, u1_2_packed));
+    std::string damaged = packed;
+    damaged[0] = 'X';
+    ASSERT_EQ(-1, runBatchWithInput(damaged, output, u1_2_packed));
+    damaged = packed;
+    damaged[damaged.size() - 8]++; // The first count.
+    ASSERT_EQ(-1, runBatchWithInput(damaged, output, u1_2_packed));
+}
+
+// Tests for the out-of-core grouping by student
+/**
+ * @brief Tests that events are grouped into one gradebook report per student, in student order.
+ */
+TEST(ExternalGroupTests, GroupsEventsByStudent)
+{
+    std::string input = "7 MAT 2\n3 FYZ 1\n7 CJA 5\n3 MAT 1\n7 MAT 1\n";
+    std::string expectedOutput;
+    std::string report;
+    ASSERT_EQ(1, runBatchWithInput("1 1\n", report, u1_2_gradebook));
+    expectedOutput += "Student 3\n" + report;
+    ASSERT_EQ(1, runBatchWithInput("2 5 1\n", report, u1_2_gradebook));
+    expectedOutput += "Student 7\n" + report;
+
+    std::string actualOutput;
+    ASSERT_EQ(2, runBatchWithInput(input, actualOutput, u1_2_group));
+    ASSERT_EQ(expectedOutput, actualOutput);
+}
+
+/**
+ * @brief Tests that grouping through spilled runs and several merge passes matches grouping in memory.
+ */
+TEST(ExternalGroupTests, SpilledRunsMatchInMemoryGrouping)
+{
+    // Three inputs of 40000 events each; at the smallest memory limit this needs many runs and
+    // more than one merge pass.
+    std::string inputs[3];
+    unsigned seed = 47;
+    for (int i = 0; i < 120000; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        int student = (int)((seed >> 8) % 5000) - 100;
+        seed = seed * 1103515245u + 12345u;
+        inputs[i % 3] += std::to_string(student) + " P" + std::to_string(i % 7) + " " +
+                         std::to_string(1 + (seed >> 16) % 5) + "\n";
+    }
+
+    std::string results[2];
+    const size_t limits[2] = {GROUP_DEFAULT_MEMORY, 0};
+    for (int r = 0; r < 2; r++)
+    {
+        FILE *files[3];
+        for (int f = 0; f < 3; f++)
+        {
+            files[f] = tmpfile();
+            fwrite(inputs[f].data(), 1, inputs[f].size(), files[f]);
+            rewind(files[f]);
+        }
+        FILE *out = tmpfile();
+        ASSERT_EQ(5000, u1_2_group(files, 3, out, limits[r]));
+        long size = ftell(out);
+        rewind(out);
+        results[r].resize((size_t)size);
+        ASSERT_EQ((size_t)size, fread(&results[r][0], 1, (size_t)size, out));
+        for (int f = 0; f < 3; f++)
+        {
+            fclose(files[f]);
+        }
+        fclose(out);
+    }
+    ASSERT_EQ(0u, results[0].find("Student -100\n"));
+    ASSERT_EQ(results[0], results[1]);
+}
+
+/**
+ * @brief Tests that spilling about a hundred runs needs only a few file descriptors.
+ */
+TEST(ExternalGroupTests, SpillingKeepsFewFilesOpen)
+{
+    // About a hundred runs at the smallest memory limit, and one student with a third of all grades.
+    std::string input;
+    unsigned seed = 53;
+    for (int i = 0; i < 240000; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        int student = i % 3 == 0 ? 42 : (int)((seed >> 8) % 1000);
+        input += std::to_string(student) + " P " + std::to_string(1 + (seed >> 20) % 5) + "\n";
+    }
+    std::string expectedOutput;
+    ASSERT_EQ(1000, runBatchWithInput(input, expectedOutput, u1_2_group));
+
+    // Descriptors at or above the soft limit cannot be opened, so leave room for a few only.
+    int highest = 0;
+    DIR *descriptors = opendir("/proc/self/fd");
+    ASSERT_TRUE(descriptors != NULL);
+    while (struct dirent *entry = readdir(descriptors))
+    {
+        highest = std::max(highest, atoi(entry->d_name));
+    }
+    closedir(descriptors);
+    FILE *in = tmpfile();
+    FILE *out = tmpfile();
+    fwrite(input.data(), 1, input.size(), in);
+    rewind(in);
+    struct rlimit saved;
+    ASSERT_EQ(0, getrlimit(RLIMIT_NOFILE, &saved));
+    struct rlimit lowered = saved;
+    lowered.rlim_cur = (rlim_t)highest + 4;
+    ASSERT_EQ(0, setrlimit(RLIMIT_NOFILE, &lowered));
+    long students = u1_2_group(&in, 1, out, 0);
+    ASSERT_EQ(0, setrlimit(RLIMIT_NOFILE, &saved));
+    ASSERT_EQ(1000, students);
+
+    std::string actualOutput((size_t)ftell(out), '\0');
+    rewind(out);
+    ASSERT_EQ(actualOutput.size(), fread(&actualOutput[0], 1, actualOutput.size(), out));
+    fclose(in);
+    fclose(out);
+    ASSERT_EQ(expectedOutput, actualOutput);
+}
+
+/**
+ * @brief Tests that malformed events and out-of-range grades are rejected without output.
+ */
+TEST(ExternalGroupTests, RejectsMalformedEvents)
+{
+    std::string output;
+    ASSERT_EQ(-1, runBatchWithInput("1 MAT 2\n2 FYZ 256\n", output, u1_2_group));
+    ASSERT_TRUE(output.empty());
+    ASSERT_EQ(-1, runBatchWithInput("1 MAT\n", output, u1_2_group));
+    ASSERT_EQ(0, runBatchWithInput("", output, u1_2_group));
+}
+
+// Tests for the top-k ranking
+/**
+ * @brief Tests the best and worst lists of every group, with ties kept in student order.
+ */
+TEST(RankingTests, ListsWithStableTies)
+{
+    // Students 2 and 4 share the best average, 3 and 5 the worst; the lower number comes first.
+    std::string input = "3 3\n1 2\n5 5\n2 1\n5 5 5\n4 4 4 3\n0 0\n";
+    std::string output;
+    ASSERT_EQ(7, runBatchWithInput(input, output, u1_2_ranking));
+    ASSERT_NE(std::string::npos, output.find("Všichni studenti (nejlepší):\n1. Student 2: 1.50\n2. Student 4: "
+                                             "1.50\n3. Student 1: 3.00\n4. Student 6: 3.75\n5. Student 3: "
+                                             "5.00\n6. Student 5: 5.00\nVšichni studenti (nejhorší):\n"));
+    ASSERT_NE(std::string::npos, output.find("Neprospěl (nejhorší):\n1. Student 3: 5.00\n2. Student 5: 5.00\n"));
+
+    StudentRanking ranking(2);
+    const int sums[] = {6, 3, 10, 3, 15, 15, 0};
+    const int counts[] = {2, 2, 2, 2, 3, 4, 2};
+    unsigned char classes[7];
+    classify_grade_sums(sums, counts, classes, 7);
+    ranking.add(1, sums, counts, classes, 7);
+
+    const struct
+    {
+        std::vector<RankedStudent> list;
+        long long first;
+        long long second;
+    } EXPECTED[] = {
+        {ranking.best(RANK_ALL), 2, 4},     {ranking.worst(RANK_ALL), 3, 5},
+        {ranking.best(RANK_PASSED), 2, 4},  {ranking.worst(RANK_PASSED), 6, 1},
+        {ranking.best(RANK_FAILED), 3, 5},  {ranking.worst(RANK_FAILED), 3, 5},
+    };
+    for (const auto &expected : EXPECTED)
+    {
+        ASSERT_EQ(2u, expected.list.size());
+        ASSERT_EQ(expected.first, expected.list[0].student);
+        ASSERT_EQ(expected.second, expected.list[1].student);
+    }
+}
+
+/**
+ * @brief Tests that merged and multi-threaded rankings match a full stable sort of the averages.
+ */
+TEST(RankingTests, MergedAndParallelRankingsMatchSorting)
+{
+    std::string input;
+    std::vector<RankedStudent> all;
+    unsigned seed = 53;
+    for (int i = 0; i < 250000; i++)
+    {
+        int sum = 0;
+        int count = 1 + (int)((seed >> 8) % 5);
+        for (int j = 0; j < count; j++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            int grade = 1 + (int)((seed >> 16) % 5);
+            sum += grade;
+            input += std::to_string(grade) + (j + 1 < count ? " " : "\n");
+        }
+        RankedStudent ranked = {i + 1, sum, count};
+        all.push_back(ranked);
+    }
+
+    // The second part numbers its students from 1 and is shifted behind the first when merged.
+    const long long split = (long long)all.size() / 3;
+    StudentRanking whole(25);
+    StudentRanking first(25);
+    StudentRanking second(25);
+    for (size_t i = 0; i < all.size(); i++)
+    {
+        unsigned char grade_class = classify_grade_sum(all[i].sum, grade_thresholds(all[i].count));
+        whole.add(all[i].student, all[i].sum, all[i].count, grade_class);
+        if (all[i].student <= split)
+        {
+            first.add(all[i].student, all[i].sum, all[i].count, grade_class);
+        }
+        else
+        {
+            second.add(all[i].student - split, all[i].sum, all[i].count, grade_class);
+        }
+    }
+    StudentRanking merged(25);
+    merged.merge(second, split);
+    merged.merge(first);
+    std::vector<char> wholeText(whole.format_max_length());
+    std::vector<char> mergedText(merged.format_max_length());
+    ASSERT_EQ(std::string(wholeText.data(), whole.format(wholeText.data())),
+              std::string(mergedText.data(), merged.format(mergedText.data())));
+
+    std::stable_sort(all.begin(), all.end(), [](const RankedStudent &a, const RankedStudent &b) {
+        return (long long)a.sum * b.count < (long long)b.sum * a.count;
+    });
+    std::vector<RankedStudent> best = whole.best(RANK_ALL);
+    ASSERT_EQ(25u, best.size());
+    for (size_t i = 0; i < best.size(); i++)
+    {
+        ASSERT_EQ(all[i].student, best[i].student);
+    }
+
+    std::string sequential;
+    std::string parallel;
+    FILE *in = fmemopen(&input[0], input.size(), "r");
+    char *text = NULL;
+    size_t length = 0;
+    FILE *out = open_memstream(&text, &length);
+    ASSERT_EQ(250000, u1_2_ranking(in, out, 25, 1));
+    fclose(out);
+    sequential.assign(text, length);
+    free(text);
+    rewind(in);
+    out = open_memstream(&text, &length);
+    ASSERT_EQ(250000, u1_2_ranking(in, out, 25, 3));
+    fclose(out);
+    parallel.assign(text, length);
+    free(text);
+    fclose(in);
+    ASSERT_EQ(sequential, parallel);
+}
+
+// Tests for the preloaded rate table
+/**
+ * @brief Tests lookups after a load, where a later line replaces a rate, and that every ISO code gets its own slot.
+ */
+TEST(RateTableTests, LooksUpLoadedRates)
+{
+    std::string rates = "EUR 24.35\nUSD 22.4\nJPY 0.152\nEUR 24.5\n";
+    FILE *in = fmemopen(&rates[0], rates.size(), "r");
+    RateTable table;
+    ASSERT_TRUE(table.load(in));
+    fclose(in);
+    ASSERT_EQ(3u, table.size());
+
+    double rate = 0;
+    ASSERT_TRUE(table.find("EUR", 3, rate));
+    ASSERT_EQ(24.5, rate);
+    ASSERT_TRUE(table.find("JPY", 3, rate));
+    ASSERT_EQ(0.152, rate);
+    ASSERT_FALSE(table.find("GBP", 3, rate));
+    ASSERT_FALSE(table.find("EURO", 4, rate));
+    ASSERT_FALSE(table.find("eur", 3, rate));
+
+    // No two ISO codes share a slot, and codes outside the list are refused.
+    RateTable all;
+    std::string list = "AED CHF CZK GBP HUF PLN SEK USD XAU XXX ZWG ZWL";
+    std::istringstream codes(list);
+    std::string code;
+    double value = 1;
+    while (codes >> code)
+    {
+        ASSERT_TRUE(all.set(code.data(), 3, value));
+        value += 1;
+    }
+    codes.clear();
+    codes.str(list);
+    value = 1;
+    while (codes >> code)
+    {
+        ASSERT_TRUE(all.find(code.data(), 3, rate));
+        ASSERT_EQ(value, rate);
+        value += 1;
+    }
+    ASSERT_FALSE(all.set("ABC", 3, 1.0));
+    ASSERT_FALSE(all.set("EU1", 3, 1.0));
+    ASSERT_FALSE(is_iso_currency(currency_key("QQQ")));
+}
+
+/**
+ * @brief Tests that quotes priced from the table print what the exchange batch prints, and that unknown codes fail.
+ */
+TEST(RateTableTests, QuotesMatchExchangeBatch)
+{
+    std::string rates = "EUR 24.35\nUSD 22.4\nGBP 28.65\n";
+    FILE *in = fmemopen(&rates[0], rates.size(), "r");
+    RateTable table;
+    ASSERT_TRUE(table.load(in));
+    fclose(in);
+
+    std::string quotes = "EUR 100\nUSD 3\nGBP -3\nEUR 0\n";
+    std::string exchange = "EUR 24.35 100\nUSD 22.4 3\nGBP 28.65 -3\nEUR 24.35 0\n";
+    std::string expectedOutput;
+    ASSERT_EQ(4, runBatchWithInput(exchange, expectedOutput, u1_3_batch));
+
+    std::string actualOutput;
+    ASSERT_EQ(4, runBatchWithInput(quotes, actualOutput, [](FILE *input, FILE *output) -> long {
+                  std::string text = "EUR 24.35\nUSD 22.4\nGBP 28.65\n";
+                  FILE *rateFile = fmemopen(&text[0], text.size(), "r");
+                  RateTable loaded;
+                  loaded.load(rateFile);
+                  fclose(rateFile);
+                  return u1_3_quotes(loaded, input, output);
+              }));
+    ASSERT_EQ(expectedOutput, actualOutput);
+
+    InputReader unknown("CHF 10\n", 7);
+    OutputBuffer out;
+    ASSERT_EQ(-1, u1_3_quotes(table, unknown, out));
+}
+
+/**
+ * @brief Tests that rate files with missing, non-positive or unknown entries are rejected.
+ */
+TEST(RateTableTests, RejectsMalformedRateFiles)
+{
+    const char *files[] = {"EUR\n", "EUR abc\n", "EUR 0\n", "EUR -1.5\n", "ABC 1.5\n", "EURO 1.5\n", "\n", " \n\n"};
+    for (const char *file : files)
+    {
+        std::string text = file;
+        FILE *in = fmemopen(&text[0], text.size(), "r");
+        RateTable table;
+        ASSERT_FALSE(table.load(in)) << file;
+        fclose(in);
+    }
+}
+
+// Tests for the packed and interned currency codes
+/**
+ * @brief Tests that three-letter codes are packed, other names interned once, and both turned back into text.
+ */
+TEST(CurrencyCodeTests, PacksAndInternsCodes)
+{
+    CurrencyInterner interner;
+    CurrencyCode eur, usd, euro, again, dollar;
+    ASSERT_TRUE(interner.intern("EUR", 3, eur));
+    ASSERT_TRUE(interner.intern("USD", 3, usd));
+    ASSERT_TRUE(interner.intern("Euro", 4, euro));
+    ASSERT_TRUE(interner.intern("Euro", 4, again));
+    ASSERT_TRUE(interner.intern("$", 1, dollar));
+    ASSERT_EQ(2u, interner.interned());
+    ASSERT_EQ(4u, sizeof(CurrencyCode));
+    ASSERT_EQ(16u, sizeof(ConversionRecord));
+
+    ASSERT_EQ(CURRENCY_INLINE, eur.tag);
+    ASSERT_EQ(CURRENCY_INTERNED, euro.tag);
+    ASSERT_TRUE(euro == again);
+    ASSERT_TRUE(eur != usd);
+    ASSERT_TRUE(euro != dollar);
+
+    size_t length = 0;
+    ASSERT_EQ("EUR", std::string(interner.text(eur, length), 3));
+    ASSERT_EQ(3u, length);
+    const char *text = interner.text(euro, length);
+    ASSERT_EQ("Euro", std::string(text, length));
+    text = interner.text(dollar, length);
+    ASSERT_EQ("$", std::string(text, length));
+
+    CurrencyCode packed;
+    ASSERT_TRUE(currency_code_pack("EUR", 3, packed));
+    ASSERT_EQ(eur.value(), packed.value());
+    ASSERT_FALSE(currency_code_pack("EURO", 4, packed));
+}
+
+/**
+ * @brief Tests the exchange batch, sequential and parallel, with packed and interned names over several blocks.
+ */
+TEST(CurrencyCodeTests, ExchangeBatchWithLongNames)
+{
+    // More records than one parsing block, with names that are packed and names that are interned.
+    const char *names[] = {"EUR", "Euro", "USD", "dolar", "GBP", "libra_sterlingu"};
+    std::string input;
+    std::string expectedOutput;
+    for (int i = 0; i < 5000; i++)
+    {
+        std::string record = std::string(names[i % 6]) + " " + std::to_string(20 + i % 13) + "." +
+                             std::to_string(i % 10) + " " + std::to_string(i % 97 - 40) + "\n";
+        input += record;
+        if (i < 3)
+        {
+            std::string single;
+            runTestWithInputForFunction(record, single, u1_3);
+            expectedOutput += single;
+        }
+    }
+
+    std::string actualOutput;
+    ASSERT_EQ(5000, runBatchWithInput(input, actualOutput, u1_3_batch));
+    ASSERT_EQ(expectedOutput, actualOutput.substr(0, expectedOutput.size()));
+
+    std::string parallelOutput;
+    ASSERT_EQ(5000, runParallelBatchWithInput(input, parallelOutput, u1_3_conversions, false));
+    ASSERT_EQ(actualOutput, parallelOutput);
+}
+
+// Tests for the hot-reloaded rate snapshots
+/**
+ * @brief Tests that a replaced snapshot is freed only after the reader holding it lets go.
+ */
+TEST(RateSnapshotTests, ReplacedSnapshotsWaitForReaders)
+{
+    RateSnapshots snapshots;
+    RateTable rates;
+    ASSERT_EQ(0u, snapshots.version());
+    ASSERT_EQ(1u, snapshots.publish(rates));
+
+    RateSnapshots::Reader reader(snapshots);
+    const RateSnapshot *held = reader.acquire();
+    ASSERT_EQ(1u, held->version);
+    ASSERT_EQ(2u, snapshots.publish(rates));
+    ASSERT_EQ(1u, snapshots.retired());
+    ASSERT_EQ(1u, held->version);
+
+    ASSERT_EQ(2u, reader.acquire()->version);
+    ASSERT_EQ(3u, snapshots.publish(rates));
+    ASSERT_EQ(1u, snapshots.retired());
+    reader.release();
+    ASSERT_EQ(4u, snapshots.publish(rates));
+    ASSERT_EQ(0u, snapshots.retired());
+    ASSERT_EQ(4u, snapshots.version());
+}
+
+/**
+ * @brief Tests that readers racing with publishers always see complete snapshots in increasing versions.
+ */
+TEST(RateSnapshotTests, ConcurrentReadersSeeWholeSnapshots)
+{
+    // Every snapshot sets all its rates to its own version; a reader must never see a mix.
+    const char *codes[] = {"EUR", "USD", "GBP", "JPY"};
+    RateSnapshots snapshots;
+    RateTable rates;
+    for (const char *code : codes)
+    {
+        rates.set(code, 3, 1);
+    }
+    snapshots.publish(rates);
+
+    std::atomic<bool> done(false);
+    std::atomic<long> failures(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; t++)
+    {
+        readers.push_back(std::thread([&] {
+            RateSnapshots::Reader reader(snapshots);
+            unsigned long long last = 0;
+            while (!done.load())
+            {
+                const RateSnapshot *snapshot = reader.acquire();
+                for (const char *code : codes)
+                {
+                    double rate = 0;
+                    if (!snapshot->rates.find(code, 3, rate) || rate != (double)snapshot->version)
+                    {
+                        failures++;
+                    }
+                }
+                if (snapshot->version < last)
+                {
+                    failures++;
+                }
+                last = snapshot->version;
+                reader.release();
+            }
+        }));
+    }
+    for (int version = 2; version <= 2000; version++)
+    {
+        for (const char *code : codes)
+        {
+            rates.set(code, 3, version);
+        }
+        ASSERT_EQ((unsigned long long)version, snapshots.publish(rates));
+    }
+    done = true;
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+    ASSERT_EQ(0, failures.load());
+    ASSERT_LE(snapshots.retired(), 3u);
+}
+
+/**
+ * @brief Tests that the watcher publishes valid rate files, skips malformed ones and reloads in the background.
+ */
+TEST(RateSnapshotTests, WatcherReloadsChangedFile)
+{
+    char path[] = "/tmp/zsp_ratesXXXXXX";
+    int descriptor = mkstemp(path);
+    ASSERT_NE(-1, descriptor);
+    close(descriptor);
+    auto write_file = [&path](const char *text) {
+        FILE *file = fopen(path, "w");
+        fputs(text, file);
+        fclose(file);
+    };
+
+    write_file("EUR 24.35\n");
+    RateSnapshots snapshots;
+    RateFileWatcher watcher(path, snapshots);
+    ASSERT_TRUE(watcher.check());
+    ASSERT_FALSE(watcher.check());
+    ASSERT_EQ(1u, snapshots.version());
+
+    write_file("EUR 25.1\nUSD 22.4\n");
+    ASSERT_TRUE(watcher.check());
+    write_file("EUR 25,10\nUSD 22.4\n");
+    ASSERT_FALSE(watcher.check());
+    ASSERT_EQ(2u, snapshots.version());
+    // A file truncated for rewriting is not published either.
+    write_file("");
+    ASSERT_FALSE(watcher.check());
+    ASSERT_EQ(2u, snapshots.version());
+
+    std::string input = "EUR 10\nUSD 2\n";
+    InputReader reader(input.data(), input.size());
+    OutputBuffer out;
+    ASSERT_EQ(2, u1_3_live_quotes(snapshots, reader, out));
+    std::string output(out.data(), out.size());
+    ASSERT_EQ("1 EUR = 25.1 Kč\nNákup: 10 EUR\nCelkem: 10 x 25.1 = 251.0 Kč Zaokrouhleno: 251 Kč\nVerze kurzů: 2\n",
+              output.substr(0, output.find("1 USD")));
+
+    watcher.start(1);
+    write_file("EUR 26\nUSD 23\nGBP 28\n");
+    for (int i = 0; i < 2000 && snapshots.version() < 3; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    watcher.stop();
+    ASSERT_EQ(3u, snapshots.version());
+    unlink(path);
+}
+
+// Tests for the cross-rate matrix
+/**
+ * @brief Tests matrix lookups and that every pair, CZK included, is converted with a single rounding.
+ */
+TEST(CrossRatesTests, SingleRoundingForEveryPair)
+{
+    RateTable rates;
+    rates.set("EUR", 3, 24.35);
+    rates.set("USD", 3, 22.4);
+    rates.set("GBP", 3, 28.65);
+    rates.set("PLN", 3, 5.62);
+    CrossRateMatrix matrix;
+    matrix.build(rates);
+    ASSERT_EQ(5u, matrix.currencies());
+
+    CurrencyCode eur, usd, czk, chf;
+    currency_code_pack("EUR", 3, eur);
+    currency_code_pack("USD", 3, usd);
+    currency_code_pack("CZK", 3, czk);
+    currency_code_pack("CHF", 3, chf);
+    ASSERT_EQ(-1, matrix.index(chf));
+    ASSERT_EQ(24.35 / 22.4, matrix.rate(matrix.index(eur), matrix.index(usd)));
+    ASSERT_EQ(1.0, matrix.rate(matrix.index(usd), matrix.index(usd)));
+    ASSERT_EQ(0u, (uintptr_t)matrix.row(1) % 64);
+
+    // Conversions into CZK round exactly like u1_3().
+    std::string input = "EUR CZK 10\nEUR USD 100\nGBP PLN -3\nCZK EUR 1000\n";
+    InputReader reader(input.data(), input.size());
+    OutputBuffer out;
+    ASSERT_EQ(4, u1_3_cross_conversions(matrix, reader, out));
+    ASSERT_EQ("10 EUR = 243.5 CZK Zaokrouhleno: 244 CZK\n"
+              "100 EUR = 108.7 USD Zaokrouhleno: 109 USD\n"
+              "-3 GBP = -15.3 PLN Zaokrouhleno: -15 PLN\n"
+              "1000 CZK = 41.1 EUR Zaokrouhleno: 41 EUR\n",
+              std::string(out.data(), out.size()));
+
+    InputReader unknown("EUR CHF 1\n", 10);
+    ASSERT_EQ(-1, u1_3_cross_conversions(matrix, unknown, out));
+}
+
+/**
+ * @brief Tests that changed and added rates applied one by one give the matrix a full rebuild gives.
+ */
+TEST(CrossRatesTests, IncrementalUpdatesMatchRebuild)
+{
+    const char *codes[] = {"AUD", "CAD", "EUR", "GBP", "JPY", "NOK", "PLN", "SEK", "USD", "ZAR"};
+    RateTable rates;
+    for (int i = 0; i < 10; i++)
+    {
+        rates.set(codes[i], 3, 1.5 + i * 2.25);
+    }
+    CrossRateMatrix matrix;
+    matrix.build(rates);
+    ASSERT_EQ(0u, matrix.update(rates));
+
+    rates.set("GBP", 3, 29.01);
+    ASSERT_EQ(1u, matrix.update(rates));
+    ASSERT_TRUE(matrix.update(currency_key("SEK"), 2.13));
+    rates.set("SEK", 3, 2.13);
+    ASSERT_TRUE(matrix.update(currency_key("CHF"), 25.7));
+    rates.set("CHF", 3, 25.7);
+    ASSERT_FALSE(matrix.update(currency_key("QQQ"), 1.0));
+
+    CrossRateMatrix rebuilt;
+    rebuilt.build(rates);
+    ASSERT_EQ(rebuilt.currencies(), matrix.currencies());
+    for (int s = 0; s < (int)matrix.currencies(); s++)
+    {
+        ASSERT_EQ(rebuilt.key(s), matrix.key(s));
+        for (int t = 0; t < (int)matrix.currencies(); t++)
+        {
+            ASSERT_EQ(rebuilt.rate(s, t), matrix.rate(s, t));
+        }
+    }
+}
+
+/**
+ * @brief Tests that live conversions wait for a first snapshot and pick up changed and added rates.
+ */
+TEST(CrossRatesTests, LiveConversionsFollowSnapshots)
+{
+    RateSnapshots snapshots;
+    CrossRateMatrix matrix;
+    OutputBuffer out;
+    InputReader early("EUR CZK 10\n", 11);
+    ASSERT_EQ(-1, u1_3_live_cross_conversions(snapshots, matrix, early, out));
+
+    RateTable rates;
+    rates.set("EUR", 3, 24.35);
+    rates.set("USD", 3, 22.4);
+    snapshots.publish(rates);
+    std::string input = "EUR CZK 10\nEUR USD 100\n";
+    InputReader first(input.data(), input.size());
+    ASSERT_EQ(2, u1_3_live_cross_conversions(snapshots, matrix, first, out));
+    ASSERT_EQ("10 EUR = 243.5 CZK Zaokrouhleno: 244 CZK\n100 EUR = 108.7 USD Zaokrouhleno: 109 USD\n",
+              std::string(out.data(), out.size()));
+
+    // A changed rate and a new currency reach the matrix the caller keeps.
+    out.clear();
+    rates.set("EUR", 3, 25);
+    rates.set("GBP", 3, 28.65);
+    snapshots.publish(rates);
+    input += "GBP EUR 2\n";
+    InputReader second(input.data(), input.size());
+    ASSERT_EQ(3, u1_3_live_cross_conversions(snapshots, matrix, second, out));
+    ASSERT_EQ("10 EUR = 250.0 CZK Zaokrouhleno: 250 CZK\n100 EUR = 111.6 USD Zaokrouhleno: 112 USD\n"
+              "2 GBP = 2.3 EUR Zaokrouhleno: 2 EUR\n",
+              std::string(out.data(), out.size()));
+    ASSERT_EQ(4u, matrix.currencies());
+}
+
+// Tests for the historical rate series
+/**
+ * @brief Tests as-of lookups, including equal timestamps and queries before the first point, and the conversions.
+ */
+TEST(RateHistoryTests, AsOfConversions)
+{
+    std::string text = "EUR 1700000000 24.35\nUSD 1700000000 22.4\nEUR 1600000000 26.1\n"
+                       "EUR 1700086400 24.5\nEUR 1700000000 24.4\n";
+    FILE *in = fmemopen(&text[0], text.size(), "r");
+    RateHistory history;
+    ASSERT_TRUE(history.load(in));
+    fclose(in);
+    ASSERT_EQ(4u, history.points());
+
+    CurrencyCode eur;
+    currency_code_pack("EUR", 3, eur);
+    double rate = 0;
+    long long since = 0;
+    ASSERT_FALSE(history.rate_at(eur, 1599999999, rate, since));
+    ASSERT_TRUE(history.rate_at(eur, 1600000000, rate, since));
+    ASSERT_EQ(26.1, rate);
+    ASSERT_TRUE(history.rate_at(eur, 1700000000, rate, since));
+    ASSERT_EQ(24.4, rate); // The later of two points with the same time wins.
+    ASSERT_TRUE(history.rate_at(eur, 4000000000LL, rate, since));
+    ASSERT_EQ(24.5, rate);
+    ASSERT_EQ(1700086400, since);
+
+    std::string input = "EUR 1650000000 10\nUSD 1700000001 7\nEUR 1700090000 10\n";
+    InputReader reader(input.data(), input.size());
+    OutputBuffer out;
+    ASSERT_EQ(3, u1_3_history_conversions(history, reader, out));
+    std::string output(out.data(), out.size());
+    ASSERT_EQ(0u, output.find("1 EUR = 26.1 Kč\nNákup: 10 EUR\nCelkem: 10 x 26.1 = 261.0 Kč Zaokrouhleno: 261 "
+                              "Kč\nKurz platný od: 1600000000\n"));
+    ASSERT_NE(std::string::npos, output.find("Zaokrouhleno: 245 Kč\nKurz platný od: 1700086400\n"));
+
+    InputReader early("USD 1600000000 1\n", 17);
+    ASSERT_EQ(-1, u1_3_history_conversions(history, early, out));
+}
+
+/**
+ * @brief Tests searched and swept lookups against a linear scan, and parsing of 64-bit timestamps.
+ */
+TEST(RateHistoryTests, SearchAndSweepMatchLinearScan)
+{
+    unsigned seed = 59;
+    for (int size = 1; size <= 70; size++)
+    {
+        RateHistory history;
+        CurrencyCode code;
+        currency_code_pack("GBP", 3, code);
+        std::vector<long long> times;
+        for (int i = 0; i < size; i++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            long long time = (long long)(seed >> 8) % 1000 * 3600 - 100000;
+            times.push_back(time);
+            history.add(code, time, (double)time);
+        }
+        history.finalize();
+        std::sort(times.begin(), times.end());
+
+        // Sorted queries sweep, the shuffled second half falls back to searching.
+        std::vector<long long> queries;
+        for (long long q = -200000; q < 3700000; q += 1800)
+        {
+            queries.push_back(q);
+        }
+        for (size_t i = queries.size() / 2; i + 1 < queries.size(); i++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            std::swap(queries[i], queries[i + (seed >> 8) % (queries.size() - i)]);
+        }
+
+        RateHistory::Cursor cursor(history);
+        for (long long query : queries)
+        {
+            long long expected = times[0];
+            for (long long time : times)
+            {
+                expected = time <= query ? time : expected;
+            }
+            double rate = 0;
+            long long since = 0;
+            bool found = history.rate_at(code, query, rate, since);
+            ASSERT_EQ(times[0] <= query, found) << size << " " << query;
+            double swept = 0;
+            long long swept_since = 0;
+            ASSERT_EQ(found, cursor.rate_at(code, query, swept, swept_since));
+            if (found)
+            {
+                ASSERT_EQ(expected, since);
+                ASSERT_EQ((double)expected, rate);
+                ASSERT_EQ(since, swept_since);
+            }
+        }
+    }
+
+    InputReader reader("-9223372036854775807 +42 x", 26);
+    long long value = 0;
+    ASSERT_TRUE(reader.next_long(value));
+    ASSERT_EQ(-9223372036854775807LL, value);
+    ASSERT_TRUE(reader.next_long(value));
+    ASSERT_EQ(42, value);
+    ASSERT_FALSE(reader.next_long(value));
+}
+
+// Tests for the fixed-point conversions
+/**
+ * @brief Tests that the fixed-point batch matches u1_3, rounds exact ties up and rejects exponents.
+ */
+TEST(FixedDecimalTests, MatchesSingleRecordConversions)
+{
+    const char *records[] = {"GBP 24.9 5\n", "EUR 26.3 3\n", "USD 21.8 7\n", "GBP 24.1 4\n",
+                             "EUR 26.2 2\n",  "USD 21.4 3\n", "JPY 0.2 0\n",  "JPY 0 5\n"};
+    std::string input;
+    std::string expectedOutput;
+    for (const char *record : records)
+    {
+        std::string single;
+        runTestWithInputForFunction(record, single, u1_3);
+        input += record;
+        expectedOutput += single;
+    }
+
+    std::string actualOutput;
+    ASSERT_EQ(8, runBatchWithInput(input, actualOutput, u1_3_fixed_batch));
+    ASSERT_EQ(expectedOutput, actualOutput);
+
+    // Exact ties round up, negative products to the nearest unit.
+    std::string tieOutput;
+    ASSERT_EQ(2, runBatchWithInput("EUR 24.35 10\nUSD 10.3 -12\n", tieOutput, u1_3_fixed_batch));
+    ASSERT_NE(std::string::npos, tieOutput.find("= 243.5 Kč Zaokrouhleno: 244 Kč\n"));
+    ASSERT_NE(std::string::npos, tieOutput.find("= -123.6 Kč Zaokrouhleno: -124 Kč\n"));
+
+    std::string malformedOutput;
+    ASSERT_EQ(-1, runBatchWithInput("EUR 1e3 2\n", malformedOutput, u1_3_fixed_batch));
+}
+
+/**
+ * @brief Tests exact rate parsing, including rounding past six places and rejected forms, and tenths formatting.
+ */
+TEST(FixedDecimalTests, ParsesAndFormatsDecimals)
+{
+    FixedRate rate;
+    ASSERT_TRUE(fixed_rate_parse("24.35", 5, rate));
+    ASSERT_EQ(24, rate.units);
+    ASSERT_EQ(350000, rate.micros);
+    ASSERT_TRUE(fixed_rate_parse(".5", 2, rate));
+    ASSERT_EQ(0, rate.units);
+    ASSERT_EQ(500000, rate.micros);
+    ASSERT_TRUE(fixed_rate_parse("7.", 2, rate));
+    ASSERT_EQ(7, rate.units);
+    ASSERT_EQ(0, rate.micros);
+    ASSERT_TRUE(fixed_rate_parse("1.99999951", 10, rate));
+    ASSERT_EQ(2, rate.units);
+    ASSERT_EQ(0, rate.micros);
+    ASSERT_TRUE(fixed_rate_parse("0.00000049", 10, rate));
+    ASSERT_EQ(0, rate.micros);
+
+    const char *rejected[] = {"", ".", "-1", "+1", "1e3", "1.2.3", "1,5", "100000000", "99999999.9999995"};
+    for (const char *text : rejected)
+    {
+        ASSERT_FALSE(fixed_rate_parse(text, strlen(text), rate)) << text;
+    }
+
+    char buffer[32];
+    ASSERT_EQ("-15.3", std::string(buffer, format_tenths(buffer, -153)));
+    ASSERT_EQ("-0.3", std::string(buffer, format_tenths(buffer, -3)));
+    ASSERT_EQ("0.0", std::string(buffer, format_tenths(buffer, 0)));
+}
+
+/**
+ * @brief Tests the vector kernel against the 128-bit scalar reference, including ties and negative amounts.
+ */
+TEST(FixedDecimalTests, VectorKernelMatchesScalar)
+{
+    const size_t records = 1003;
+    std::vector<int32_t> units(records);
+    std::vector<int32_t> micros(records);
+    std::vector<int32_t> counts(records);
+    unsigned seed = 61;
+    for (size_t i = 0; i < records; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        units[i] = (int32_t)((seed >> 4) % (i % 3 ? 100 : FIXED_MAX_UNITS));
+        seed = seed * 1103515245u + 12345u;
+        micros[i] = (int32_t)((seed >> 4) % FIXED_SCALE / (i % 2 ? 1 : 50000) * (i % 2 ? 1 : 50000));
+        seed = seed * 1103515245u + 12345u;
+        counts[i] = i % 5 ? (int32_t)(seed >> 8) % 20001 - 10000 : (int32_t)seed;
+    }
+
+    std::vector<int64_t> rounded(records);
+    std::vector<int64_t> tenths(records);
+    std::vector<int64_t> expectedRounded(records);
+    std::vector<int64_t> expectedTenths(records);
+    fixed_convert_scalar(units.data(), micros.data(), counts.data(), expectedRounded.data(), expectedTenths.data(),
+                         records);
+    fixed_convert(units.data(), micros.data(), counts.data(), rounded.data(), tenths.data(), records);
+    ASSERT_EQ(expectedRounded, rounded);
+    ASSERT_EQ(expectedTenths, tenths);
+    if (__builtin_cpu_supports("avx2"))
+    {
+        std::vector<int64_t> avx2Rounded(records);
+        std::vector<int64_t> avx2Tenths(records);
+        fixed_convert_avx2(units.data(), micros.data(), counts.data(), avx2Rounded.data(), avx2Tenths.data(),
+                           records);
+        ASSERT_EQ(expectedRounded, avx2Rounded);
+        ASSERT_EQ(expectedTenths, avx2Tenths);
+    }
+
+    int32_t tie_units[] = {24, 2, 0};
+    int32_t tie_micros[] = {350000, 500000, 50000};
+    int32_t tie_counts[] = {10, -1, -1};
+    int64_t tie_rounded[3];
+    int64_t tie_tenths[3];
+    fixed_convert(tie_units, tie_micros, tie_counts, tie_rounded, tie_tenths, 3);
+    ASSERT_EQ(244, tie_rounded[0]);
+    ASSERT_EQ(2435, tie_tenths[0]);
+    ASSERT_EQ(-2, tie_rounded[1]);
+    ASSERT_EQ(-25, tie_tenths[1]);
+    ASSERT_EQ(0, tie_rounded[2]);
+    ASSERT_EQ(0, tie_tenths[2]);
+}
+
+/**
+ * @brief Tests that records scanned in place match records read token by token through a tiny buffer.
+ */
+TEST(FixedDecimalTests, ScannedRecordsMatchTokenReads)
+{
+    const char *shapes[] = {"EUR 24.35 10\n",     "USD\t1.5\t-7\n",     "GBP 0.125 +3\r\n",
+                            "JPY .5 123456789\n", "KORUNA 2 4\n",       "EUR 99999999.999999 -2147483648\n",
+                            "USD 7. 0\n",         "GBP\n3.25\n12\n",   "CHF 1.23456789 8 ",
+                            "EUR 00000000012.5 00000001\n"};
+    std::string input;
+    for (int i = 0; i < 500; i++)
+    {
+        input += shapes[i % 10];
+    }
+
+    OutputBuffer inPlace;
+    InputReader reader(input.data(), input.size());
+    ASSERT_EQ(500, u1_3_fixed_conversions(reader, inPlace));
+    std::string scanned(inPlace.data(), inPlace.size());
+    ASSERT_EQ(0u, scanned.find("1 EUR = 24.4 Kč\nNákup: 10 EUR\nCelkem: 10 x 24.4 = 243.5 Kč Zaokrouhleno: 244 Kč\n"));
+    ASSERT_NE(std::string::npos, scanned.find("Celkem: 123456789 x 0.5 = 61728394.5 Kč Zaokrouhleno: 61728395 Kč\n"));
+
+    FILE *streamed = fmemopen(&input[0], input.size(), "r");
+    OutputBuffer tokens;
+    InputReader tinyReader(streamed, 64);
+    ASSERT_EQ(500, u1_3_fixed_conversions(tinyReader, tokens));
+    fclose(streamed);
+    ASSERT_EQ(scanned, std::string(tokens.data(), tokens.size()));
+}
+
+// Tests for the daemon mode
+/**
+ * @brief Tests that responses match the interactive tasks and that malformed and unknown requests are refused.
+ */
+TEST(DaemonTests, ResponsesMatchSingleRecordTasks)
+{
+    char frame[DAEMON_MAX_REQUEST_FRAME];
+    char response[DAEMON_MAX_RESPONSE];
+    auto respond = [&](size_t size, int &status) {
+        char *end = daemon_respond(frame + DAEMON_LENGTH_SIZE, size - DAEMON_LENGTH_SIZE, response);
+        EXPECT_EQ((size_t)(end - response), DAEMON_LENGTH_SIZE + ((unsigned char)response[0] | response[1] << 8));
+        status = (unsigned char)response[DAEMON_LENGTH_SIZE];
+        return std::string(response + DAEMON_LENGTH_SIZE + 1, end);
+    };
+
+    int status = -1;
+    std::string expectedOutput;
+    runTestWithInputForFunction("5 100", expectedOutput, u1_1);
+    ASSERT_EQ(expectedOutput, respond(daemon_receipt_request(frame, 5, 100, 20), status));
+    ASSERT_EQ(DAEMON_OK, status);
+
+    const unsigned char grades[] = {3, 3, 5, 2, 5};
+    runTestWithInputForFunction("3 3 5 2 5", expectedOutput, u1_2);
+    ASSERT_EQ(expectedOutput, respond(daemon_grades_request(frame, grades), status));
+    ASSERT_EQ(DAEMON_OK, status);
+
+    runTestWithInputForFunction("GBP 24.9 5", expectedOutput, u1_3);
+    ASSERT_EQ(expectedOutput, respond(daemon_conversion_request(frame, "GBP", 3, 24.9, 5), status));
+    ASSERT_EQ(DAEMON_OK, status);
+
+    ASSERT_EQ("", respond(daemon_receipt_request(frame, 5, 100, 19), status));
+    ASSERT_EQ(DAEMON_MALFORMED, status);
+    size_t size = daemon_conversion_request(frame, "GBP", 3, 24.9, 5);
+    frame[DAEMON_LENGTH_SIZE + 1] = 4;
+    ASSERT_EQ("", respond(size, status));
+    ASSERT_EQ(DAEMON_MALFORMED, status);
+    frame[DAEMON_LENGTH_SIZE] = 9;
+    ASSERT_EQ("", respond(size, status));
+    ASSERT_EQ(DAEMON_UNKNOWN_TASK, status);
+    ASSERT_EQ(0u, daemon_conversion_request(frame, std::string(256, 'X').c_str(), 256, 1, 1));
+}
+
+/**
+ * @brief Tests concurrent clients that pipeline more requests than the server keeps pending, and an oversized frame.
+ */
+TEST(DaemonTests, ServesPipelinedClients)
+{
+    std::string path = "/tmp/zsp_daemon_test_" + std::to_string(getpid()) + ".sock";
+    DaemonServer server;
+    ASSERT_TRUE(server.listen(path.c_str()));
+    std::thread loop([&server] { server.run(); });
+
+    // Each client sends all its requests before reading any response, more than the server keeps
+    // pending, so the server has to stop reading until the client catches up.
+    const int REQUESTS = 3000;
+    std::vector<std::thread> clients;
+    std::atomic<int> mismatches(0);
+    for (int c = 0; c < 3; c++)
+    {
+        clients.push_back(std::thread([&path, &mismatches, c] {
+            DaemonClient client;
+            if (!client.connect(path.c_str()))
+            {
+                mismatches++;
+                return;
+            }
+            std::thread sender([&client, c] {
+                char frame[DAEMON_MAX_REQUEST_FRAME];
+                for (int i = 0; i < REQUESTS; i++)
+                {
+                    client.send(frame, daemon_receipt_request(frame, i % 7, c * 1000 + i, i % 2 ? 21 : 12));
+                }
+            });
+            int status = -1;
+            std::string text;
+            char expected[FORMAT_RECEIPT_MAX_LENGTH];
+            for (int i = 0; i < REQUESTS; i++)
+            {
+                int price = c * 1000 + i;
+                VatRate rate = i % 2 ? VAT_RATE_21 : VAT_RATE_12;
+                char *end = format_u1_1_receipt(expected, i % 7, price, vat_gross_price(price, rate), i % 2 ? 21 : 12);
+                if (!client.receive(status, text) || status != DAEMON_OK || text != std::string(expected, end))
+                {
+                    mismatches++;
+                }
+            }
+            sender.join();
+        }));
+    }
+    for (std::thread &client : clients)
+    {
+        client.join();
+    }
+    ASSERT_EQ(0, mismatches.load());
+
+    // An oversized frame closes the connection without a response.
+    DaemonClient rogue;
+    ASSERT_TRUE(rogue.connect(path.c_str()));
+    const char oversized[] = {'\xff', '\xff', 1};
+    ASSERT_TRUE(rogue.send(oversized, sizeof(oversized)));
+    int status = -1;
+    std::string text;
+    ASSERT_FALSE(rogue.receive(status, text));
+
+    server.stop();
+    loop.join();
+    ASSERT_EQ(3u * REQUESTS, server.requests());
+}
+
+/**
+ * @brief Tests that listening replaces a stale socket file but never a regular file.
+ */
+TEST(DaemonTests, ReplacesOnlyStaleSockets)
+{
+    std::string path = "/tmp/zsp_daemon_path_" + std::to_string(getpid());
+
+    // A regular file at the path is neither removed nor overwritten.
+    FILE *file = fopen(path.c_str(), "w");
+    ASSERT_NE((FILE *)NULL, file);
+    fputs("keep", file);
+    fclose(file);
+    {
+        DaemonServer server;
+        ASSERT_FALSE(server.listen(path.c_str()));
+    }
+    char text[8] = {0};
+    file = fopen(path.c_str(), "r");
+    ASSERT_NE((FILE *)NULL, file);
+    ASSERT_EQ(4u, fread(text, 1, sizeof(text), file));
+    fclose(file);
+    ASSERT_STREQ("keep", text);
+    unlink(path.c_str());
+
+    // A socket file left behind by a process that exited is replaced.
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path.c_str());
+    int stale = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_EQ(0, bind(stale, (struct sockaddr *)&address, sizeof(address)));
+    close(stale);
+    DaemonServer server;
+    ASSERT_TRUE(server.listen(path.c_str()));
+}
+
+// Tests for the compute API
+/**
+ * @brief Tests that the compute texts match the interactive tasks and that a short buffer receives nothing.
+ */
+TEST(ComputeTests, TextsMatchInteractiveTasks)
+{
+    std::string expectedOutput;
+    char buffer[512];
+
+    ReceiptRecord receipt_record = {5, 100, 20};
+    Receipt receipt;
+    ASSERT_TRUE(compute_receipt(receipt_record, receipt));
+    ASSERT_EQ(120, receipt.gross);
+    ASSERT_EQ(500, receipt.net_total);
+    ASSERT_EQ(600, receipt.gross_total);
+    runTestWithInputForFunction("5 100", expectedOutput, u1_1);
+    ASSERT_EQ(expectedOutput, std::string(buffer, receipt_text(receipt_record, receipt, buffer, sizeof(buffer))));
+    ReceiptRecord unknown_rate = {5, 100, 19};
+    ASSERT_FALSE(compute_receipt(unknown_rate, receipt));
+
+    GradeRecord grade_record = {{1, 2, 1, 1, 2}};
+    GradeReport report = compute_grade_report(grade_record);
+    ASSERT_DOUBLE_EQ(1.4, report.average);
+    ASSERT_TRUE(report.status.distinction);
+    runTestWithInputForFunction("1 2 1 1 2", expectedOutput, u1_2);
+    ASSERT_EQ(expectedOutput, std::string(buffer, grade_report_text(grade_record, report, buffer, sizeof(buffer))));
+
+    ExchangeRecord exchange_record = {"EUR", 3, 26.3, 3};
+    int rounded = compute_exchange(exchange_record);
+    ASSERT_EQ(79, rounded);
+    runTestWithInputForFunction("EUR 26.3 3", expectedOutput, u1_3);
+    size_t length = exchange_text(exchange_record, rounded, buffer, sizeof(buffer));
+    ASSERT_EQ(expectedOutput, std::string(buffer, length));
+
+    // A buffer one byte short receives nothing but learns the needed length.
+    char small[512];
+    memset(small, '#', sizeof(small));
+    ASSERT_EQ(length, exchange_text(exchange_record, rounded, small, length - 1));
+    ASSERT_EQ(std::string(length, '#'), std::string(small, length));
+    ASSERT_EQ(length, exchange_text(exchange_record, rounded, small, length));
+    ASSERT_EQ(expectedOutput, std::string(small, length));
+}
+
+/**
+ * @brief Tests that receipt texts print the 64-bit totals of compute_receipt() instead of int products.
+ */
+TEST(ComputeTests, ReceiptTextKeepsWideTotals)
+{
+    ReceiptRecord record = {100000, 100000, 20};
+    Receipt receipt;
+    ASSERT_TRUE(compute_receipt(record, receipt));
+    ASSERT_EQ(10000000000LL, receipt.net_total);
+    ASSERT_EQ(12000000000LL, receipt.gross_total);
+
+    std::string expectedOutput = "Účtenka\nCena bez DPH/ks 100000 Kč\tCena s DPH/ks 120000 Kč\nPočet kusů: 100000\t"
+                                 "Cena bez DPH 10000000000 Kč\tCena s DPH (20 %) 12000000000 Kč\n";
+    char buffer[512];
+    ASSERT_EQ(expectedOutput, std::string(buffer, receipt_text(record, receipt, buffer, sizeof(buffer))));
+
+    std::string actualOutput;
+    ASSERT_EQ(1, runBatchWithInput("100000 100000\n", actualOutput, u1_1_batch));
+    ASSERT_EQ(expectedOutput, actualOutput);
+    *format_u1_1_receipt(buffer, record.count, record.price, receipt.gross, record.percent) = '\0';
+    ASSERT_EQ(expectedOutput, std::string(buffer));
+}
+
+/**
+ * @brief Tests that the span computations and writers match single records and stop at an unknown rate.
+ */
+TEST(ComputeTests, SpansMatchSingleRecords)
+{
+    const size_t COUNT = 2500;
+    const int PERCENTS[] = {20, 21, 12, 0};
+    std::vector<ReceiptRecord> receipt_records(COUNT);
+    std::vector<GradeRecord> grade_records(COUNT);
+    std::vector<ExchangeRecord> exchange_records(COUNT);
+    unsigned seed = 67;
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        receipt_records[i].count = (int)(seed >> 20) % 100 - 10;
+        receipt_records[i].price = (int)(seed >> 8) % 100000 - 500;
+        receipt_records[i].percent = PERCENTS[i % 4];
+        for (int g = 0; g < COMPUTE_GRADES; g++)
+        {
+            grade_records[i].grades[g] = (int)((seed >> (3 * g)) % 7);
+        }
+        exchange_records[i].currency = "USD";
+        exchange_records[i].length = 3;
+        exchange_records[i].rate = (double)(seed >> 16) / 1000;
+        exchange_records[i].count = (int)(i % 300);
+    }
+
+    std::vector<Receipt> receipts(COUNT);
+    std::vector<GradeReport> reports(COUNT);
+    std::vector<int> rounded(COUNT);
+    ASSERT_EQ(COUNT, compute_receipt(&receipt_records[0], COUNT, &receipts[0]));
+    compute_grade_report(&grade_records[0], COUNT, &reports[0]);
+    compute_exchange(&exchange_records[0], COUNT, &rounded[0]);
+
+    OutputBuffer out;
+    write_receipts(&receipt_records[0], &receipts[0], COUNT, out);
+    write_grade_reports(&grade_records[0], &reports[0], COUNT, out);
+    write_exchanges(&exchange_records[0], &rounded[0], COUNT, out);
+
+    std::string expected;
+    char buffer[FORMAT_RECEIPT_MAX_LENGTH + FORMAT_REPORT_MAX_LENGTH];
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        Receipt receipt;
+        ASSERT_TRUE(compute_receipt(receipt_records[i], receipt));
+        expected.append(buffer, receipt_text(receipt_records[i], receipt, buffer, sizeof(buffer)));
+    }
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        GradeReport report = compute_grade_report(grade_records[i]);
+        expected.append(buffer, grade_report_text(grade_records[i], report, buffer, sizeof(buffer)));
+    }
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        std::vector<char> text(format_conversion_max_length(3));
+        int single = compute_exchange(exchange_records[i]);
+        expected.append(&text[0], exchange_text(exchange_records[i], single, &text[0], text.size()));
+    }
+    ASSERT_EQ(expected, std::string(out.data(), out.size()));
+
+    // Pricing stops in front of the first unknown rate.
+    receipt_records[1500].percent = 15;
+    ASSERT_EQ(1500u, compute_receipt(&receipt_records[0], COUNT, &receipts[0]));
+}
+
+// Tests for the SPSC ring and the pipelined batch mode
+/**
+ * @brief Tests the ring's full and empty states and an in-order transfer from a producer thread.
+ */
+TEST(SpscRingTests, TransfersInOrderAcrossThreads)
+{
+    SpscRing<int> ring(3);
+    ASSERT_EQ(4u, ring.capacity());
+    int value = 0;
+    ASSERT_FALSE(ring.try_pop(value));
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(ring.try_push(i));
+    }
+    ASSERT_FALSE(ring.try_push(4));
+    ASSERT_TRUE(ring.try_pop(value));
+    ASSERT_EQ(0, value);
+    ASSERT_TRUE(ring.try_push(4));
+    for (int i = 1; i <= 4; i++)
+    {
+        ASSERT_TRUE(ring.try_pop(value));
+        ASSERT_EQ(i, value);
+    }
+
+    const int COUNT = 200000;
+    SpscRing<int> channel(64);
+    std::thread producer([&channel] {
+        for (int i = 0; i < COUNT; i++)
+        {
+            channel.push(i);
+        }
+        channel.close();
+    });
+    int expected = 0;
+    while (channel.pop(value))
+    {
+        ASSERT_EQ(expected, value);
+        expected++;
+    }
+    producer.join();
+    ASSERT_EQ(COUNT, expected);
+}
+
+/**
+ * @brief Runs a batch kernel through the pipeline driver over an in-memory stream.
+ *
+ * @param input The string used as the batch input stream.
+ * @param output A reference to a string where the produced output will be stored.
+ * @param kernel Batch kernel to run.
+ * @param mapped Whether the input is given as a mappable file instead of a stream.
+ * @param stats Receives the statistics of the run.
+ * @return The value returned by the pipeline driver.
+ */
+long runPipelineWithInput(const std::string &input, std::string &output, BatchKernel kernel, bool mapped,
+                          PipelineStats &stats)
+{
+    std::string copy = input;
+    FILE *in = mapped ? tmpfile() : fmemopen(&copy[0], copy.size(), "r");
+    if (mapped)
+    {
+        fwrite(input.c_str(), sizeof(char), input.length(), in);
+        rewind(in);
+    }
+    char *buffer = NULL;
+    size_t size = 0;
+    FILE *out = open_memstream(&buffer, &size);
+
+    long result = batch_pipeline(kernel, in, out, 3, &stats, 1000);
+
+    fclose(out);
+    output.assign(buffer, size);
+    free(buffer);
+    fclose(in);
+    return result;
+}
+
+/**
+ * @brief Tests that the pipeline prints the sequential batch output and accounts for every chunk and byte.
+ */
+TEST(PipelineTests, MatchesSequentialOutput)
+{
+    std::string receipts;
+    std::string exchange;
+    unsigned seed = 71;
+    for (int i = 0; i < 6000; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        receipts += std::to_string(seed % 100) + " " + std::to_string((seed >> 8) % 100000) +
+                    (i % 3 ? "\n" : " 21\n");
+        exchange += "USD " + std::to_string(20 + seed % 10) + ".25 " + std::to_string((seed >> 8) % 1000) + "\n";
+    }
+
+    const struct
+    {
+        const std::string &input;
+        long (*batch)(FILE *, FILE *);
+        BatchKernel kernel;
+    } cases[] = {
+        {receipts, u1_1_batch, u1_1_receipts},
+        {exchange, u1_3_batch, u1_3_conversions},
+    };
+    for (const auto &test : cases)
+    {
+        std::string expectedOutput;
+        ASSERT_EQ(6000, runBatchWithInput(test.input, expectedOutput, test.batch));
+        for (bool mapped : {true, false})
+        {
+            PipelineStats stats;
+            std::string actualOutput;
+            ASSERT_EQ(6000, runPipelineWithInput(test.input, actualOutput, test.kernel, mapped, stats));
+            ASSERT_EQ(expectedOutput, actualOutput);
+            ASSERT_EQ(3u, stats.workers);
+            ASSERT_GT(stats.reader.chunks, 3u * PIPELINE_CHUNKS_PER_WORKER);
+            ASSERT_EQ(stats.reader.chunks, stats.compute.chunks);
+            ASSERT_EQ(stats.reader.chunks, stats.writer.chunks);
+            ASSERT_EQ(test.input.size(), stats.reader.bytes);
+            ASSERT_EQ(expectedOutput.size(), stats.writer.bytes);
+        }
+    }
+}
+
+/**
+ * @brief Tests that the pipeline stops at a malformed record after printing the records before it.
+ */
+TEST(PipelineTests, StopsAtMalformedRecord)
+{
+    std::string input;
+    for (int i = 0; i < 3000; i++)
+    {
+        input += i == 1200 ? "7 x\n" : std::to_string(i) + " 100\n";
+    }
+
+    std::string expectedOutput;
+    ASSERT_EQ(-1, runBatchWithInput(input, expectedOutput, u1_1_batch));
+    for (bool mapped : {true, false})
+    {
+        PipelineStats stats;
+        std::string actualOutput;
+        ASSERT_EQ(-1, runPipelineWithInput(input, actualOutput, u1_1_receipts, mapped, stats));
+        ASSERT_EQ(expectedOutput, actualOutput);
+    }
+}
+
+// Tests for the io_uring batch mode
+/**
+ * @brief Where runUringWithInput() takes its streams from.
+ */
+enum UringStreams
+{
+    URING_FILES,  ///< Input and output are temporary files.
+    URING_PIPE,   ///< Input is a pipe fed by a thread, output a temporary file.
+    URING_MEMORY, ///< Input and output are memory streams without descriptors.
+};
+
+/**
+ * @brief Runs a batch kernel through the io_uring driver with small blocks.
+ *
+ * @param input The string used as the batch input stream.
+ * @param output A reference to a string where the produced output will be stored.
+ * @param kernel Batch kernel to run.
+ * @param streams Kind of streams to run on.
+ * @return The value returned by the io_uring driver.
+ */
+long runUringWithInput(const std::string &input, std::string &output, BatchKernel kernel, UringStreams streams)
+{
+    std::string copy = input;
+    FILE *in = NULL;
+    std::thread feeder;
+    if (streams == URING_FILES)
+    {
+        in = tmpfile();
+        fwrite(input.c_str(), sizeof(char), input.length(), in);
+        rewind(in);
+    }
+    else if (streams == URING_PIPE)
+    {
+        int fds[2];
+        if (pipe(fds) != 0)
+        {
+            return -2;
+        }
+        in = fdopen(fds[0], "r");
+        int writer = fds[1];
+        feeder = std::thread([&input, writer]() {
+            for (size_t done = 0; done < input.size();)
+            {
+                // Small writes make the reads come back short and at odd line positions.
+                ssize_t written = write(writer, input.data() + done, std::min<size_t>(input.size() - done, 777));
+                if (written <= 0)
+                {
+                    break;
+                }
+                done += (size_t)written;
+            }
+            close(writer);
+        });
+    }
+    else
+    {
+        in = fmemopen(&copy[0], copy.size(), "r");
+    }
+
+    char *buffer = NULL;
+    size_t size = 0;
+    FILE *out = streams == URING_MEMORY ? open_memstream(&buffer, &size) : tmpfile();
+
+    long result = batch_uring(kernel, in, out, 4, 4096);
+
+    if (feeder.joinable())
+    {
+        feeder.join();
+    }
+    if (streams == URING_MEMORY)
+    {
+        fclose(out);
+        output.assign(buffer, size);
+        free(buffer);
+    }
+    else
+    {
+        fflush(out);
+        long length = ftell(out);
+        output.assign(length > 0 ? (size_t)length : 0, '\0');
+        rewind(out);
+        output.resize(fread(&output[0], sizeof(char), output.size(), out));
+        fclose(out);
+    }
+    fclose(in);
+    return result;
+}
+
+/**
+ * @brief Tests that the io_uring driver prints the sequential batch output over files, pipes and memory streams.
+ */
+TEST(UringTests, MatchesSequentialOutput)
+{
+    std::string receipts;
+    std::string exchange;
+    unsigned seed = 29;
+    for (int i = 0; i < 5000; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        receipts += std::to_string(seed % 100) + " " + std::to_string((seed >> 8) % 100000) +
+                    (i % 4 ? "\n" : " 12\n");
+        exchange += "EUR " + std::to_string(24 + seed % 3) + ".5 " + std::to_string((seed >> 8) % 1000) + "\n";
+    }
+    // No newline after the last record.
+    receipts += "3 999";
+
+    const struct
+    {
+        const std::string &input;
+        long records;
+        long (*batch)(FILE *, FILE *);
+        BatchKernel kernel;
+    } cases[] = {
+        {receipts, 5001, u1_1_batch, u1_1_receipts},
+        {exchange, 5000, u1_3_batch, u1_3_conversions},
+    };
+    for (const auto &test : cases)
+    {
+        std::string expectedOutput;
+        ASSERT_EQ(test.records, runBatchWithInput(test.input, expectedOutput, test.batch));
+        ASSERT_GT(expectedOutput.size(), 16u * 4096);
+        for (UringStreams streams : {URING_FILES, URING_PIPE, URING_MEMORY})
+        {
+            std::string actualOutput;
+            ASSERT_EQ(test.records, runUringWithInput(test.input, actualOutput, test.kernel, streams));
+            ASSERT_EQ(expectedOutput, actualOutput);
+        }
+    }
+}
+
+/**
+ * @brief Tests that the io_uring driver stops at a malformed record after printing the records before it.
+ */
+TEST(UringTests, StopsAtMalformedRecord)
+{
+    std::string input;
+    for (int i = 0; i < 3000; i++)
+    {
+        input += i == 2100 ? "7 x\n" : std::to_string(i) + " 100\n";
+    }
+
+    std::string expectedOutput;
+    ASSERT_EQ(-1, runBatchWithInput(input, expectedOutput, u1_1_batch));
+    for (UringStreams streams : {URING_FILES, URING_PIPE, URING_MEMORY})
+    {
+        std::string actualOutput;
+        ASSERT_EQ(-1, runUringWithInput(input, actualOutput, u1_1_receipts, streams));
+        ASSERT_EQ(expectedOutput, actualOutput);
+    }
+}
+
 // ... Add more test cases as necessary ...
 
 /**
@@ -0,0 +1,153 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Implementation of the work-stealing thread pool.
+ * @details Each queue has its own mutex, so the owner and a thief contend only when they touch the
+ *          same queue at the same moment. A single condition variable puts workers to sleep when no
+ *          queue has work; the counter of queued tasks tells a woken worker whether scanning the
+ *          queues is worthwhile.
+ *
+ * @see thread_pool.h for the class declaration.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "thread_pool.h"
+
+namespace
+{
+/** Pool the current thread works for, or NULL outside of any pool. */
+thread_local const ThreadPool *current_pool = NULL;
+
+/** Index of the current worker within current_pool. */
+thread_local unsigned current_index = 0;
+} // namespace
+
+ThreadPool::ThreadPool(unsigned threads) : next_queue(0), queued(0), stopping(false)
+{
+    if (threads == 0)
+    {
+        threads = default_threads();
+    }
+    for (unsigned i = 0; i < threads; i++)
+    {
+        queues.push_back(std::unique_ptr<Queue>(new Queue));
+    }
+    for (unsigned i = 0; i < threads; i++)
+    {
+        workers.push_back(std::thread(&ThreadPool::run, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex);
+        stopping = true;
+    }
+    idle.notify_all();
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    unsigned index = current_pool == this ? current_index : next_queue++ % (unsigned)queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex);
+        queued++;
+    }
+    idle.notify_one();
+}
+
+unsigned ThreadPool::size() const
+{
+    return (unsigned)workers.size();
+}
+
+unsigned ThreadPool::default_threads()
+{
+    unsigned threads = std::thread::hardware_concurrency();
+    return threads > 0 ? threads : 1;
+}
+
+/**
+ * @brief Takes the newest task from the worker's own queue.
+ * @param index Index of the worker.
+ * @param task Receives the task.
+ * @return true if a task was taken.
+ */
+bool ThreadPool::pop(unsigned index, std::function<void()> &task)
+{
+    Queue &queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+/**
+ * @brief Takes the oldest task from the first other worker that has one.
+ * @param index Index of the stealing worker; the scan starts at its neighbour.
+ * @param task Receives the task.
+ * @return true if a task was stolen.
+ */
+bool ThreadPool::steal(unsigned index, std::function<void()> &task)
+{
+    unsigned count = (unsigned)queues.size();
+    for (unsigned offset = 1; offset < count; offset++)
+    {
+        Queue &queue = *queues[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Main loop of a worker thread.
+ * @param index Index of the worker.
+ */
+void ThreadPool::run(unsigned index)
+{
+    current_pool = this;
+    current_index = index;
+
+    std::function<void()> task;
+    for (;;)
+    {
+        if (pop(index, task) || steal(index, task))
+        {
+            {
+                std::lock_guard<std::mutex> lock(idle_mutex);
+                queued--;
+            }
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idle_mutex);
+        idle.wait(lock, [this] { return queued > 0 || stopping; });
+        if (stopping && queued <= 0)
+        {
+            return;
+        }
+    }
+}
+
+/** End of thread_pool.cpp */
\ No newline at end of file
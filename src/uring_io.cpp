@@ -0,0 +1,656 @@
+/**
+ * @file uring_io.cpp
+ * @brief Implementation of the io_uring wrapper and the io_uring batch driver.
+ * @details Input buffers 0 .. depth-1 and output buffers depth .. 2*depth-1 live in one aligned
+ *          allocation registered with the ring. Read number n always uses input buffer n modulo
+ *          depth, so blocks are consumed in file order whatever order they complete in. Lines that
+ *          straddle two blocks are assembled in a small carry buffer; everything else is parsed in
+ *          place in the registered buffer.
+ *
+ *          Writes go out at explicit offsets when the output is a regular file opened without
+ *          O_APPEND; otherwise only one write is in flight, which keeps pipes and appended files in
+ *          order. Short reads and writes are resubmitted for the remainder.
+ *
+ * @see uring_io.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "uring_io.h"
+#include <deque>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+/** Tag bit that marks the completion of a write. */
+const unsigned long long WRITE_TAG = 1ULL << 32;
+
+inline unsigned load_acquire(const unsigned *p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+inline void store_release(unsigned *p, unsigned value)
+{
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Runs the kernel on the plain stdio path.
+ */
+long run_plain(BatchKernel kernel, FILE *input, FILE *output)
+{
+    InputReader reader(input);
+    OutputBuffer out(output);
+    return kernel(reader, out);
+}
+
+/**
+ * @brief State of one input buffer.
+ */
+struct ReadBlock
+{
+    long long offset; ///< File offset of the block, or -1 for a stream.
+    size_t length;    ///< Bytes requested.
+    size_t filled;    ///< Bytes read so far.
+    bool ready;       ///< Complete and waiting to be consumed.
+};
+
+/**
+ * @brief State of one output buffer.
+ */
+struct WriteBlock
+{
+    long long offset; ///< File offset of the block, or -1 for a stream.
+    size_t length;    ///< Bytes in the buffer.
+    size_t done;      ///< Bytes written so far.
+};
+
+/**
+ * @brief Single-threaded driver state of batch_uring().
+ */
+class UringBatch
+{
+  public:
+    UringBatch(Uring &ring, char *memory, unsigned depth, size_t block_size, int input_fd, int output_fd)
+        : ring(ring), memory(memory), depth(depth), block_size(block_size), input_fd(input_fd),
+          output_fd(output_fd), reads(depth), writes(depth), input_seekable(false), input_end(false),
+          input_offset(0), input_size(0), next_issue(0), next_consume(0), reads_in_flight(0),
+          output_seekable(false), output_offset(-1), current(-1), current_filled(0), writes_in_flight(0),
+          failed(false)
+    {
+        for (unsigned i = 0; i < depth; i++)
+        {
+            free_outputs.push_back(depth + i);
+        }
+    }
+
+    /**
+     * @brief Decides how to address the input; regular files are read at explicit offsets.
+     * @param start Current position of the input stream, or -1 if it has none.
+     */
+    void set_input(long long start)
+    {
+        struct stat info;
+        if (start >= 0 && fstat(input_fd, &info) == 0 && S_ISREG(info.st_mode))
+        {
+            input_seekable = true;
+            input_offset = start;
+            input_size = info.st_size;
+        }
+    }
+
+    /**
+     * @brief Decides how to address the output; regular files without O_APPEND are written at offsets.
+     */
+    void set_output()
+    {
+        struct stat info;
+        int flags = fcntl(output_fd, F_GETFL);
+        off_t position = lseek(output_fd, 0, SEEK_CUR);
+        if (fstat(output_fd, &info) == 0 && S_ISREG(info.st_mode) && flags >= 0 && !(flags & O_APPEND) &&
+            position >= 0)
+        {
+            output_seekable = true;
+            output_offset = position;
+        }
+    }
+
+    /**
+     * @brief Tells whether either side is a stream addressed at offset -1.
+     */
+    bool uses_current_position() const
+    {
+        return !input_seekable || !output_seekable;
+    }
+
+    long run(BatchKernel kernel)
+    {
+        long records = 0;
+        bool malformed = false;
+        std::vector<char> carry;
+        OutputBuffer out;
+
+        auto process = [&](const char *text, size_t size) {
+            InputReader reader(text, size);
+            long processed = kernel(reader, out);
+            append(out.data(), out.size());
+            out.clear();
+            if (processed < 0)
+            {
+                malformed = true;
+            }
+            else
+            {
+                records += processed;
+            }
+        };
+
+        for (;;)
+        {
+            issue_reads();
+            while (!failed && !malformed && next_consume < next_issue && reads[next_consume % depth].ready)
+            {
+                ReadBlock &block = reads[next_consume % depth];
+                const char *data = memory + (next_consume % depth) * block_size;
+                size_t size = block.filled;
+                block.ready = false;
+
+                // Complete the line carried over from the previous block first.
+                if (!carry.empty() && size > 0)
+                {
+                    const char *newline = (const char *)memchr(data, '\n', size);
+                    size_t head = newline ? (size_t)(newline - data) + 1 : size;
+                    carry.insert(carry.end(), data, data + head);
+                    data += head;
+                    size -= head;
+                    if (newline)
+                    {
+                        process(&carry[0], carry.size());
+                        carry.clear();
+                    }
+                }
+                const char *last = size > 0 ? (const char *)memrchr(data, '\n', size) : NULL;
+                size_t whole = last ? (size_t)(last - data) + 1 : 0;
+                if (whole > 0 && !malformed)
+                {
+                    process(data, whole);
+                }
+                carry.insert(carry.end(), data + whole, data + size);
+
+                next_consume++;
+                issue_reads();
+            }
+            issue_writes();
+            if (failed || malformed || (next_consume == next_issue && !can_issue()))
+            {
+                break;
+            }
+            wait();
+        }
+        if (!failed && !malformed && !carry.empty())
+        {
+            process(&carry[0], carry.size());
+        }
+
+        // Flush the last output block and let every request finish before the buffers go away.
+        if (current >= 0 && current_filled > 0)
+        {
+            queue_current();
+        }
+        for (;;)
+        {
+            issue_writes();
+            if (reads_in_flight == 0 && writes_in_flight == 0 && (full_outputs.empty() || failed))
+            {
+                break;
+            }
+            wait();
+        }
+        if (output_seekable)
+        {
+            lseek(output_fd, output_offset, SEEK_SET);
+        }
+        return failed || malformed ? -1 : records;
+    }
+
+  private:
+    UringBatch(const UringBatch &);
+    UringBatch &operator=(const UringBatch &);
+
+    bool can_issue() const
+    {
+        if (failed || input_end || next_issue - next_consume >= depth)
+        {
+            return false;
+        }
+        return input_seekable ? input_offset < input_size : reads_in_flight == 0;
+    }
+
+    void issue_reads()
+    {
+        while (can_issue())
+        {
+            unsigned index = (unsigned)(next_issue % depth);
+            ReadBlock &block = reads[index];
+            block.filled = 0;
+            block.ready = false;
+            if (input_seekable)
+            {
+                long long left = input_size - input_offset;
+                block.offset = input_offset;
+                block.length = left < (long long)block_size ? (size_t)left : block_size;
+                input_offset += (long long)block.length;
+            }
+            else
+            {
+                block.offset = -1;
+                block.length = block_size;
+            }
+            submit_read(index);
+            next_issue++;
+        }
+    }
+
+    void submit_read(unsigned index)
+    {
+        ReadBlock &block = reads[index];
+        long long offset = block.offset < 0 ? -1 : block.offset + (long long)block.filled;
+        if (!ring.read_fixed(input_fd, memory + index * block_size + block.filled,
+                             (unsigned)(block.length - block.filled), offset, index, index))
+        {
+            failed = true;
+            return;
+        }
+        reads_in_flight++;
+    }
+
+    void submit_write(unsigned index)
+    {
+        WriteBlock &block = writes[index - depth];
+        long long offset = block.offset < 0 ? -1 : block.offset + (long long)block.done;
+        if (!ring.write_fixed(output_fd, memory + index * block_size + block.done,
+                              (unsigned)(block.length - block.done), offset, index, WRITE_TAG | index))
+        {
+            failed = true;
+            return;
+        }
+        writes_in_flight++;
+    }
+
+    void issue_writes()
+    {
+        while (!failed && !full_outputs.empty() && (output_seekable || writes_in_flight == 0))
+        {
+            unsigned index = full_outputs.front();
+            full_outputs.pop_front();
+            submit_write(index);
+        }
+    }
+
+    void queue_current()
+    {
+        WriteBlock &block = writes[current - depth];
+        block.length = current_filled;
+        block.done = 0;
+        block.offset = output_offset;
+        if (output_seekable)
+        {
+            output_offset += (long long)current_filled;
+        }
+        full_outputs.push_back((unsigned)current);
+        current = -1;
+        current_filled = 0;
+    }
+
+    /**
+     * @brief Copies kernel output into the output buffers, queueing every full one.
+     */
+    void append(const char *data, size_t size)
+    {
+        while (size > 0 && !failed)
+        {
+            if (current < 0)
+            {
+                while (free_outputs.empty() && !failed)
+                {
+                    issue_writes();
+                    wait();
+                }
+                if (failed)
+                {
+                    return;
+                }
+                current = (int)free_outputs.back();
+                free_outputs.pop_back();
+            }
+            size_t step = block_size - current_filled < size ? block_size - current_filled : size;
+            memcpy(memory + (size_t)current * block_size + current_filled, data, step);
+            current_filled += step;
+            data += step;
+            size -= step;
+            if (current_filled == block_size)
+            {
+                queue_current();
+            }
+        }
+    }
+
+    /**
+     * @brief Submits queued requests, waits for at least one completion and handles all that arrived.
+     */
+    void wait()
+    {
+        if (!ring.submit(1))
+        {
+            failed = true;
+            // Requests already in flight still complete; collect them without waiting.
+        }
+
+        unsigned long long tag = 0;
+        int result = 0;
+        while (ring.next_completion(tag, result))
+        {
+            unsigned index = (unsigned)(tag & 0xffffffffu);
+            if (tag & WRITE_TAG)
+            {
+                writes_in_flight--;
+                WriteBlock &block = writes[index - depth];
+                if (result <= 0)
+                {
+                    failed = true;
+                    free_outputs.push_back(index);
+                    continue;
+                }
+                block.done += (size_t)result;
+                if (block.done < block.length && !failed)
+                {
+                    submit_write(index);
+                }
+                else
+                {
+                    free_outputs.push_back(index);
+                }
+                continue;
+            }
+
+            reads_in_flight--;
+            ReadBlock &block = reads[index];
+            if (result < 0)
+            {
+                failed = true;
+                block.ready = true;
+                continue;
+            }
+            block.filled += (size_t)result;
+            if (result == 0)
+            {
+                // End of a stream, or a regular file that shrank while being read.
+                input_end = true;
+                block.ready = true;
+            }
+            else if (input_seekable && block.filled < block.length && !failed)
+            {
+                submit_read(index);
+            }
+            else
+            {
+                block.ready = true;
+            }
+        }
+        if (failed && reads_in_flight + writes_in_flight > 0 && !ring.submit(0))
+        {
+            // The ring itself is broken; nothing more will complete.
+            reads_in_flight = 0;
+            writes_in_flight = 0;
+        }
+    }
+
+    Uring &ring;
+    char *memory;
+    unsigned depth;
+    size_t block_size;
+    int input_fd;
+    int output_fd;
+
+    std::vector<ReadBlock> reads;
+    std::vector<WriteBlock> writes;
+    bool input_seekable;
+    bool input_end;
+    long long input_offset; ///< Offset of the next block to request.
+    long long input_size;
+    unsigned long long next_issue;   ///< Number of reads issued.
+    unsigned long long next_consume; ///< Number of blocks consumed.
+    unsigned reads_in_flight;
+
+    bool output_seekable;
+    long long output_offset; ///< Offset of the next block to queue.
+    int current;             ///< Output buffer being filled, or -1.
+    size_t current_filled;
+    std::vector<unsigned> free_outputs;
+    std::deque<unsigned> full_outputs;
+    unsigned writes_in_flight;
+
+    bool failed;
+};
+} // namespace
+
+Uring::Uring(unsigned depth)
+    : fd(-1), queued(0), features(0), ring(MAP_FAILED), ring_size(0), completion_ring(NULL), completion_ring_size(0),
+      entries((struct io_uring_sqe *)MAP_FAILED), entries_size(0)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    fd = (int)syscall(__NR_io_uring_setup, depth, &params);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    features = params.features;
+    size_t submission_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t completion_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool shared = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    ring_size = shared && completion_size > submission_size ? completion_size : submission_size;
+    ring = mmap(NULL, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    char *completion = (char *)ring;
+    if (ring != MAP_FAILED && !shared)
+    {
+        completion_ring_size = completion_size;
+        completion_ring =
+            mmap(NULL, completion_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        completion = (char *)completion_ring;
+    }
+    entries_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    entries = (struct io_uring_sqe *)mmap(NULL, entries_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                          IORING_OFF_SQES);
+    if (ring == MAP_FAILED || completion == MAP_FAILED || entries == MAP_FAILED)
+    {
+        if (completion_ring == MAP_FAILED)
+        {
+            completion_ring = NULL;
+        }
+        close(fd);
+        fd = -1;
+        return;
+    }
+
+    char *submission = (char *)ring;
+    sq_head = (unsigned *)(submission + params.sq_off.head);
+    sq_tail = (unsigned *)(submission + params.sq_off.tail);
+    sq_mask = *(unsigned *)(submission + params.sq_off.ring_mask);
+    sq_array = (unsigned *)(submission + params.sq_off.array);
+    cq_head = (unsigned *)(completion + params.cq_off.head);
+    cq_tail = (unsigned *)(completion + params.cq_off.tail);
+    cq_mask = *(unsigned *)(completion + params.cq_off.ring_mask);
+    cqes = (struct io_uring_cqe *)(completion + params.cq_off.cqes);
+}
+
+Uring::~Uring()
+{
+    if (entries != MAP_FAILED)
+    {
+        munmap(entries, entries_size);
+    }
+    if (completion_ring)
+    {
+        munmap(completion_ring, completion_ring_size);
+    }
+    if (ring != MAP_FAILED)
+    {
+        munmap(ring, ring_size);
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+}
+
+bool Uring::available() const
+{
+    return fd >= 0;
+}
+
+bool Uring::reads_at_current_position() const
+{
+    return (features & IORING_FEAT_RW_CUR_POS) != 0;
+}
+
+bool Uring::register_buffers(const struct iovec *buffers, unsigned count)
+{
+    return syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, buffers, count) == 0;
+}
+
+bool Uring::queue(unsigned char opcode, int fd, const char *buffer, unsigned length, long long offset, unsigned index,
+                  unsigned long long tag)
+{
+    unsigned tail = *sq_tail;
+    if (tail - load_acquire(sq_head) > sq_mask)
+    {
+        return false;
+    }
+    unsigned slot = tail & sq_mask;
+    struct io_uring_sqe *entry = &entries[slot];
+    memset(entry, 0, sizeof(*entry));
+    entry->opcode = opcode;
+    entry->fd = fd;
+    entry->addr = (unsigned long long)(uintptr_t)buffer;
+    entry->len = length;
+    entry->off = (unsigned long long)offset;
+    entry->buf_index = (unsigned short)index;
+    entry->user_data = tag;
+    sq_array[slot] = slot;
+    store_release(sq_tail, tail + 1);
+    queued++;
+    return true;
+}
+
+bool Uring::read_fixed(int fd, char *buffer, unsigned length, long long offset, unsigned index, unsigned long long tag)
+{
+    return queue(IORING_OP_READ_FIXED, fd, buffer, length, offset, index, tag);
+}
+
+bool Uring::write_fixed(int fd, const char *buffer, unsigned length, long long offset, unsigned index,
+                        unsigned long long tag)
+{
+    return queue(IORING_OP_WRITE_FIXED, fd, buffer, length, offset, index, tag);
+}
+
+bool Uring::submit(unsigned wait)
+{
+    for (;;)
+    {
+        long submitted =
+            syscall(__NR_io_uring_enter, fd, queued, wait, wait > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+        if (submitted >= 0)
+        {
+            queued -= (unsigned)submitted;
+            return true;
+        }
+        if (errno != EINTR)
+        {
+            return false;
+        }
+    }
+}
+
+bool Uring::next_completion(unsigned long long &tag, int &result)
+{
+    unsigned head = *cq_head;
+    if (head == load_acquire(cq_tail))
+    {
+        return false;
+    }
+    const struct io_uring_cqe &completion = cqes[head & cq_mask];
+    tag = completion.user_data;
+    result = completion.res;
+    store_release(cq_head, head + 1);
+    return true;
+}
+
+bool uring_supported()
+{
+    static const bool supported = Uring(1).available();
+    return supported;
+}
+
+long batch_uring(BatchKernel kernel, FILE *input, FILE *output, unsigned depth, size_t block_size)
+{
+    int input_fd = fileno(input);
+    int output_fd = fileno(output);
+    if (depth == 0 || block_size == 0 || block_size > (1u << 30) || input_fd < 0 || output_fd < 0 ||
+        !uring_supported())
+    {
+        return run_plain(kernel, input, output);
+    }
+
+    Uring ring(2 * depth);
+    void *allocation = NULL;
+    size_t buffers = 2 * (size_t)depth;
+    if (!ring.available() || posix_memalign(&allocation, 4096, buffers * block_size) != 0)
+    {
+        return run_plain(kernel, input, output);
+    }
+    char *memory = (char *)allocation;
+    std::vector<struct iovec> iovecs(buffers);
+    for (size_t i = 0; i < buffers; i++)
+    {
+        iovecs[i].iov_base = memory + i * block_size;
+        iovecs[i].iov_len = block_size;
+    }
+    if (!ring.register_buffers(&iovecs[0], (unsigned)buffers))
+    {
+        free(memory);
+        return run_plain(kernel, input, output);
+    }
+
+    // Anything already buffered by stdio must reach the descriptor before the first write.
+    fflush(output);
+    long records = 0;
+    bool plain = false;
+    {
+        UringBatch batch(ring, memory, depth, block_size, input_fd, output_fd);
+        batch.set_input(ftello(input));
+        batch.set_output();
+        // Kernels before 5.6 set up a ring but reject offset -1, so streams stay on stdio there.
+        plain = batch.uses_current_position() && !ring.reads_at_current_position();
+        if (!plain)
+        {
+            records = batch.run(kernel);
+        }
+    }
+    free(memory);
+    return plain ? run_plain(kernel, input, output) : records;
+}
+
+/** End of uring_io.cpp */
\ No newline at end of file
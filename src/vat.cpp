@@ -0,0 +1,360 @@
+/**
+ * @file vat.cpp
+ * @brief Implementation of the integer fixed-point VAT pricing kernels.
+ * @details For a rate of B basis points the coefficient `(10000 + B) / 10000` is reduced to the
+ *          fraction N/D and split into a whole part and a remainder, `N/D = WHOLE + R/D`. For a price
+ *          magnitude `a` the gross price is then
+ *
+ *              WHOLE * a + (2 * R * a + bias) / (2 * D)
+ *
+ *          where `bias = D` rounds half up (non-negative prices) and `bias = 0` truncates (negative
+ *          prices, matching the old double formula). The sign of the price is applied afterwards.
+ *
+ *          All of these constants are derived at compile time by the VatKernel template, so each
+ *          rate class gets its own kernel with the divisions folded into multiplications. The AVX2
+ *          paths replace the division by `2 * D` with a multiplication by a 32-bit magic number and
+ *          a shift, which is exact for every dividend below 2^31.
+ *
+ * @see vat.h for the declarations.
+ *
+ * @date October 17, 2026 (Creation)
+ */
+
+#include "vat.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ZSP_VAT_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+constexpr long long gcd(long long a, long long b)
+{
+    return b == 0 ? a : gcd(b, a % b);
+}
+
+constexpr int ceil_log2(unsigned long long value, int bits = 0)
+{
+    return (1ULL << bits) >= value ? bits : ceil_log2(value, bits + 1);
+}
+
+constexpr long long min_ll(long long a, long long b)
+{
+    return a < b ? a : b;
+}
+
+/**
+ * @brief Pricing kernel specialised for one VAT rate.
+ * @tparam BasisPoints The VAT rate in basis points (2000 = 20 %).
+ */
+template <int BasisPoints>
+struct VatKernel
+{
+    static constexpr long long SCALE = 10000;
+    static constexpr long long NUM = (SCALE + BasisPoints) / gcd(SCALE + BasisPoints, SCALE);
+    static constexpr long long DEN = SCALE / gcd(SCALE + BasisPoints, SCALE);
+    static constexpr long long WHOLE = NUM / DEN;
+    static constexpr long long REM2 = 2 * (NUM % DEN);
+    static constexpr long long DEN2 = 2 * DEN;
+
+    // Division by DEN2 as (n * MAGIC) >> SHIFT, exact for n < 2^31.
+    static constexpr int SHIFT = 31 + ceil_log2(DEN2);
+    static constexpr unsigned long long MAGIC = (1ULL << SHIFT) / DEN2 + 1;
+
+    // Largest price magnitude whose gross price fits into an int.
+    static constexpr long long MAX_PRICE = 0x7FFFFFFFLL * DEN / NUM;
+
+    // Largest price magnitude for which 'REM2 * a + DEN' stays below 2^31.
+    static constexpr long long VECTOR_LIMIT =
+        REM2 == 0 ? MAX_PRICE : min_ll((0x7FFFFFFFLL - DEN) / REM2, MAX_PRICE);
+
+    static_assert(MAGIC < (1ULL << 32), "magic number must fit into a 32-bit lane");
+
+    static int gross(int price)
+    {
+        long long magnitude = price < 0 ? -(long long)price : price;
+        long long bias = price < 0 ? 0 : DEN;
+        long long result = WHOLE * magnitude + (REM2 * magnitude + bias) / DEN2;
+        return (int)(price < 0 ? -result : result);
+    }
+
+    static void gross_scalar(const int *prices, int *gross_prices, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            gross_prices[i] = gross(prices[i]);
+        }
+    }
+
+#ifdef ZSP_VAT_AVX2
+    __attribute__((target("avx2"))) static void gross_avx2(const int *prices, int *gross_prices, size_t count)
+    {
+        const __m256i whole = _mm256_set1_epi32((int)WHOLE);
+        const __m256i rem2 = _mm256_set1_epi32((int)REM2);
+        const __m256i den = _mm256_set1_epi32((int)DEN);
+        const __m256i magic = _mm256_set1_epi64x((long long)MAGIC);
+        const __m256i limit = _mm256_set1_epi32((int)VECTOR_LIMIT);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i price = _mm256_loadu_si256((const __m256i *)(prices + i));
+            __m256i magnitude = _mm256_abs_epi32(price);
+
+            // Unsigned range check; abs(INT_MIN) stays 0x80000000 and is caught here as well.
+            __m256i in_range = _mm256_cmpeq_epi32(_mm256_max_epu32(magnitude, limit), limit);
+            if (_mm256_movemask_epi8(in_range) != -1)
+            {
+                gross_scalar(prices + i, gross_prices + i, 8);
+                continue;
+            }
+
+            __m256i bias = _mm256_andnot_si256(_mm256_srai_epi32(price, 31), den);
+            __m256i dividend = _mm256_add_epi32(_mm256_mullo_epi32(magnitude, rem2), bias);
+
+            __m256i q_even = _mm256_srli_epi64(_mm256_mul_epu32(dividend, magic), SHIFT);
+            __m256i q_odd = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(dividend, 32), magic), SHIFT);
+            __m256i quotient = _mm256_blend_epi32(q_even, _mm256_slli_epi64(q_odd, 32), 0xAA);
+
+            __m256i result = _mm256_add_epi32(_mm256_mullo_epi32(magnitude, whole), quotient);
+            _mm256_storeu_si256((__m256i *)(gross_prices + i), _mm256_sign_epi32(result, price));
+        }
+
+        gross_scalar(prices + i, gross_prices + i, count - i);
+    }
+#else
+    static void gross_avx2(const int *prices, int *gross_prices, size_t count)
+    {
+        gross_scalar(prices, gross_prices, count);
+    }
+#endif
+};
+
+typedef void (*VatArrayKernel)(const int *, int *, size_t);
+
+/**
+ * @brief One row of the rate table: the constants and kernels of a rate class.
+ */
+struct VatRateEntry
+{
+    int basis_points;
+    int percent;
+    int max_price;
+    int whole;
+    int rem2;
+    int den;
+    unsigned magic;
+    int shift;
+    int vector_limit;
+    VatArrayKernel scalar;
+    VatArrayKernel avx2;
+};
+
+template <int BasisPoints>
+constexpr VatRateEntry rate_entry()
+{
+    typedef VatKernel<BasisPoints> Kernel;
+    return {BasisPoints,
+            BasisPoints / 100,
+            (int)Kernel::MAX_PRICE,
+            (int)Kernel::WHOLE,
+            (int)Kernel::REM2,
+            (int)Kernel::DEN,
+            (unsigned)Kernel::MAGIC,
+            Kernel::SHIFT,
+            (int)Kernel::VECTOR_LIMIT,
+            &Kernel::gross_scalar,
+            &Kernel::gross_avx2};
+}
+
+// Indexed by VatRate; keep in the same order as the enumeration.
+const VatRateEntry VAT_RATES[VAT_RATE_COUNT] = {rate_entry<2000>(), rate_entry<2100>(), rate_entry<1200>(),
+                                                rate_entry<0>()};
+
+static_assert(VAT_BASIS_POINTS == 2000, "VAT_RATE_20 is the rate of u1_1");
+static_assert(VatKernel<VAT_BASIS_POINTS>::MAX_PRICE == VAT_MAX_PRICE, "VAT_MAX_PRICE must match the kernel");
+
+/**
+ * @brief Prices one item with the kernel specialised for its class.
+ */
+inline int gross_for_class(int price, unsigned rate)
+{
+    switch (rate)
+    {
+    case VAT_RATE_21:
+        return VatKernel<2100>::gross(price);
+    case VAT_RATE_12:
+        return VatKernel<1200>::gross(price);
+    case VAT_RATE_0:
+        return VatKernel<0>::gross(price);
+    default:
+        return VatKernel<2000>::gross(price);
+    }
+}
+} // namespace
+
+int vat_rate_percent(VatRate rate)
+{
+    return VAT_RATES[rate].percent;
+}
+
+int vat_rate_max_price(VatRate rate)
+{
+    return VAT_RATES[rate].max_price;
+}
+
+bool vat_rate_from_percent(int percent, VatRate &rate)
+{
+    for (int i = 0; i < VAT_RATE_COUNT; i++)
+    {
+        if (VAT_RATES[i].percent == percent)
+        {
+            rate = (VatRate)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+int vat_gross_price(int price)
+{
+    return VatKernel<VAT_BASIS_POINTS>::gross(price);
+}
+
+int vat_gross_price(int price, VatRate rate)
+{
+    return gross_for_class(price, rate);
+}
+
+void vat_gross_prices_scalar(const int *prices, int *gross, size_t count)
+{
+    VatKernel<VAT_BASIS_POINTS>::gross_scalar(prices, gross, count);
+}
+
+void vat_gross_prices_avx2(const int *prices, int *gross, size_t count)
+{
+    VatKernel<VAT_BASIS_POINTS>::gross_avx2(prices, gross, count);
+}
+
+void vat_gross_prices_mixed_scalar(const int *prices, const unsigned char *rates, int *gross, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        gross[i] = gross_for_class(prices[i], rates[i]);
+    }
+}
+
+#ifdef ZSP_VAT_AVX2
+__attribute__((target("avx2"))) void vat_gross_prices_mixed_avx2(const int *prices, const unsigned char *rates,
+                                                                  int *gross, size_t count)
+{
+    // One register per constant, lane r holding the value for rate class r.
+    int whole_table[8] = {0}, rem2_table[8] = {0}, den_table[8] = {0}, magic_table[8] = {0};
+    int shift_table[8] = {0}, limit_table[8] = {0};
+    for (int r = 0; r < VAT_RATE_COUNT; r++)
+    {
+        whole_table[r] = VAT_RATES[r].whole;
+        rem2_table[r] = VAT_RATES[r].rem2;
+        den_table[r] = VAT_RATES[r].den;
+        magic_table[r] = (int)VAT_RATES[r].magic;
+        shift_table[r] = VAT_RATES[r].shift;
+        limit_table[r] = VAT_RATES[r].vector_limit;
+    }
+    const __m256i whole_lut = _mm256_loadu_si256((const __m256i *)whole_table);
+    const __m256i rem2_lut = _mm256_loadu_si256((const __m256i *)rem2_table);
+    const __m256i den_lut = _mm256_loadu_si256((const __m256i *)den_table);
+    const __m256i magic_lut = _mm256_loadu_si256((const __m256i *)magic_table);
+    const __m256i shift_lut = _mm256_loadu_si256((const __m256i *)shift_table);
+    const __m256i limit_lut = _mm256_loadu_si256((const __m256i *)limit_table);
+    const __m256i low_half = _mm256_set1_epi64x(0xFFFFFFFFLL);
+    const __m256i last_class = _mm256_set1_epi32(VAT_RATE_COUNT - 1);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i rate = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(rates + i)));
+        __m256i price = _mm256_loadu_si256((const __m256i *)(prices + i));
+        __m256i magnitude = _mm256_abs_epi32(price);
+
+        __m256i limit = _mm256_permutevar8x32_epi32(limit_lut, rate);
+        __m256i in_range = _mm256_cmpeq_epi32(_mm256_max_epu32(magnitude, limit), limit);
+        // The permutation only sees the low three bits, so unknown classes go to the scalar default.
+        in_range = _mm256_andnot_si256(_mm256_cmpgt_epi32(rate, last_class), in_range);
+        if (_mm256_movemask_epi8(in_range) != -1)
+        {
+            vat_gross_prices_mixed_scalar(prices + i, rates + i, gross + i, 8);
+            continue;
+        }
+
+        __m256i whole = _mm256_permutevar8x32_epi32(whole_lut, rate);
+        __m256i rem2 = _mm256_permutevar8x32_epi32(rem2_lut, rate);
+        __m256i den = _mm256_permutevar8x32_epi32(den_lut, rate);
+        __m256i magic = _mm256_permutevar8x32_epi32(magic_lut, rate);
+        __m256i shift = _mm256_permutevar8x32_epi32(shift_lut, rate);
+
+        __m256i bias = _mm256_andnot_si256(_mm256_srai_epi32(price, 31), den);
+        __m256i dividend = _mm256_add_epi32(_mm256_mullo_epi32(magnitude, rem2), bias);
+
+        __m256i q_even =
+            _mm256_srlv_epi64(_mm256_mul_epu32(dividend, magic), _mm256_and_si256(shift, low_half));
+        __m256i q_odd = _mm256_srlv_epi64(
+            _mm256_mul_epu32(_mm256_srli_epi64(dividend, 32), _mm256_srli_epi64(magic, 32)),
+            _mm256_srli_epi64(shift, 32));
+        __m256i quotient = _mm256_blend_epi32(q_even, _mm256_slli_epi64(q_odd, 32), 0xAA);
+
+        __m256i result = _mm256_add_epi32(_mm256_mullo_epi32(magnitude, whole), quotient);
+        _mm256_storeu_si256((__m256i *)(gross + i), _mm256_sign_epi32(result, price));
+    }
+
+    vat_gross_prices_mixed_scalar(prices + i, rates + i, gross + i, count - i);
+}
+
+bool vat_avx2_available()
+{
+    return __builtin_cpu_supports("avx2");
+}
+#else
+void vat_gross_prices_mixed_avx2(const int *prices, const unsigned char *rates, int *gross, size_t count)
+{
+    vat_gross_prices_mixed_scalar(prices, rates, gross, count);
+}
+
+bool vat_avx2_available()
+{
+    return false;
+}
+#endif
+
+void vat_gross_prices(const int *prices, int *gross, size_t count)
+{
+    vat_gross_prices(prices, VAT_RATE_20, gross, count);
+}
+
+void vat_gross_prices(const int *prices, VatRate rate, int *gross, size_t count)
+{
+    static const bool use_avx2 = vat_avx2_available();
+    if (use_avx2)
+    {
+        VAT_RATES[rate].avx2(prices, gross, count);
+    }
+    else
+    {
+        VAT_RATES[rate].scalar(prices, gross, count);
+    }
+}
+
+void vat_gross_prices_mixed(const int *prices, const unsigned char *rates, int *gross, size_t count)
+{
+    static const bool use_avx2 = vat_avx2_available();
+    if (use_avx2)
+    {
+        vat_gross_prices_mixed_avx2(prices, rates, gross, count);
+    }
+    else
+    {
+        vat_gross_prices_mixed_scalar(prices, rates, gross, count);
+    }
+}
+
+/** End of vat.cpp */
\ No newline at end of file